@@ -97,8 +97,12 @@ int main(int argc, char **argv)
     auto class_name = std::string(argv[2]);
     auto method_name = std::string(argv[3]);
 
-    // now the dex file...
-    auto dex_file = KUNAI::DEX::Dex::parse_dex_file(argv[1]);
+    // now the dex file... only the data of the
+    // requested class is parsed when it is found
+    KUNAI::DEX::parser_options_t parser_options;
+    parser_options.lazy_classes = true;
+
+    auto dex_file = KUNAI::DEX::Dex::parse_dex_file(argv[1], parser_options);
 
     if (!dex_file->get_parsing_correct())
     {
@@ -114,30 +118,24 @@ int main(int argc, char **argv)
     if (use_recursive)
         dex_disassembler->set_disassembly_algorithm(KUNAI::DEX::DexDisassembler::disassembly_algorithm::RECURSIVE_TRAVERSAL_ALGORITHM);
 
-    if (show_blocks || show_plot)
-    {
-        auto analysis = dex_file->get_analysis(false);
-
-        const auto &methods = analysis->get_methods();
-
-        for (const auto &method : methods)
-        {
-            if (method.second->external())
-                continue;
+    auto class_def = dex_file->get_parser()->get_classes().get_classdef_by_name(class_name);
 
-            auto encoded_method = std::get<KUNAI::DEX::EncodedMethod *>(method.second->get_encoded_method());
-            auto cls_ = reinterpret_cast<KUNAI::DEX::DVMClass *>(encoded_method->getMethodID()->get_class());
+    if (class_def == nullptr)
+        return 0;
 
-            if (cls_ == nullptr)
-                continue;
+    /// only the requested method is disassembled
+    for (auto encoded_method : class_def->get_class_data_item().get_methods())
+    {
+        if (encoded_method->getMethodID()->get_name() != method_name)
+            continue;
 
-            if (cls_->get_name() != class_name ||
-                encoded_method->getMethodID()->get_name() != method_name)
-                continue;
+        if (show_blocks || show_plot)
+        {
+            KUNAI::DEX::MethodAnalysis method_analysis(encoded_method, dex_disassembler);
 
             if (show_blocks)
             {
-                const auto &blocks = method.second->get_basic_blocks();
+                const auto &blocks = method_analysis.get_basic_blocks();
 
                 std::cout << encoded_method->getMethodID()->pretty_method() << "\n";
 
@@ -172,48 +170,25 @@ int main(int argc, char **argv)
             else if (show_plot)
             {
                 std::string file_name = class_name + "." + method_name + ".dot";
-                method.second->dump_dot_file(file_name);
+                method_analysis.dump_dot_file(file_name);
             }
+
+            continue;
         }
-    }
-    else
-    {
-        /// we have to apply the disassembly ourselves since
-        /// the library only applies parsing
-        dex_disassembler->disassembly_dex();
 
-        if (!dex_disassembler->correct_disassembly())
+        const auto &instrs = dex_disassembler->disassemble_method(encoded_method);
+
+        if (!dex_disassembler->correct_disassembly(encoded_method))
         {
-            std::cerr << "Error in the disassembly of " << argv[1] << ", maybe some method was incorrect...\n";
+            std::cerr << "Error in the disassembly of " << argv[1] << ", maybe the method was incorrect...\n";
             return 3;
         }
 
-        const auto &dex_instructions = dex_disassembler->get_dex_instructions();
+        std::cout << encoded_method->getMethodID()->pretty_method() << "\n";
 
-        /// dex instructions contain the next pair:
-        ///     - encoded_method : instructions from method
-        /// we will check for each one if class name and method names
-        /// are correct
-        for (const auto &disassembly : dex_instructions)
+        for (const auto &instr : instrs)
         {
-            auto encoded_method = disassembly.first;
-            const auto &instrs = disassembly.second;
-
-            auto cls_ = reinterpret_cast<KUNAI::DEX::DVMClass *>(encoded_method->getMethodID()->get_class());
-
-            if (cls_ == nullptr)
-                continue;
-
-            if (cls_->get_name() != class_name ||
-                encoded_method->getMethodID()->get_name() != method_name)
-                continue;
-
-            std::cout << encoded_method->getMethodID()->pretty_method() << "\n";
-
-            for (const auto &instr : instrs)
-            {
-                show_instruction(instr.get());
-            }
+            show_instruction(instr.get());
         }
     }
 }
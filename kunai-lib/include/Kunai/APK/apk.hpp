@@ -0,0 +1,104 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file apk.hpp
+// @brief Managing of APK files, the DEX files of the APK (classes.dex,
+// classes2.dex...) are inflated from the ZIP directly into memory, and
+// parsed in parallel. All of them are added to one Analysis object.
+
+#ifndef KUNAI_APK_APK_HPP
+#define KUNAI_APK_APK_HPP
+
+#include "Kunai/DEX/dex.hpp"
+#include "Kunai/Utils/mapped_file.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace KUNAI
+{
+namespace APK
+{
+    /// @brief Abstraction of an APK file, it contains the DEX
+    /// files of the APK and an analysis with all of them.
+    class Apk
+    {
+        /// @brief path to the APK file
+        std::string path_to_apk_file;
+
+        /// @brief APK file in memory, the ZIP is read from here
+        std::unique_ptr<stream::MappedFile> mapped_file;
+
+        /// @brief options for the parsers of the DEX files
+        DEX::parser_options_t parser_options;
+
+        /// @brief DEX files from the APK by name of the entry
+        std::map<std::string, std::unique_ptr<DEX::Dex>> dex_files;
+
+        /// @brief analysis with all the DEX files
+        std::unique_ptr<DEX::Analysis> global_analysis;
+
+        /// @brief Read the central directory of the ZIP, inflate each
+        /// DEX file into memory and parse them, each DEX file in a
+        /// different task of a pool of threads
+        void analyze_apk_file();
+
+    public:
+        /// @brief Parse the DEX files from an APK
+        /// @param path_to_apk_file path to the APK file
+        /// @param options options for the parser of each DEX file
+        /// @return unique pointer with the Apk object
+        static std::unique_ptr<Apk> parse_apk_file(const std::string &path_to_apk_file,
+                                                   const DEX::parser_options_t &options = {});
+
+        /// @brief Constructor of the Apk object, the DEX files are
+        /// parsed in the constructor
+        /// @param path_to_apk_file path to the APK file
+        /// @param options options for the parser of each DEX file
+        /// @throw exceptions::ApkUnzipException if the APK cannot be read
+        Apk(const std::string &path_to_apk_file, const DEX::parser_options_t &options = {})
+            : path_to_apk_file(path_to_apk_file), parser_options(options)
+        {
+            analyze_apk_file();
+        }
+
+        /// @brief Get the path to the APK file
+        /// @return constant reference to the path
+        const std::string &get_path_to_apk_file() const
+        {
+            return path_to_apk_file;
+        }
+
+        /// @brief Get the DEX files of the APK
+        /// @return constant reference to the DEX files by name
+        const std::map<std::string, std::unique_ptr<DEX::Dex>> &get_dex_files() const
+        {
+            return dex_files;
+        }
+
+        /// @brief Get a DEX file by the name of its entry in the APK
+        /// @param dex_name name of the DEX file (e.g. classes2.dex)
+        /// @return pointer to the Dex object or nullptr
+        DEX::Dex *get_dex_by_name(const std::string &dex_name)
+        {
+            auto it = dex_files.find(dex_name);
+
+            if (it == dex_files.end())
+                return nullptr;
+            return it->second.get();
+        }
+
+        /// @brief Get the analysis object of all the DEX files of the
+        /// APK, the methods of each DEX file are disassembled on demand
+        /// by the disassembler of its own DEX file
+        /// @param create_xrefs create the xrefs of all the classes,
+        /// this can take a long time
+        /// @return pointer to Analysis object or nullptr in case of error
+        DEX::Analysis *get_analysis(bool create_xrefs);
+    };
+} // namespace APK
+} // namespace KUNAI
+
+#endif // KUNAI_APK_APK_HPP
@@ -13,6 +13,7 @@
 #include "Kunai/DEX/parser/parser.hpp"
 #include "Kunai/DEX/DVM/dvm_types.hpp"
 #include "Kunai/DEX/DVM/dalvik_opcodes.hpp"
+#include "Kunai/Exceptions/invalidinstruction_exception.hpp"
 
 #include <iostream>
 #include <span>
@@ -23,47 +24,6 @@ namespace KUNAI
 {
 namespace DEX
 {
-    /// @brief Type of dex instruction, this can be used to check
-    /// what kind of instruction is the current one, in order to avoid
-    /// using dynamic casting
-    enum class dexinsttype_t
-    {
-        DEX_INSTRUCTION00X,
-        DEX_INSTRUCTION10X,
-        DEX_INSTRUCTION12X,
-        DEX_INSTRUCTION11N,
-        DEX_INSTRUCTION11X,
-        DEX_INSTRUCTION10T,
-        DEX_INSTRUCTION20T,
-        DEX_INSTRUCTION20BC,
-        DEX_INSTRUCTION22X,
-        DEX_INSTRUCTION21T,
-        DEX_INSTRUCTION21S,
-        DEX_INSTRUCTION21H,
-        DEX_INSTRUCTION21C,
-        DEX_INSTRUCTION23X,
-        DEX_INSTRUCTION22B,
-        DEX_INSTRUCTION22T,
-        DEX_INSTRUCTION22S,
-        DEX_INSTRUCTION22C,
-        DEX_INSTRUCTION22CS,
-        DEX_INSTRUCTION30T,
-        DEX_INSTRUCTION32X,
-        DEX_INSTRUCTION31I,
-        DEX_INSTRUCTION31T,
-        DEX_INSTRUCTION31C,
-        DEX_INSTRUCTION35C,
-        DEX_INSTRUCTION3RC,
-        DEX_INSTRUCTION45CC,
-        DEX_INSTRUCTION4RCC,
-        DEX_INSTRUCTION51L,
-        DEX_PACKEDSWITCH,
-        DEX_SPARSESWITCH,
-        DEX_FILLARRAYDATA,
-        DEX_DALVIKINCORRECT,
-        DEX_NONE_OP = 99,
-    };
-
     /// @brief Base class for the Instructions of the Dalvik Bytecode
     class Instruction
     {
@@ -72,7 +32,7 @@ namespace DEX
 
     protected:
         /// @brief Opcodes of the instruction
-        std::span<std::uint8_t> op_codes;
+        std::span<const std::uint8_t> op_codes;
         /// @brief Length of the instruction
         std::uint32_t length;
         /// @brief op code from the instruction
@@ -86,14 +46,19 @@ namespace DEX
         /// @param bytecode
         /// @param index
         /// @param instruction_type
-        Instruction(std::vector<uint8_t> &bytecode, std::size_t index, dexinsttype_t instruction_type)
+        Instruction(std::span<const std::uint8_t> bytecode, std::size_t index, dexinsttype_t instruction_type)
             : instruction_type(instruction_type), length(0), op(0), op_codes({})
         {
         }
 
-        Instruction(std::vector<uint8_t> &bytecode, std::size_t index, dexinsttype_t instruction_type, std::uint32_t length)
+        Instruction(std::span<const std::uint8_t> bytecode, std::size_t index, dexinsttype_t instruction_type, std::uint32_t length)
             : instruction_type(instruction_type), length(length), op(0)
         {
+            /// the bytecode can point to the DEX file in memory
+            /// so never read out of its bounds
+            if (index + length > bytecode.size())
+                throw exceptions::InvalidInstructionException("Instruction: instruction out of bytecode bounds",
+                                                              static_cast<std::uint32_t>(bytecode.size() - index));
             /// op_codes we can read here for all the classes
             /// that derives from Instruction, we have that is
             /// the bytecode from the index to index+length
@@ -160,7 +125,7 @@ namespace DEX
 
         /// @brief Return the op codes in raw from the instruction
         /// @return constant reference with op codes in raw
-        virtual const std::span<std::uint8_t> &get_opcodes()
+        virtual const std::span<const std::uint8_t> &get_opcodes()
         {
             return op_codes;
         }
@@ -196,7 +161,7 @@ namespace DEX
         /// @brief Constructor of Instruction00x this instruction does nothing
         /// @param bytecode bytecode with the opcodes
         /// @param index
-        Instruction00x(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser) : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION00X)
+        Instruction00x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser) : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION00X)
         {
         }
     };
@@ -206,7 +171,7 @@ namespace DEX
     class Instruction10x : public Instruction
     {
     public:
-        Instruction10x(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction10x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Return a string with the representation of the instruction
         /// @return string with instruction
@@ -234,7 +199,7 @@ namespace DEX
         std::uint8_t vB;
 
     public:
-        Instruction12x(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction12x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the index of the destination register
         /// @return index of destination register
@@ -294,7 +259,7 @@ namespace DEX
         std::int8_t nB;
 
     public:
-        Instruction11n(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction11n(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         std::uint8_t get_destination() const
         {
@@ -344,7 +309,7 @@ namespace DEX
         std::uint8_t vAA;
 
     public:
-        Instruction11x(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction11x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get destination register index of the operation
         /// @return index of register
@@ -385,7 +350,7 @@ namespace DEX
         std::int8_t nAA;
 
     public:
-        Instruction10t(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction10t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get offset of the jump
         /// @return offset of jump instruction
@@ -426,7 +391,7 @@ namespace DEX
         std::int16_t nAAAA;
 
     public:
-        Instruction20t(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction20t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the offset where to jump with an unconditional jump
         /// @return offset of the jump
@@ -469,7 +434,7 @@ namespace DEX
         std::uint16_t nBBBB;
 
     public:
-        Instruction20bc(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction20bc(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the index of the type of error
         /// @return index of error
@@ -525,7 +490,7 @@ namespace DEX
         std::uint16_t vBBBB;
 
     public:
-        Instruction22x(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction22x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get index of the register of destination
         /// @return index of destination register
@@ -586,7 +551,7 @@ namespace DEX
         std::int16_t nBBBB;
 
     public:
-        Instruction21t(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction21t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the register used for the check in the jump
         /// @return register checked
@@ -647,7 +612,7 @@ namespace DEX
         std::int16_t nBBBB;
 
     public:
-        Instruction21s(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction21s(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the index of the destination register
         /// @return index of destination register
@@ -707,7 +672,7 @@ namespace DEX
         std::int64_t nBBBB;
 
     public:
-        Instruction21h(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction21h(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the index of the destination register
         /// @return index of destination register
@@ -781,14 +746,12 @@ namespace DEX
         std::uint8_t vAA;
         /// @brief source id, this can be a string, type, etc (16 bits)
         std::uint16_t iBBBB;
-        /// @brief Source representation of the source
-        std::string source_str;
 
         /// @brief pointer to DEX parser to access some of the information
         Parser *parser;
 
     public:
-        Instruction21c(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser);
+        Instruction21c(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser);
 
         /// @brief Get the index of the register for destination
         /// @return index of register
@@ -819,12 +782,10 @@ namespace DEX
             return TYPES::Operand::KIND;
         }
 
-        /// @brief Print a string version of the source
-        /// @return constant reference to string of source
-        const std::string &pretty_print_source() const
-        {
-            return source_str;
-        }
+        /// @brief Print a string version of the source, the string
+        /// is created in each call
+        /// @return string of source
+        std::string pretty_print_source() const;
 
         /// @brief Check if source is a string
         /// @return true in case source is a string
@@ -833,12 +794,12 @@ namespace DEX
             return is_str;
         }
 
-        /// @brief get reference of the string this should be
+        /// @brief get the string between quotes, this should be
         /// called only if is_str == true
-        /// @return string reference
-        std::string &get_source_str()
+        /// @return string of source
+        std::string get_source_str() const
         {
-            return source_str;
+            return pretty_print_source();
         }
 
         /// @brief Check if source is a DVMType and return a pointer
@@ -913,7 +874,7 @@ namespace DEX
         {
             return DalvikOpcodes::get_instruction_name(op) + " v" +
                     std::to_string(vAA) + ", " +
-                    source_str + " (" + std::to_string(iBBBB) + ")";
+                    pretty_print_source() + " (" + std::to_string(iBBBB) + ")";
         }
 
         /// @brief Print the instruction on a given stream
@@ -922,7 +883,7 @@ namespace DEX
         {
             os << DalvikOpcodes::get_instruction_name(op) + " v" +
                         std::to_string(vAA) + ", " +
-                        source_str + " (" + std::to_string(iBBBB) + ")";
+                        pretty_print_source() + " (" + std::to_string(iBBBB) + ")";
         }
     };
 
@@ -938,7 +899,7 @@ namespace DEX
         std::uint8_t vCC;
 
     public:
-        Instruction23x(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction23x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the register for the destination
         /// @return destination register
@@ -1017,7 +978,7 @@ namespace DEX
         std::int8_t nCC;
 
     public:
-        Instruction22b(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction22b(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the index value of the destination register
         /// @return register index
@@ -1094,7 +1055,7 @@ namespace DEX
         std::int16_t nCCCC;
 
     public:
-        Instruction22t(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction22t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the first operand of the check
         /// @return index of register
@@ -1173,7 +1134,7 @@ namespace DEX
         std::int16_t nCCCC;
 
     public:
-        Instruction22s(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction22s(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the destination of the operation
         /// @return index of the destination register
@@ -1251,8 +1212,6 @@ namespace DEX
         std::uint8_t vB;
         /// @brief Type/FieldID to check
         std::uint16_t iCCCC;
-        /// @brief string representation of the type or field
-        std::string iCCCC_str;
         /// @brief parser for obtaining the values
         Parser *parser;
         /// @brief Check if current value is a type
@@ -1261,7 +1220,7 @@ namespace DEX
         bool is_field = false;
 
     public:
-        Instruction22c(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser);
+        Instruction22c(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser);
 
         /// @brief Get the destination operand for the instruction
         /// @return index of the register for the destination
@@ -1305,12 +1264,10 @@ namespace DEX
             return TYPES::Operand::KIND;
         }
 
-        /// @brief Get a pretty-printed version of the checked value
+        /// @brief Get a pretty-printed version of the checked value,
+        /// the string is created in each call
         /// @return string version of checked type/field
-        const std::string &get_checked_value_str() const
-        {
-            return iCCCC_str;
-        }
+        std::string get_checked_value_str() const;
 
         /// @brief Check if checked value is a DVMType and get a pointer
         /// @return pointer to DVMType or nullptr
@@ -1336,7 +1293,7 @@ namespace DEX
         {
             return DalvikOpcodes::get_instruction_name(op) + " v" +
                     std::to_string(vA) + ", v" + std::to_string(vB) + ", " +
-                    iCCCC_str + " (" + std::to_string(iCCCC) + ")";
+                    get_checked_value_str() + " (" + std::to_string(iCCCC) + ")";
         }
 
         /// @brief Print the instruction on a given stream
@@ -1345,7 +1302,7 @@ namespace DEX
         {
             os << DalvikOpcodes::get_instruction_name(op) + " v" +
                         std::to_string(vA) + ", v" + std::to_string(vB) + ", " +
-                        iCCCC_str + " (" + std::to_string(iCCCC) + ")";
+                        get_checked_value_str() + " (" + std::to_string(iCCCC) + ")";
         }
     };
 
@@ -1360,15 +1317,13 @@ namespace DEX
         std::uint8_t vB;
         /// @brief the field offset
         std::uint16_t iCCCC;
-        /// @brief field as string
-        std::string iCCCC_str;
         /// @brief is a field?
         bool is_field = false;
         /// @brief parser to obtain information
         Parser *parser;
 
     public:
-        Instruction22cs(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser);
+        Instruction22cs(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser);
 
         /// @brief Get the index of the first register used in the instruction
         /// @return value of register A
@@ -1412,12 +1367,10 @@ namespace DEX
             return TYPES::Operand::KIND;
         }
 
-        /// @brief Get a string representation of the Field
+        /// @brief Get a string representation of the Field, the
+        /// string is created in each call
         /// @return string representation of field
-        const std::string &get_field_string() const
-        {
-            return iCCCC_str;
-        }
+        std::string get_field_string() const;
 
         /// @brief Check if the idx is from a field and return a FieldID
         /// @return pointer to FieldID or nullptr
@@ -1434,7 +1387,7 @@ namespace DEX
         {
             return DalvikOpcodes::get_instruction_name(op) + " v" +
                     std::to_string(vA) + ", v" + std::to_string(vB) + ", " +
-                    iCCCC_str + " (" + std::to_string(iCCCC) + ")";
+                    get_field_string() + " (" + std::to_string(iCCCC) + ")";
         }
 
         /// @brief Print the instruction on a given stream
@@ -1443,7 +1396,7 @@ namespace DEX
         {
             os << DalvikOpcodes::get_instruction_name(op) + " v" +
                         std::to_string(vA) + ", v" + std::to_string(vB) + ", " +
-                        iCCCC_str + " (" + std::to_string(iCCCC) + ")";
+                        get_field_string() + " (" + std::to_string(iCCCC) + ")";
         }
     };
 
@@ -1455,7 +1408,7 @@ namespace DEX
         std::int32_t nAAAAAAAA;
 
     public:
-        Instruction30t(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction30t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the offset of the jump
         /// @return offset of unconditional jump
@@ -1495,7 +1448,7 @@ namespace DEX
         /// @brief Source register (16 bits)
         std::uint16_t vBBBB;
     public:
-        Instruction32x(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction32x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the destination operand of the instruction
         /// @return index of register destination
@@ -1552,7 +1505,7 @@ namespace DEX
         /// @brief source value (32 bits)
         std::uint32_t nBBBBBBBB;
     public:
-        Instruction31i(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction31i(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the destination operand of the instruction
         /// @return index of destination register
@@ -1632,7 +1585,7 @@ namespace DEX
         /// @brief pointer to SparseSwitch in case is this
         SparseSwitch * sparse_switch = nullptr;
     public:
-        Instruction31t(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction31t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief get the register used as reference for switch/array
         /// @return index of register for reference
@@ -1724,10 +1677,10 @@ namespace DEX
         std::uint8_t vAA;
         /// @brief String index from source (32 bits)
         std::uint32_t iBBBBBBBB;
-        /// @brief string value from the index
-        std::string str_value;
+        /// @brief parser to obtain the string
+        Parser * parser;
     public:
-        Instruction31c(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction31c(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         /// @brief Get the destination register for the string
         /// @return index of destination register
@@ -1757,11 +1710,12 @@ namespace DEX
             return TYPES::Operand::OFFSET;
         }
 
-        /// @brief Get the value from the string pointed in the instruction
+        /// @brief Get the value from the string pointed in the instruction,
+        /// the string is decoded by the parser the first time
         /// @return constant reference to string value
         const std::string& get_string_value() const
         {
-            return str_value;
+            return parser->get_strings().get_string_by_id(iBBBBBBBB);
         }
 
         /// @brief Return a string with the representation of the instruction
@@ -1769,7 +1723,7 @@ namespace DEX
         virtual std::string print_instruction()
         {
             return DalvikOpcodes::get_instruction_name(op) + " v" + 
-                    std::to_string(vAA) + ", \"" + str_value + "\" (" + std::to_string(iBBBBBBBB) + ")";
+                    std::to_string(vAA) + ", \"" + get_string_value() + "\" (" + std::to_string(iBBBBBBBB) + ")";
         }
 
         /// @brief Print the instruction on a given stream
@@ -1777,7 +1731,7 @@ namespace DEX
         virtual void print_instruction(std::ostream &os)
         {
             os << DalvikOpcodes::get_instruction_name(op) + " v" + 
-                    std::to_string(vAA) + ", " + str_value + " (" + std::to_string(iBBBBBBBB) + ")";
+                    std::to_string(vAA) + ", " + get_string_value() + " (" + std::to_string(iBBBBBBBB) + ")";
         }
     };
     
@@ -1795,14 +1749,12 @@ namespace DEX
         bool is_type = false;
         /// @brief is a method value?
         bool is_method = false;
-        /// @brief value in string format
-        std::string type_str;
         /// @brief vector with registers (4 bits each)
         std::vector<std::uint8_t> registers;
         /// @brief Parser for the types
         Parser * parser;
     public:
-        Instruction35c(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction35c(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
         
         /// @brief Get the number of registers from the instruction
         /// @return array_size value
@@ -1861,6 +1813,11 @@ namespace DEX
                 return parser->get_methods().get_method(type_index);
             return nullptr;
         }
+
+        /// @brief Get a string representation of the type or the method,
+        /// the string is created in each call
+        /// @return string representation of the operand
+        std::string get_operand_str() const;
         
         /// @brief Return a string with the representation of the instruction
         /// @return string with instruction
@@ -1876,7 +1833,7 @@ namespace DEX
             if (registers.size() > 0)
                 instruction = instruction.substr(0, instruction.size()-2);
             
-            instruction += "}, " + type_str;
+            instruction += "}, " + get_operand_str();
  
             return instruction;
         }
@@ -1905,15 +1862,13 @@ namespace DEX
         bool is_method = false;
         /// @brief is a type?
         bool is_type = false;
-        /// @brief string value of the type
-        std::string index_str;
         /// @brief registers, the registers start by
         /// one first argument register of 16 bits
         std::vector<std::uint16_t> registers;
         /// @brief Parser
         Parser * parser;
     public:
-        Instruction3rc(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction3rc(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         std::uint8_t get_registers_size() const
         {
@@ -1967,10 +1922,10 @@ namespace DEX
                 return index;
         }
 
-        const std::string& get_operand_str() const
-        {
-            return index_str;
-        }
+        /// @brief Get a string representation of the type or the method,
+        /// the string is created in each call
+        /// @return string representation of the operand
+        std::string get_operand_str() const;
 
         /// @brief Return a string with the representation of the instruction
         /// @return string with instruction
@@ -1986,7 +1941,7 @@ namespace DEX
             if (registers.size() > 0)
                 instruction = instruction.substr(0, instruction.size()-2);
             
-            instruction += "}, " + index_str;
+            instruction += "}, " + get_operand_str();
  
             return instruction;
         }
@@ -2020,7 +1975,7 @@ namespace DEX
         /// @brief possible prototype
         ProtoID * proto_id;
     public:
-        Instruction45cc(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction45cc(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         std::uint8_t get_number_of_registers() const
         {
@@ -2109,7 +2064,7 @@ namespace DEX
         /// @brief ProtoID pointer in case exists
         ProtoID * prototype_id;
     public:
-        Instruction4rcc(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction4rcc(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         std::uint8_t get_number_of_registers() const
         {
@@ -2189,7 +2144,7 @@ namespace DEX
         /// @brief wide value (64 bits)
         std::int64_t nBBBBBBBBBBBBBBBB;
     public:
-        Instruction51l(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        Instruction51l(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         std::uint8_t get_first_register() const
         {
@@ -2249,7 +2204,7 @@ namespace DEX
         /// @brief targets where the program can jump
         std::vector<std::int32_t> targets;
     public:
-        PackedSwitch(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        PackedSwitch(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         std::uint16_t get_number_of_targets() const
         {
@@ -2317,7 +2272,7 @@ namespace DEX
         /// @brief keys checked and targets
         std::vector<std::tuple<std::int32_t, std::int32_t>> keys_targets;
     public:
-        SparseSwitch(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        SparseSwitch(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
         
         std::uint16_t get_size_of_targets() const
         {
@@ -2404,7 +2359,7 @@ namespace DEX
         std::uint32_t size;
         std::vector<std::uint8_t> data;
     public:
-        FillArrayData(std::vector<uint8_t> &bytecode, std::size_t index, Parser * parser);
+        FillArrayData(std::span<const std::uint8_t> bytecode, std::size_t index, Parser * parser);
 
         std::uint16_t get_element_width() const
         {
@@ -2471,7 +2426,7 @@ namespace DEX
     class DalvikIncorrectInstruction : public Instruction
     {
     public:
-        DalvikIncorrectInstruction(std::vector<uint8_t> &bytecode, std::size_t index, std::uint32_t length)
+        DalvikIncorrectInstruction(std::span<const std::uint8_t> bytecode, std::size_t index, std::uint32_t length)
             : Instruction(bytecode, index, dexinsttype_t::DEX_DALVIKINCORRECT, length)
         {
         }
@@ -11,12 +11,150 @@
 
 #include "Kunai/DEX/parser/encoded.hpp"
 #include "Kunai/DEX/DVM/dvm_types.hpp"
+#include <array>
 #include <iostream>
+#include <string_view>
 
 namespace KUNAI
 {
 namespace DEX
 {
+    /// @brief Tables with the information of the opcodes, generated at
+    /// compile time from the definition files. The opcodes from 0x00 to
+    /// 0xff are accessed by index, the pseudo-opcodes of the payloads and
+    /// the jumbo opcodes are searched in the entries of the definitions.
+    namespace opcode_tables
+    {
+        /// @brief Entry from a definition file
+        /// @tparam T type of the value for the opcode
+        template <typename T>
+        struct opcode_entry_t
+        {
+            std::uint32_t opcode; //! opcode of the instruction
+            T value;              //! value given by the definition
+        };
+
+        /// @brief Search the value of an opcode in the entries of a definition
+        /// @param entries entries from a definition file
+        /// @param opcode opcode to search
+        /// @param default_value value for the opcodes without entry
+        /// @return value of the opcode
+        template <typename T, std::size_t N>
+        constexpr T find_entry(const opcode_entry_t<T> (&entries)[N], std::uint32_t opcode, T default_value)
+        {
+            for (const auto &entry : entries)
+                if (entry.opcode == opcode)
+                    return entry.value;
+            return default_value;
+        }
+
+        /// @brief Create a table indexed by opcode from the entries of a
+        /// definition, the opcodes over 0xff are not included
+        /// @param entries entries from a definition file
+        /// @param default_value value for the opcodes without entry
+        /// @return table with the value of each opcode
+        template <typename T, std::size_t N>
+        constexpr std::array<T, 256> make_table(const opcode_entry_t<T> (&entries)[N], T default_value)
+        {
+            std::array<T, 256> table{};
+
+            table.fill(default_value);
+
+            for (const auto &entry : entries)
+                if (entry.opcode < table.size())
+                    table[entry.opcode] = entry.value;
+
+            return table;
+        }
+
+        /// @brief Length in 16-bit code units of an instruction format,
+        /// the payloads have a variable length and they are not included
+        /// @param format format of the instruction
+        /// @return number of code units
+        constexpr std::uint8_t get_format_length(dexinsttype_t format)
+        {
+            switch (format)
+            {
+            case dexinsttype_t::DEX_INSTRUCTION20T:
+            case dexinsttype_t::DEX_INSTRUCTION20BC:
+            case dexinsttype_t::DEX_INSTRUCTION22X:
+            case dexinsttype_t::DEX_INSTRUCTION21T:
+            case dexinsttype_t::DEX_INSTRUCTION21S:
+            case dexinsttype_t::DEX_INSTRUCTION21H:
+            case dexinsttype_t::DEX_INSTRUCTION21C:
+            case dexinsttype_t::DEX_INSTRUCTION23X:
+            case dexinsttype_t::DEX_INSTRUCTION22B:
+            case dexinsttype_t::DEX_INSTRUCTION22T:
+            case dexinsttype_t::DEX_INSTRUCTION22S:
+            case dexinsttype_t::DEX_INSTRUCTION22C:
+            case dexinsttype_t::DEX_INSTRUCTION22CS:
+                return 2;
+            case dexinsttype_t::DEX_INSTRUCTION30T:
+            case dexinsttype_t::DEX_INSTRUCTION32X:
+            case dexinsttype_t::DEX_INSTRUCTION31I:
+            case dexinsttype_t::DEX_INSTRUCTION31T:
+            case dexinsttype_t::DEX_INSTRUCTION31C:
+            case dexinsttype_t::DEX_INSTRUCTION35C:
+            case dexinsttype_t::DEX_INSTRUCTION3RC:
+                return 3;
+            case dexinsttype_t::DEX_INSTRUCTION45CC:
+            case dexinsttype_t::DEX_INSTRUCTION4RCC:
+                return 4;
+            case dexinsttype_t::DEX_INSTRUCTION51L:
+                return 5;
+            default:
+                return 1;
+            }
+        }
+
+        inline constexpr opcode_entry_t<std::string_view> name_entries[] = {
+#define INST_NAME(OP, NAME) {OP, NAME},
+#include "Kunai/DEX/DVM/definitions/dvm_inst_names.def"
+        };
+
+        inline constexpr opcode_entry_t<TYPES::Kind> kind_entries[] = {
+#define INST_KIND(OP, VAL) {OP, VAL},
+#include "Kunai/DEX/DVM/definitions/dvm_inst_kind.def"
+        };
+
+        inline constexpr opcode_entry_t<TYPES::Operation> operation_entries[] = {
+#define INST_OP(OP, VAL) {OP, VAL},
+#include "Kunai/DEX/DVM/definitions/dvm_inst_operation.def"
+        };
+
+        inline constexpr opcode_entry_t<dexinsttype_t> format_entries[] = {
+#define INST_FORMAT(OP, VAL) {OP, VAL},
+#include "Kunai/DEX/DVM/definitions/dvm_inst_format.def"
+        };
+
+        /// @brief name of the opcodes without a definition
+        inline constexpr std::string_view none_name =
+            find_entry(name_entries, TYPES::opcodes::OP_NONE, std::string_view{});
+
+        /// @brief name of each opcode
+        inline constexpr auto names = make_table(name_entries, none_name);
+
+        /// @brief kind of each opcode
+        inline constexpr auto kinds = make_table(kind_entries, TYPES::Kind::NONE_KIND);
+
+        /// @brief operation of each opcode
+        inline constexpr auto operations = make_table(operation_entries, TYPES::Operation::NONE_OPCODE);
+
+        /// @brief format of each opcode
+        inline constexpr auto formats = make_table(format_entries, dexinsttype_t::DEX_DALVIKINCORRECT);
+
+        /// @brief length in 16-bit code units of each opcode
+        inline constexpr std::array<std::uint8_t, 256> lengths = []
+        {
+            std::array<std::uint8_t, 256> table{};
+
+            for (std::size_t I = 0; I < table.size(); ++I)
+                table[I] = get_format_length(formats[I]);
+
+            return table;
+        }();
+    } // namespace opcode_tables
+
     /// @brief Class with static functions to manage information
     /// about the dalvik opcodes
     class DalvikOpcodes
@@ -32,10 +170,25 @@ namespace DEX
         /// @param instruction opcode of the instruction
         /// @return reference to instruction name
         static const std::string& get_instruction_name(std::uint32_t instruction);
+        /// @brief Get the name of the instruction as a view of
+        /// the constant table of names
+        /// @param instruction opcode of the instruction
+        /// @return view of the instruction name
+        static constexpr std::string_view get_instruction_name_view(std::uint32_t instruction)
+        {
+            if (instruction < opcode_tables::names.size())
+                return opcode_tables::names[instruction];
+            return opcode_tables::find_entry(opcode_tables::name_entries, instruction, opcode_tables::none_name);
+        }
         /// @brief Find the instruction type given an instruction opcode
         /// @param instruction opcode of the instruction
         /// @return kind of a instruction
-        static TYPES::Kind get_instruction_type(std::uint32_t instruction);
+        static constexpr TYPES::Kind get_instruction_type(std::uint32_t instruction)
+        {
+            if (instruction < opcode_tables::kinds.size())
+                return opcode_tables::kinds[instruction];
+            return opcode_tables::find_entry(opcode_tables::kind_entries, instruction, TYPES::Kind::NONE_KIND);
+        }
         /// @brief Get an instruction type given an instruction opcode in string format
         /// @param instruction 
         /// @return constant reference to string with the Kind
@@ -43,7 +196,32 @@ namespace DEX
         /// @brief Find the instruction operation given an instruction opcode
         /// @param instruction opcode of the instruction
         /// @return operation of a instruction
-        static TYPES::Operation get_instruction_operation(std::uint32_t instruction);
+        static constexpr TYPES::Operation get_instruction_operation(std::uint32_t instruction)
+        {
+            if (instruction < opcode_tables::operations.size())
+                return opcode_tables::operations[instruction];
+            return opcode_tables::find_entry(opcode_tables::operation_entries, instruction, TYPES::Operation::NONE_OPCODE);
+        }
+        /// @brief Get the format of the instruction given its opcode
+        /// @param instruction opcode of the instruction
+        /// @return format of the instruction, the payloads and the
+        /// opcodes over 0xff return DEX_DALVIKINCORRECT
+        static constexpr dexinsttype_t get_instruction_format(std::uint32_t instruction)
+        {
+            if (instruction < opcode_tables::formats.size())
+                return opcode_tables::formats[instruction];
+            return dexinsttype_t::DEX_DALVIKINCORRECT;
+        }
+        /// @brief Get the length of the instruction given its opcode,
+        /// the length of the payloads depends on their data
+        /// @param instruction opcode of the instruction
+        /// @return length in 16-bit code units
+        static constexpr std::uint8_t get_instruction_length(std::uint32_t instruction)
+        {
+            if (instruction < opcode_tables::lengths.size())
+                return opcode_tables::lengths[instruction];
+            return 1;
+        }
         /// @brief Get a string representation of the access flags from a method
         /// @param method method to retrieve its access flags
         /// @return string representation of access flags
@@ -18,6 +18,9 @@
 #include "Kunai/DEX/DVM/linear_sweep_disassembler.hpp"
 #include "Kunai/DEX/DVM/recursive_traversal_disassembler.hpp"
 
+#include <mutex>
+#include <unordered_set>
+
 namespace KUNAI
 {
 namespace DEX
@@ -52,14 +55,53 @@ namespace DEX
         bool disassembly_correct = false;
 
         /// @brief An object containing all the instructions from the
-        /// dex file
+        /// dex file, it is also the cache of disassemble_method
         Disassembler::instructions_t dex_instructions;
 
+        /// @brief methods whose disassembly failed
+        std::unordered_set<EncodedMethod *> incorrect_methods;
+
+        /// @brief mutex for the methods disassembled on demand
+        mutable std::mutex cache_mutex;
+
+        /// @brief The instructions from the dex file in the
+        /// flat representation
+        Disassembler::flat_instructions_t flat_instructions;
+
         /// @brief Linear sweep disassembler
         LinearSweepDisassembler linear_sweep;
 
         /// @brief Recursive Traversal Disassembler
         RecursiveTraversalDisassembler recursive_traversal;
+
+        /// @brief Disassemblers for decoding methods with the ids of
+        /// a parser, the disassemblers keep state while decoding so
+        /// each concurrent decoding needs its own ones
+        struct method_decoder_t
+        {
+            Disassembler disassembler;
+            LinearSweepDisassembler linear_sweep;
+            RecursiveTraversalDisassembler recursive_traversal;
+
+            method_decoder_t(Parser * parser)
+            {
+                disassembler.set_parser(parser);
+                linear_sweep.set_internal_disassembler(&disassembler);
+                recursive_traversal.set_internal_disassembler(&disassembler);
+            }
+        };
+
+        /// @brief Decode one method with the current algorithm
+        /// @param method method to decode
+        /// @param linear_sweep linear sweep disassembler to use
+        /// @param recursive_traversal recursive traversal disassembler to use
+        /// @param instructions vector where to store the instructions, it is
+        /// empty if the disassembly fails
+        /// @return true if the disassembly was correct
+        bool decode_method(EncodedMethod * method,
+                           LinearSweepDisassembler& linear_sweep,
+                           RecursiveTraversalDisassembler& recursive_traversal,
+                           std::vector<std::unique_ptr<Instruction>>& instructions);
     public:
 
         /// @brief Constructor of the DexDisassembler, this should be called
@@ -82,6 +124,13 @@ namespace DEX
             this->algorithm = algorithm;
         }
 
+        /// @brief Get the disassembly algorithm used by the disassembler
+        /// @return algorithm in use
+        disassembly_algorithm get_disassembly_algorithm() const
+        {
+            return algorithm;
+        }
+
         /// @brief Get access to all the instructions from a dex
         /// @return constant reference to instructions
         const Disassembler::instructions_t& get_dex_instructions() const
@@ -96,6 +145,26 @@ namespace DEX
             return dex_instructions;
         }
 
+        /// @brief Get access to all the instructions from a dex in the
+        /// flat representation, filled by disassembly_flat_dex
+        /// @return constant reference to flat instructions
+        const Disassembler::flat_instructions_t& get_flat_instructions() const
+        {
+            return flat_instructions;
+        }
+
+        /// @brief Get the flat instructions of a method
+        /// @param method method to retrieve its instructions
+        /// @return pointer to the flat instructions or nullptr
+        const FlatInstructions* get_flat_instructions(EncodedMethod* method) const
+        {
+            auto it = flat_instructions.find(method);
+
+            if (it == flat_instructions.end())
+                return nullptr;
+            return &it->second;
+        }
+
         /// @brief Get if the disassembly process was correct or not
         /// @return boolean value that says if disassembly was correct
         bool correct_disassembly() const
@@ -103,25 +172,62 @@ namespace DEX
             return disassembly_correct;
         }
 
+        /// @brief Get if the disassembly of one method was correct or not
+        /// @param method method already disassembled
+        /// @return boolean value that says if disassembly was correct
+        bool correct_disassembly(EncodedMethod * method) const
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            return !incorrect_methods.contains(method);
+        }
+
         /// @brief Add the instructions from another disassembler to the
-        /// current one, this invalidate the previous one.
+        /// current one. The methods of the other disassembler are decoded
+        /// again with the ids of its parser and the algorithm of the current
+        /// disassembler, so the other disassembler is
+        /// not modified and the instructions it returned remain valid. The
+        /// methods already in the current disassembler are kept.
         /// @param other other dex disassembler
-        void add_disassembly(DexDisassembler& other);
+        void add_disassembly(const DexDisassembler& other);
+
+        /// @brief Disassembly one method and keep its instructions, the
+        /// next calls with the same method return the same instructions.
+        /// This is useful to look only at a few methods of a big DEX file.
+        /// The method is decoded out of the lock of the cache, so different
+        /// methods can be disassembled by different threads at the same time.
+        /// @param method method to disassembly
+        /// @return reference to the instructions of the method, empty if
+        /// the method has no code or its disassembly failed
+        std::vector<std::unique_ptr<Instruction>>& disassemble_method(EncodedMethod * method);
 
         /// @brief This is the most important function from the
         /// disassembler, this function takes the given parser
         /// object and calls one of the internal disassemblers
-        /// for retrieving all the instructions from the DEX file
+        /// for retrieving all the instructions from the DEX file.
+        /// The methods already disassembled are not disassembled again.
         void disassembly_dex();
 
+        /// @brief Same as disassembly_dex but the methods are disassembled
+        /// by a pool of threads, the largest methods first. Each thread uses
+        /// its own disassemblers, and the instructions of each method are
+        /// stored in its own slot, so the threads do not share any state.
+        /// @param number_of_threads threads to use, 0 to use the number of
+        /// hardware threads
+        void disassembly_dex_parallel(std::uint32_t number_of_threads = 0);
+
+        /// @brief Disassembly all the methods of the DEX file in the flat
+        /// representation, the instructions are decoded with a linear sweep
+        /// and the ids are not resolved
+        void disassembly_flat_dex();
+
         /// @brief Disassembly a buffer of bytes, take the buffer
         /// of bytes as dalvik instructions
         /// @param buffer buffer with possible bytecode for dalvik
         /// @return vector with disassembled instructions
         std::vector<std::unique_ptr<Instruction>>
-            disassembly_buffer(std::vector<std::uint8_t>& buffer);
+            disassembly_buffer(std::span<const std::uint8_t> buffer);
 
-        DexDisassembler& operator+=(DexDisassembler& other);
+        DexDisassembler& operator+=(const DexDisassembler& other);
     };
 } // namespace DEX
 } // namespace KUNAI
@@ -11,6 +11,7 @@
 #define KUNAI_DEX_DVM_DISASSEMBLER_HPP
 
 #include "Kunai/DEX/DVM/dalvik_instructions.hpp"
+#include "Kunai/DEX/DVM/flat_instructions.hpp"
 
 #include <memory>
 #include <iostream>
@@ -55,6 +56,11 @@ namespace DEX
                                 <EncodedMethod*,
                                 std::vector<std::unique_ptr<Instruction>>>;
 
+        /// @brief Instructions of the methods in the flat representation,
+        /// a compact alternative to instructions_t for linear scans
+        using flat_instructions_t = std::unordered_map
+                                <EncodedMethod*, FlatInstructions>;
+
     private:
         /// @brief pointer to the parser of the DEX file
         Parser * parser;
@@ -83,7 +89,7 @@ namespace DEX
         /// @return unique pointer to the disassembled Instruction
         std::unique_ptr<Instruction> disassemble_instruction(
             std::uint32_t opcode,
-            std::vector<uint8_t> & bytecode,
+            std::span<const std::uint8_t> bytecode,
             std::size_t index
         );
 
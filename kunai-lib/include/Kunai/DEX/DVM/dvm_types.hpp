@@ -201,6 +201,47 @@ namespace KUNAI
                     {'D', "double"}};
         } // namespace TYPES
 
+        /// @brief Type of dex instruction, this can be used to check
+        /// what kind of instruction is the current one, in order to avoid
+        /// using dynamic casting
+        enum class dexinsttype_t : std::uint8_t
+        {
+            DEX_INSTRUCTION00X,
+            DEX_INSTRUCTION10X,
+            DEX_INSTRUCTION12X,
+            DEX_INSTRUCTION11N,
+            DEX_INSTRUCTION11X,
+            DEX_INSTRUCTION10T,
+            DEX_INSTRUCTION20T,
+            DEX_INSTRUCTION20BC,
+            DEX_INSTRUCTION22X,
+            DEX_INSTRUCTION21T,
+            DEX_INSTRUCTION21S,
+            DEX_INSTRUCTION21H,
+            DEX_INSTRUCTION21C,
+            DEX_INSTRUCTION23X,
+            DEX_INSTRUCTION22B,
+            DEX_INSTRUCTION22T,
+            DEX_INSTRUCTION22S,
+            DEX_INSTRUCTION22C,
+            DEX_INSTRUCTION22CS,
+            DEX_INSTRUCTION30T,
+            DEX_INSTRUCTION32X,
+            DEX_INSTRUCTION31I,
+            DEX_INSTRUCTION31T,
+            DEX_INSTRUCTION31C,
+            DEX_INSTRUCTION35C,
+            DEX_INSTRUCTION3RC,
+            DEX_INSTRUCTION45CC,
+            DEX_INSTRUCTION4RCC,
+            DEX_INSTRUCTION51L,
+            DEX_PACKEDSWITCH,
+            DEX_SPARSESWITCH,
+            DEX_FILLARRAYDATA,
+            DEX_DALVIKINCORRECT,
+            DEX_NONE_OP = 99,
+        };
+
     } // namespace DEX
 
 } // namespace KUNAI
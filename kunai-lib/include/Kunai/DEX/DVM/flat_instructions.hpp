@@ -0,0 +1,162 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file flat_instructions.hpp
+// @brief Compact representation of the instructions of a method, each
+// instruction is a record of fixed size stored in a contiguous array,
+// the data of the payloads is kept in side tables. The ids are not
+// resolved, so the instructions do not need the parser to be decoded.
+
+#ifndef KUNAI_DEX_DVM_FLAT_INSTRUCTIONS_HPP
+#define KUNAI_DEX_DVM_FLAT_INSTRUCTIONS_HPP
+
+#include "Kunai/DEX/DVM/dalvik_opcodes.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace KUNAI
+{
+namespace DEX
+{
+    /// @brief Decoded instruction, the meaning of the operands
+    /// depends on the format of the instruction:
+    ///     * registers: registers in the order of the format (vA, vB, vC...),
+    ///       for the formats 3rc and 4rcc only the first register of the
+    ///       range is stored, and number_of_registers is the size of the range.
+    ///     * index: id of string, type, field or method, or the position
+    ///       of the data of a payload in the side tables.
+    ///     * second_index: id of the proto for 45cc and 4rcc, or the
+    ///       number of elements of a payload.
+    ///     * literal: literal value, offset of a branch in 16-bit code
+    ///       units, first key of a packed-switch or width of the elements
+    ///       of a fill-array-data.
+    struct flat_instruction_t
+    {
+        std::uint32_t address;              //! offset in bytes from the start of the method
+        std::uint32_t length;               //! length in bytes, payloads included
+        std::uint16_t opcode;               //! opcode, the payloads use their 16-bit identifier
+        dexinsttype_t format;               //! format of the instruction
+        std::uint8_t number_of_registers;   //! number of registers used
+        std::uint16_t registers[5];         //! registers of the instruction
+        std::uint32_t index;                //! id or position in the side tables
+        std::uint32_t second_index;         //! second id or number of elements
+        std::int64_t literal;               //! literal value or branch offset
+    };
+
+    /// @brief Instructions of a method in the flat representation
+    class FlatInstructions
+    {
+        /// @brief instructions sorted by address
+        std::vector<flat_instruction_t> instructions;
+
+        /// @brief keys of the packed-switch and sparse-switch payloads
+        std::vector<std::int32_t> switch_keys;
+
+        /// @brief targets of the packed-switch and sparse-switch payloads
+        std::vector<std::int32_t> switch_targets;
+
+        /// @brief data of the fill-array-data payloads
+        std::vector<std::uint8_t> array_data;
+
+        /// @brief Decode the instruction in the given index of the bytecode
+        /// @param bytecode bytecode of the method
+        /// @param index index of the instruction
+        /// @param instruction record where to store the instruction
+        /// @throw exceptions::InvalidInstructionException if the instruction
+        /// is not correct, the size of the exception is the number of bytes
+        /// to skip
+        void decode_instruction(std::span<const std::uint8_t> bytecode,
+                                std::size_t index,
+                                flat_instruction_t &instruction);
+
+        /// @brief Decode the instruction in the given index of the bytecode,
+        /// an incorrect instruction is stored as DEX_DALVIKINCORRECT
+        /// @param bytecode bytecode of the method
+        /// @param index index of the instruction
+        /// @param instruction record where to store the instruction
+        void decode_or_mark_incorrect(std::span<const std::uint8_t> bytecode,
+                                      std::size_t index,
+                                      flat_instruction_t &instruction);
+
+    public:
+        /// @brief Constructor of FlatInstructions, empty
+        FlatInstructions() = default;
+
+        /// @brief Decode the bytecode of a method with a linear sweep,
+        /// the previous instructions are removed. The bytes that do not
+        /// form a correct instruction are stored as DEX_DALVIKINCORRECT
+        /// @param bytecode bytecode of the method
+        void disassembly(std::span<const std::uint8_t> bytecode);
+
+        /// @brief Decode only the instructions in the given addresses of
+        /// the bytecode, e.g. the instructions reached by a recursive
+        /// traversal, the previous instructions are removed
+        /// @param bytecode bytecode of the method
+        /// @param addresses addresses in bytes of the instructions
+        void disassembly(std::span<const std::uint8_t> bytecode,
+                         std::span<const std::uint64_t> addresses);
+
+        /// @brief Remove all the instructions and the side tables
+        void clear();
+
+        /// @brief Get the instructions sorted by address
+        /// @return constant reference to the instructions
+        const std::vector<flat_instruction_t> &get_instructions() const
+        {
+            return instructions;
+        }
+
+        /// @brief Get the number of instructions
+        /// @return number of instructions
+        std::size_t size() const
+        {
+            return instructions.size();
+        }
+
+        /// @brief Get the instruction in a given address
+        /// @param address address in bytes of the instruction
+        /// @return pointer to the instruction or nullptr
+        const flat_instruction_t *get_instruction_by_address(std::uint64_t address) const;
+
+        /// @brief Get the keys of a packed-switch or sparse-switch payload
+        /// @param instruction payload of the switch
+        /// @return span with the keys
+        std::span<const std::int32_t> get_switch_keys(const flat_instruction_t &instruction) const
+        {
+            return {switch_keys.data() + instruction.index, instruction.second_index};
+        }
+
+        /// @brief Get the targets of a packed-switch or sparse-switch payload,
+        /// the targets are relative to the switch instruction in code units
+        /// @param instruction payload of the switch
+        /// @return span with the targets
+        std::span<const std::int32_t> get_switch_targets(const flat_instruction_t &instruction) const
+        {
+            return {switch_targets.data() + instruction.index, instruction.second_index};
+        }
+
+        /// @brief Get the raw data of a fill-array-data payload
+        /// @param instruction payload of the fill-array-data
+        /// @return span with the bytes of the elements
+        std::span<const std::uint8_t> get_array_data(const flat_instruction_t &instruction) const
+        {
+            return {array_data.data() + instruction.index,
+                    static_cast<std::size_t>(instruction.second_index * instruction.literal)};
+        }
+
+        /// @brief Get the memory used by the instructions and the side tables
+        /// @return number of bytes
+        std::size_t get_memory_size() const
+        {
+            return instructions.capacity() * sizeof(flat_instruction_t) +
+                   (switch_keys.capacity() + switch_targets.capacity()) * sizeof(std::int32_t) +
+                   array_data.capacity();
+        }
+    };
+} // namespace DEX
+} // namespace KUNAI
+
+#endif
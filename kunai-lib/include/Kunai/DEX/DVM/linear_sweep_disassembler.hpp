@@ -47,7 +47,7 @@ namespace DEX
         /// byte
         /// @param buffer_bytes bytes to disassembly
         /// @param instructions vector where to store the instructions
-        void disassembly(std::vector<std::uint8_t> &buffer_bytes,
+        void disassembly(std::span<const std::uint8_t> buffer_bytes,
                             std::vector<std::unique_ptr<Instruction>> &instructions);
     };
 } // DEX
@@ -36,7 +36,7 @@ namespace DEX
         void analyze_switch(
             std::vector<std::unique_ptr<Instruction>> &instructions,
             std::unordered_map<std::uint64_t, Instruction *> &cache_instrs,
-            std::vector<std::uint8_t> &buffer_bytes);
+            std::span<const std::uint8_t> buffer_bytes);
 
     public:
         RecursiveTraversalDisassembler() = default;
@@ -53,7 +53,7 @@ namespace DEX
         /// @param buffer_bytes bytes to disassembly
         /// @param method the method to determine the exceptions
         /// @param instructions vector where to store the instructions
-        void disassembly(std::vector<std::uint8_t> &buffer_bytes,
+        void disassembly(std::span<const std::uint8_t> buffer_bytes,
                             EncodedMethod *method,
                             std::vector<std::unique_ptr<Instruction>> &instructions);
     };
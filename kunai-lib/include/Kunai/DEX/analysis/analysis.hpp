@@ -12,10 +12,12 @@
 
 #include "Kunai/DEX/parser/parser.hpp"
 #include "Kunai/DEX/DVM/disassembler.hpp"
+#include "Kunai/DEX/DVM/dex_disassembler.hpp"
 #include "Kunai/DEX/analysis/external_class.hpp"
 #include "Kunai/DEX/DVM/dalvik_instructions.hpp"
 #include "Kunai/Exceptions/analysis_exception.hpp"
 
+#include <mutex>
 #include <set>
 #include <variant>
 
@@ -528,9 +530,21 @@ namespace KUNAI
             /// @brief number of parameters
             std::uint16_t num_of_params;
 
-            /// @brief Instructions of the current method
+            /// @brief Instructions of the current method, when they
+            /// are given in the constructor
             std::vector<std::unique_ptr<Instruction>> instructions;
 
+            /// @brief Disassembler used to obtain the instructions the
+            /// first time they are accessed, nullptr if they were given
+            DexDisassembler *dex_disassembler = nullptr;
+
+            /// @brief Instructions used by the method, the given ones or
+            /// the ones kept by the disassembler
+            std::vector<std::unique_ptr<Instruction>> *method_instructions = &instructions;
+
+            /// @brief flag to create only once the basic blocks
+            std::once_flag method_analyzed;
+
             /// @brief BasicBlocks from the method
             BasicBlocks basic_blocks;
 
@@ -572,10 +586,19 @@ namespace KUNAI
             /// will generate the basic blocks.
             void create_basic_blocks();
 
-        public:
-            MethodAnalysis(
-                std::variant<EncodedMethod *, ExternalMethod *> method_encoded,
-                std::vector<std::unique_ptr<Instruction>> &instructions) : method_encoded(method_encoded), instructions(std::move(instructions))
+            /// @brief Obtain the instructions of the method from the
+            /// disassembler, and create the basic blocks
+            void analyze_method();
+
+            /// @brief Analyze the method if it was not analyzed yet
+            void load_method() const
+            {
+                auto self = const_cast<MethodAnalysis *>(this);
+                std::call_once(self->method_analyzed, &MethodAnalysis::analyze_method, self);
+            }
+
+            /// @brief Set the number of registers and parameters of the method
+            void set_method_info()
             {
                 is_external = method_encoded.index() == 0 ? false : true;
 
@@ -587,9 +610,25 @@ namespace KUNAI
 
                     num_of_params = em->getMethodID()->get_proto()->get_parameters().size();
                 }
+            }
 
-                if (this->instructions.size() > 0)
-                    create_basic_blocks();
+        public:
+            MethodAnalysis(
+                std::variant<EncodedMethod *, ExternalMethod *> method_encoded,
+                std::vector<std::unique_ptr<Instruction>> &instructions) : method_encoded(method_encoded), instructions(std::move(instructions))
+            {
+                set_method_info();
+            }
+
+            /// @brief Constructor of a method whose instructions are
+            /// disassembled the first time its instructions or its
+            /// basic blocks are accessed
+            /// @param method_encoded method of the DEX file
+            /// @param dex_disassembler disassembler that keeps the instructions
+            MethodAnalysis(EncodedMethod *method_encoded, DexDisassembler *dex_disassembler)
+                : method_encoded(method_encoded), dex_disassembler(dex_disassembler)
+            {
+                set_method_info();
             }
 
             /// @brief Dump the method as a dot file into
@@ -602,6 +641,8 @@ namespace KUNAI
 
                 dot_file.open(file_path);
 
+                load_method();
+
                 dump_method_dot(dot_file);
             }
 
@@ -614,11 +655,13 @@ namespace KUNAI
 
             const BasicBlocks& get_basic_blocks() const
             {
+                load_method();
                 return basic_blocks;
             }
 
             BasicBlocks& get_basic_blocks()
             {
+                load_method();
                 return basic_blocks;
             }
 
@@ -648,7 +691,8 @@ namespace KUNAI
 
             std::vector<std::unique_ptr<Instruction>>& get_instructions()
             {
-                return instructions;
+                load_method();
+                return *method_instructions;
             }
 
             std::variant<EncodedMethod *, ExternalMethod *> get_encoded_method() const
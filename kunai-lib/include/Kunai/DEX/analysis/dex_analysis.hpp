@@ -17,6 +17,16 @@ namespace KUNAI
 {
 namespace DEX
 {
+    /// @brief Cross reference found in the bytecode of a method, written
+    /// with the ids of the DEX file so it can be stored in a snapshot
+    struct xref_record_t
+    {
+        std::uint32_t method;   //! position of the method in the classes of the parser
+        std::uint32_t offset;   //! offset of the instruction in the method
+        std::uint32_t target;   //! id of the type, method, string or field referenced
+        std::uint32_t opcode;   //! opcode of the instruction
+    };
+
     class Analysis
     {
         /// @brief all the dex parsers from the analysis
@@ -60,19 +70,49 @@ namespace DEX
         /// @brief Pointer to a disassembler for obtaining the instructions
         DexDisassembler * disassembler;
 
+        /// @brief disassembler of each parser, the instructions of the
+        /// methods must be decoded with the ids of their own parser
+        std::unordered_map<Parser*, DexDisassembler*> parser_disassemblers;
+
         /// @brief are the xrefs already created?
         bool created_xrefs = false;
 
-        /// @brief Internal method for creating the xref for `current_class`
-        /// There are four steps involved in getting the xrefs:
+        /// @brief xrefs of each parser, collected from the instructions
+        /// or given from a snapshot, a parser without an entry has not
+        /// its xrefs yet (an empty entry is a parser without xrefs)
+        std::unordered_map<Parser*, std::vector<xref_record_t>> xref_records;
+
+        /// @brief Internal method for collecting the xrefs of `current_class`
+        /// There are four kinds of xrefs:
         ///     * xrefs for class instantiation and static class usage.
         ///     * xrefs for method calls
         ///     * xrefs for string usage
         ///     * xrefs field manipuation
-        /// All the information is stored in the Analysis objects.
-        /// It might be quite slow as all instructions are parsed.
-        /// @param current_class class to create the xrefs.
-        void _create_xrefs(ClassDef * current_class);
+        /// The instructions are decoded in the flat representation. With
+        /// the linear sweep all the bytecode is decoded, with the recursive
+        /// traversal only the instructions reached by the disassembler are
+        /// decoded (those are taken from its cache, or disassembled).
+        /// @param parser parser the class belongs to
+        /// @param current_class class to collect the xrefs.
+        /// @param method_position position of the next method of the parser
+        /// @param records vector where to store the xrefs
+        void _collect_xrefs(Parser * parser,
+            ClassDef * current_class,
+            std::uint32_t & method_position,
+            std::vector<xref_record_t> & records);
+
+        /// @brief Store the xrefs of a parser in the Analysis objects
+        /// @param parser parser the xrefs belong to
+        /// @param records xrefs of the parser
+        void _apply_xrefs(Parser * parser, const std::vector<xref_record_t> & records);
+
+        /// @brief Check the xrefs given for a parser refer to methods,
+        /// types, strings and fields that exist in the parser, with the
+        /// same conditions used when they are collected
+        /// @param parser parser the xrefs belong to
+        /// @param records xrefs of the parser
+        /// @return true if all the xrefs are correct
+        bool _check_xrefs(Parser * parser, const std::vector<xref_record_t> & records);
 
         /// @brief Get a method by its hash, return the MethodAnalysis object
         /// in case it doesn't exists, create an ExternalMethod
@@ -92,10 +132,18 @@ namespace DEX
         }
 
         /// @brief Add all the classes and methods from a parser
-        /// to the analysis class.
+        /// to the analysis class, the methods are disassembled
+        /// with the disassembler of the analysis.
         /// @param parser parser to extract the information
         void add(Parser * parser);
 
+        /// @brief Add all the classes and methods from a parser
+        /// to the analysis class, the methods are disassembled with
+        /// the given disassembler, e.g. one for each DEX file of an APK
+        /// @param parser parser to extract the information
+        /// @param parser_disassembler disassembler of the parser
+        void add(Parser * parser, DexDisassembler * parser_disassembler);
+
         /// @brief Create class, method, string and field cross references
         /// if you are using multiple DEX files, this function must
         /// be called when all DEX files are added.
@@ -104,6 +152,21 @@ namespace DEX
         /// ADD ALL DEX FIRST
         void create_xrefs();
 
+        /// @brief Give the xrefs of a parser, e.g. loaded from a snapshot,
+        /// so create_xrefs does not need to go through its instructions.
+        /// The xrefs are checked first, if any of them is not correct
+        /// all of them are rejected and create_xrefs will collect them
+        /// @param parser parser the xrefs belong to
+        /// @param records xrefs of the parser
+        /// @return true if the xrefs were accepted
+        bool set_xrefs(Parser * parser, std::vector<xref_record_t> && records);
+
+        /// @brief Get the xrefs of a parser, they are available once
+        /// create_xrefs has been called
+        /// @param parser parser of the xrefs
+        /// @return constant reference to the xrefs of the parser
+        const std::vector<xref_record_t>& get_xrefs(Parser * parser);
+
         /// @brief Get a ClassAnalysis object by the class name
         /// @param class_name name of the class to retrieve
         /// @return pointer to ClassAnalysis*
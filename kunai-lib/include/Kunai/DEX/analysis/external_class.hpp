@@ -25,8 +25,9 @@ namespace DEX
         std::string name;
         /// @brief Vector with all the external methods from the current class
         std::vector<ExternalMethod*> methods;
-        /// @brief Vector of EncodedFields created through FieldID
-        std::vector<encodedfield_t> fields;
+        /// @brief Vector of EncodedFields created through FieldID, these
+        /// are owned by the analysis and not by the arena of the parser
+        std::vector<std::unique_ptr<EncodedField>> fields;
     public:
         ExternalClass(std::string& name) : name(name)
         {}
@@ -0,0 +1,83 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file snapshot.hpp
+// @brief Binary snapshot with the cross references of a DEX file, the
+// snapshot is keyed by the SHA-1 of the DEX file and it is read with
+// a memory mapping, so an analysis already done can be loaded without
+// going again through the instructions of all the methods. The xrefs
+// depend on the disassembly algorithm, so it is also part of the key.
+
+#ifndef KUNAI_DEX_ANALYSIS_SNAPSHOT_HPP
+#define KUNAI_DEX_ANALYSIS_SNAPSHOT_HPP
+
+#include "Kunai/DEX/analysis/dex_analysis.hpp"
+#include "Kunai/Utils/checksum.hpp"
+
+#include <string>
+#include <vector>
+
+namespace KUNAI
+{
+namespace DEX
+{
+    /// @brief Reading and writing of the snapshots, a snapshot contains
+    /// a header with the version, the SHA-1 of the DEX file and the
+    /// disassembly algorithm followed by the xrefs of the DEX file as an
+    /// array of xref_record_t.
+    class Snapshot
+    {
+    public:
+        /// @brief version of the format, snapshots with other
+        /// version are not loaded
+        static constexpr std::uint32_t snapshot_version = 2;
+
+        /// @brief header of the snapshot file
+        struct snapshot_header_t
+        {
+            std::uint8_t magic[8];              //! "KUNAISNP"
+            std::uint32_t version;              //! version of the format
+            std::uint32_t record_size;          //! size of each xref record
+            utils::Sha1::digest_t dex_digest;   //! SHA-1 of the DEX file
+            std::uint32_t algorithm;            //! disassembly algorithm of the xrefs
+            std::uint64_t number_of_records;    //! number of xref records
+        };
+
+        /// @brief Get the path of the snapshot of a DEX file
+        /// @param snapshot_directory directory with the snapshots
+        /// @param dex_digest SHA-1 of the DEX file
+        /// @param algorithm disassembly algorithm used for the xrefs
+        /// @return path of the snapshot, named by the SHA-1 in hexadecimal
+        /// and the algorithm
+        static std::string get_snapshot_path(const std::string &snapshot_directory,
+                                             const utils::Sha1::digest_t &dex_digest,
+                                             DexDisassembler::disassembly_algorithm algorithm);
+
+        /// @brief Load the xrefs of a snapshot
+        /// @param snapshot_path path to the snapshot
+        /// @param dex_digest SHA-1 of the DEX file the xrefs must belong to
+        /// @param algorithm disassembly algorithm the xrefs must be collected with
+        /// @param records vector where to store the xrefs
+        /// @return true if the snapshot exists, it has the current version
+        /// and it belongs to the DEX file and the algorithm, false in other case
+        static bool load_xrefs(const std::string &snapshot_path,
+                               const utils::Sha1::digest_t &dex_digest,
+                               DexDisassembler::disassembly_algorithm algorithm,
+                               std::vector<xref_record_t> &records);
+
+        /// @brief Write the xrefs of a DEX file in a snapshot
+        /// @param snapshot_path path to the snapshot
+        /// @param dex_digest SHA-1 of the DEX file
+        /// @param algorithm disassembly algorithm the xrefs were collected with
+        /// @param records xrefs of the DEX file
+        /// @return true if the snapshot was written
+        static bool save_xrefs(const std::string &snapshot_path,
+                               const utils::Sha1::digest_t &dex_digest,
+                               DexDisassembler::disassembly_algorithm algorithm,
+                               const std::vector<xref_record_t> &records);
+    };
+} // namespace DEX
+} // namespace KUNAI
+
+#endif // KUNAI_DEX_ANALYSIS_SNAPSHOT_HPP
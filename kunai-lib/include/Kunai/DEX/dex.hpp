@@ -13,11 +13,15 @@
 //! utilities
 #include "Kunai/Utils/logger.hpp"
 #include "Kunai/Utils/kunaistream.hpp"
+#include "Kunai/Utils/mapped_file.hpp"
 #include "Kunai/DEX/parser/parser.hpp"
 #include "Kunai/DEX/DVM/dex_disassembler.hpp"
 #include "Kunai/DEX/analysis/dex_analysis.hpp"
+#include "Kunai/DEX/analysis/snapshot.hpp"
 
 #include <memory>
+#include <span>
+#include <vector>
 
 namespace KUNAI
 {
@@ -30,22 +34,47 @@ namespace DEX
     public:
         /// @brief Parse a given dex file, return a Dex object as a unique pointer
         /// @param dex_file_path path to a dex file
+        /// @param options options for the parser
         /// @return unique pointer with Dex object
-        static std::unique_ptr<Dex> parse_dex_file(std::string& dex_file_path);
+        static std::unique_ptr<Dex> parse_dex_file(std::string& dex_file_path, const parser_options_t& options = {});
 
-        static std::unique_ptr<Dex> parse_dex_file(char * dex_file_path);
+        static std::unique_ptr<Dex> parse_dex_file(char * dex_file_path, const parser_options_t& options = {});
 
-        static std::unique_ptr<Dex> parse_dex_file(const char * dex_file_path);
+        static std::unique_ptr<Dex> parse_dex_file(const char * dex_file_path, const parser_options_t& options = {});
+
+        /// @brief Parse a dex file already loaded in memory, the buffer
+        /// is not copied so it must live as long as the Dex object
+        /// @param buffer bytes of the dex file
+        /// @param options options for the parser
+        /// @return unique pointer with Dex object
+        static std::unique_ptr<Dex> parse_dex_buffer(std::span<const std::uint8_t> buffer, const parser_options_t& options = {});
+
+        /// @brief Parse a dex file already loaded in memory, the Dex
+        /// object takes the ownership of the buffer
+        /// @param buffer bytes of the dex file
+        /// @param options options for the parser
+        /// @return unique pointer with Dex object
+        static std::unique_ptr<Dex> parse_dex_buffer(std::vector<std::uint8_t>&& buffer, const parser_options_t& options = {});
     
     private:
         /// @brief Stream to manage the DEX file with utilities
         std::unique_ptr<stream::KunaiStream> kunai_stream;
-        /// @brief ifstream that will hold the dex file
+        /// @brief memory mapping of the dex file, used as backend
+        /// of the stream when the file can be mapped
+        std::unique_ptr<stream::MappedFile> mapped_file;
+        /// @brief ifstream that will hold the dex file in case
+        /// the file cannot be mapped in memory
         std::ifstream dex_file;
+        /// @brief buffer with the dex file in case the Dex
+        /// object owns the bytes of the file
+        std::vector<std::uint8_t> dex_buffer;
 
         /// @brief Parser for the DEX file
         std::unique_ptr<Parser> parser;
 
+        /// @brief options given to the parser
+        parser_options_t parser_options;
+
         /// @brief Disassembler for DEX file
         std::unique_ptr<DexDisassembler> dex_disassembler;
 
@@ -60,16 +89,47 @@ namespace DEX
         /// @param dex_file_path path to a dex file
         void initialization(std::string& dex_file_path);
 
+        /// @brief Method to initialize structures from a DEX
+        /// file in memory
+        /// @param buffer bytes of the dex file
+        void initialization(std::span<const std::uint8_t> buffer);
+
+        /// @brief Parse the DEX file once the stream has
+        /// been created and create the disassembler
+        void parse();
+
     public:
 
         /// @brief Constructor of the Dex object, we obtain a path
         /// to the DEX file to analyze.
         /// @param dex_file_path path to a dex file
-        Dex(std::string& dex_file_path)
+        /// @param options options for the parser
+        Dex(std::string& dex_file_path, const parser_options_t& options = {})
+            : parser_options(options)
         {
             initialization(dex_file_path);
         }
 
+        /// @brief Constructor of the Dex object from a buffer in memory,
+        /// the buffer is not owned by the Dex object
+        /// @param buffer bytes of the dex file
+        /// @param options options for the parser
+        Dex(std::span<const std::uint8_t> buffer, const parser_options_t& options = {})
+            : parser_options(options)
+        {
+            initialization(buffer);
+        }
+
+        /// @brief Constructor of the Dex object from a buffer in memory,
+        /// the Dex object takes the ownership of the buffer
+        /// @param buffer bytes of the dex file
+        /// @param options options for the parser
+        Dex(std::vector<std::uint8_t>&& buffer, const parser_options_t& options = {})
+            : dex_buffer(std::move(buffer)), parser_options(options)
+        {
+            initialization(std::span<const std::uint8_t>{dex_buffer.data(), dex_buffer.size()});
+        }
+
         /// @brief Destructor of the Dex object, release any memory
         /// or files here in case it is needed.
         ~Dex()
@@ -85,6 +145,14 @@ namespace DEX
             return parsing_correct;
         }
 
+        /// @brief Get the diagnostic of the parsing, with the
+        /// kind of error found when the parsing was not correct
+        /// @return constant reference to the diagnostic
+        const parse_diagnostic_t& get_diagnostic() const
+        {
+            return parser->get_diagnostic();
+        }
+
         /// @brief get a pointer to the DEX parser with all the headers
         /// @return dex parser
         Parser * get_parser()
@@ -100,13 +168,23 @@ namespace DEX
         }
         
         /// @brief Get the analysis object this needs the
-        /// disassembly and the parser, the dex will be
-        /// disassembled in case this function is called
+        /// disassembly and the parser, the methods of the dex
+        /// are disassembled the first time they are analyzed
         /// @param create_xrefs create all the xrefs for the
         /// class, this can take a long time
         /// @return pointer to Analysis object or nullptr
         /// in case of error
         Analysis * get_analysis(bool create_xrefs);
+
+        /// @brief Get the analysis object using a directory of snapshots,
+        /// if there is a snapshot of this DEX file its xrefs are loaded
+        /// instead of going through the instructions, in other case the
+        /// xrefs are created and a snapshot is written
+        /// @param create_xrefs create all the xrefs of the DEX file
+        /// @param snapshot_directory directory where the snapshots are stored
+        /// @return pointer to Analysis object or nullptr
+        /// in case of error
+        Analysis * get_analysis(bool create_xrefs, const std::string& snapshot_directory);
     };
 
 } // namespace DEX
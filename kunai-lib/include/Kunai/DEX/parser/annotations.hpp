@@ -14,8 +14,8 @@
 #include "Kunai/DEX/parser/methods.hpp"
 
 #include <memory>
+#include <span>
 #include <vector>
-#include <unordered_map>
 
 namespace KUNAI
 {
@@ -130,18 +130,12 @@ namespace DEX
     {
         /// @brief Offset to the annotations of the class
         std::uint32_t class_annotations_off;
-        /// @brief list of the field annotations
+        /// @brief list of the field annotations, sorted by field idx
         std::vector<fieldannotation_t> field_annotations;
-        /// @brief field annotations by id
-        std::unordered_map<std::uint32_t, FieldAnnotation*> field_annotations_by_id;
-        /// @brief list of method annotations
+        /// @brief list of method annotations, sorted by method idx
         std::vector<methodannotation_t> method_annotations;
-        /// @brief method annotations by id
-        std::unordered_map<std::uint32_t, MethodAnnotation*> method_annotations_by_id;
-        /// @brief list of parameter annotations
+        /// @brief list of parameter annotations, sorted by method idx
         std::vector<parameterannotation_t> parameter_annotations;
-        /// @brief parameter annotations by id
-        std::unordered_map<std::uint32_t, ParameterAnnotation*> parameter_annotations_by_id;
     public:
         /// @brief Constructor of AnnotationDirectoryItem
         AnnotationDirectoryItem() = default;
@@ -151,6 +145,14 @@ namespace DEX
         /// @param stream stream with the DEX file
         void parse_annotation_directory_item(stream::KunaiStream* stream);
 
+        /// @brief Get the offset to the annotations of the class
+        /// @return offset to the annotation set of the class, 0 if
+        /// the class has no annotations
+        std::uint32_t get_class_annotations_off() const
+        {
+            return class_annotations_off;
+        }
+
         /// @brief Get a constant reference to all the
         /// field annotations from the annotation directory
         /// @return constant reference to vector of field annotations
@@ -214,6 +216,88 @@ namespace DEX
         /// @return pointer to parameter annotations of the method
         ParameterAnnotation* get_parameter_annotation_by_id(std::uint32_t idx);
     };
+
+    /// @brief Kind of item where an annotation is applied
+    enum annotation_target_e : std::uint32_t
+    {
+        CLASS_ANNOTATION = 0,   //! annotation of a class
+        FIELD_ANNOTATION,       //! annotation of a field
+        METHOD_ANNOTATION,      //! annotation of a method
+        PARAMETER_ANNOTATION,   //! annotation of a parameter of a method
+    };
+
+    /// @brief Entry of the index of annotations, it only keeps the
+    /// type of the annotation, the elements are not decoded
+    struct annotated_item_t
+    {
+        DVMType* annotation_type;       //! type of the annotation
+        annotation_target_e target;     //! kind of the annotated item
+        std::uint32_t class_def;        //! position of the class_def of the item
+        std::uint32_t idx;              //! field or method idx, class idx for classes
+    };
+
+    /// @brief Index from the type of an annotation to the items
+    /// annotated with it, the entries are sorted by type and kind
+    /// of item so a query is a binary search
+    class AnnotationIndex
+    {
+        /// @brief entries of the index
+        std::vector<annotated_item_t> items;
+
+        /// @brief Add an entry for each annotation of an annotation_set_item
+        /// @param stream stream with the DEX file
+        /// @param types types of the DEX file
+        /// @param annotations_off offset to the annotation_set_item
+        /// @param target kind of the annotated item
+        /// @param class_def position of the class_def
+        /// @param idx idx of the annotated item
+        void add_annotation_set(stream::KunaiStream* stream,
+                                Types* types,
+                                std::uint32_t annotations_off,
+                                annotation_target_e target,
+                                std::uint32_t class_def,
+                                std::uint32_t idx);
+    public:
+        /// @brief Constructor of AnnotationIndex
+        AnnotationIndex() = default;
+        /// @brief Destructor of AnnotationIndex
+        ~AnnotationIndex() = default;
+
+        /// @brief Add all the annotations of a class to the index,
+        /// only the type of each annotation is read
+        /// @param stream stream with the DEX file
+        /// @param types types of the DEX file
+        /// @param annotation_directory annotations of the class
+        /// @param class_def position of the class_def
+        /// @param class_idx idx of the type of the class
+        void add_annotation_directory(stream::KunaiStream* stream,
+                                      Types* types,
+                                      const AnnotationDirectoryItem& annotation_directory,
+                                      std::uint32_t class_def,
+                                      std::uint32_t class_idx);
+
+        /// @brief Sort the entries once all the classes were added
+        void sort();
+
+        /// @brief Get all the entries of the index
+        /// @return constant reference to the entries
+        const std::vector<annotated_item_t>& get_items() const
+        {
+            return items;
+        }
+
+        /// @brief Get the items annotated with a type of annotation
+        /// @param annotation_type type of the annotation
+        /// @return entries of the items annotated with the type
+        std::span<const annotated_item_t> get_annotated_items(DVMType* annotation_type) const;
+
+        /// @brief Get the items of one kind annotated with a type of annotation
+        /// @param annotation_type type of the annotation
+        /// @param target kind of the annotated items
+        /// @return entries of the items annotated with the type
+        std::span<const annotated_item_t> get_annotated_items(DVMType* annotation_type,
+                                                              annotation_target_e target) const;
+    };
 } // namespace DEX
 } // namespace KUNAI
 
@@ -16,10 +16,13 @@
 
 #include "Kunai/DEX/parser/encoded.hpp"
 #include "Kunai/DEX/parser/annotations.hpp"
+#include "Kunai/Utils/thread_pool.hpp"
 
 #include <iostream>
 #include <vector>
 #include <unordered_map>
+#include <mutex>
+#include <string_view>
 
 namespace KUNAI
 {
@@ -31,19 +34,25 @@ namespace DEX
     {
         /// @brief Static fields from the class
         std::vector<encodedfield_t> static_fields;
-        std::unordered_map<std::uint64_t, EncodedField*> static_fields_by_id;
+        /// @brief ids of the static fields, in the same order than the
+        /// fields. The ids are written as increments in the DEX file,
+        /// so they are sorted and can be binary searched
+        std::vector<std::uint64_t> static_fields_ids;
 
         /// @brief Instance fields from the class
         std::vector<encodedfield_t> instance_fields;
-        std::unordered_map<std::uint64_t, EncodedField*> instance_fields_by_id;
+        /// @brief sorted ids of the instance fields
+        std::vector<std::uint64_t> instance_fields_ids;
 
         /// @brief Direct methods from the class
         std::vector<encodedmethod_t> direct_methods;
-        std::unordered_map<std::uint64_t, EncodedMethod*> direct_methods_by_id;
+        /// @brief sorted ids of the direct methods
+        std::vector<std::uint64_t> direct_methods_ids;
 
         /// @brief Virtual methods from the class
         std::vector<encodedmethod_t> virtual_methods;
-        std::unordered_map<std::uint64_t, EncodedMethod*> virtual_methods_by_id;
+        /// @brief sorted ids of the virtual methods
+        std::vector<std::uint64_t> virtual_methods_ids;
 
         /// @brief Vector with all the fields Static+Instance
         std::vector<EncodedField*> fields;
@@ -62,11 +71,16 @@ namespace DEX
         /// @param fields fields of the DEX file
         /// @param methods methods of the DEX file
         /// @param types types of the DEX file
+        /// @param arena arena where to allocate the encoded fields and methods
+        /// @param limits limits of the parser, a class with more fields or
+        /// methods than the limits is kept without data
         void parse_class_data_item(
             stream::KunaiStream* stream,
             Fields* fields,
             Methods* methods,
-            Types* types
+            Types* types,
+            utils::Arena* arena,
+            const resource_limits_t& limits
         );
 
         /// @brief Get the number of the static fields
@@ -170,12 +184,35 @@ namespace DEX
         /// @brief Structure with the definition of the class
         classdefstruct_t classdefstruct;
         /// @brief DVMClass for the current class
-        DVMClass* class_idx;
+        DVMClass* class_idx = nullptr;
         /// @brief DVMClass for the parent/super class
-        DVMClass* superclass_idx;
+        DVMClass* superclass_idx = nullptr;
         /// @brief String with the source file
         std::string source_file;
 
+        /// @brief stream used to parse the data of the class on demand,
+        /// nullptr when the DEX file is in memory
+        stream::KunaiStream* stream = nullptr;
+        /// @brief DEX file in memory used to parse the data of the class
+        /// on demand, it is read with a cursor owned by the class
+        std::span<const std::uint8_t> buffer;
+        /// @brief strings of the DEX file, used for parsing on demand
+        Strings* strings = nullptr;
+        /// @brief types of the DEX file, used for parsing on demand
+        Types* types = nullptr;
+        /// @brief fields of the DEX file, used for parsing on demand
+        Fields* fields = nullptr;
+        /// @brief methods of the DEX file, used for parsing on demand
+        Methods* methods = nullptr;
+        /// @brief arena of the parser, used for parsing on demand
+        utils::Arena* arena = nullptr;
+        /// @brief limits of the parser, used for parsing on demand
+        const resource_limits_t* limits = nullptr;
+        /// @brief flag to parse only once the data of the class
+        std::once_flag class_data_parsed;
+        /// @brief flag to parse only once the annotations of the class
+        std::once_flag annotations_parsed;
+
         /// @brief vector with the interfaces implemented
         std::vector<DVMClass*> interfaces;
 
@@ -186,7 +223,34 @@ namespace DEX
         ClassDataItem class_data_item;
 
         /// @brief Array of initial values for static fields.
-        std::vector<encodedarray_t> static_values;
+        EncodedArray static_values;
+
+        /// @brief Get the stream to parse the data of the class on demand
+        /// @param memory_stream owner of the cursor when the DEX file is in memory
+        /// @return stream to read the DEX file
+        stream::KunaiStream* get_data_stream(std::unique_ptr<stream::KunaiStream>& memory_stream);
+
+        /// @brief Parse the interfaces, class data item
+        /// and static values of the class
+        void parse_class_data();
+
+        /// @brief Parse the annotation directory of the class, the
+        /// annotations are only read the first time they are accessed
+        void parse_annotations();
+
+        /// @brief Parse the data of the class if it was not parsed yet
+        void load_class_data() const
+        {
+            auto self = const_cast<ClassDef*>(this);
+            std::call_once(self->class_data_parsed, &ClassDef::parse_class_data, self);
+        }
+
+        /// @brief Parse the annotations of the class if they were not parsed yet
+        void load_annotations() const
+        {
+            auto self = const_cast<ClassDef*>(this);
+            std::call_once(self->annotations_parsed, &ClassDef::parse_annotations, self);
+        }
     public:
         /// @brief Constructor of ClassDef
         ClassDef() = default;
@@ -200,11 +264,18 @@ namespace DEX
         /// @param types types of the DEX file
         /// @param fields fields of the DEX file
         /// @param methods methods of the DEX file
+        /// @param arena arena where to allocate the objects of the class
+        /// @param limits limits of the parser, they must live as long as the class
+        /// @param lazy parse only the classdef_t structure, the rest of the
+        /// data is parsed the first time it is accessed
         void parse_class_def(stream::KunaiStream* stream,
                              Strings* strings,
                              Types* types,
                              Fields* fields,
-                             Methods* methods);
+                             Methods* methods,
+                             utils::Arena* arena,
+                             const resource_limits_t* limits,
+                             bool lazy = false);
 
         /// @brief Get a constant reference to the classdefstruct_t
         /// of the class, this structure contains information about
@@ -256,6 +327,7 @@ namespace DEX
         /// @return constant reference to interfaces
         const std::vector<DVMClass*>& get_interfaces() const
         {
+            load_class_data();
             return interfaces;
         }
 
@@ -263,6 +335,7 @@ namespace DEX
         /// @return reference to interfaces
         std::vector<DVMClass*>& get_interfaces()
         {
+            load_class_data();
             return interfaces;
         }
 
@@ -270,6 +343,7 @@ namespace DEX
         /// @return constant reference to the class data item
         const ClassDataItem& get_class_data_item() const
         {
+            load_class_data();
             return class_data_item;
         }
 
@@ -277,9 +351,32 @@ namespace DEX
         /// @return reference to the class data item
         ClassDataItem& get_class_data_item()
         {
+            load_class_data();
             return class_data_item;
         }
-    
+
+        /// @brief Get a reference to the annotations of the class, the
+        /// annotation directory is parsed in the first call
+        /// @return reference to the annotation directory
+        AnnotationDirectoryItem& get_annotation_directory()
+        {
+            load_annotations();
+            return annotation_directory;
+        }
+
+        /// @brief Add the annotations of the class to an index of annotations
+        /// @param annotation_index index where to add the annotations
+        /// @param class_def position of the class in the class_defs
+        void add_to_annotation_index(AnnotationIndex& annotation_index, std::uint32_t class_def);
+
+        /// @brief Get a reference to the initial values of the static fields,
+        /// in the same order than the static fields
+        /// @return reference to the static values
+        EncodedArray& get_static_values()
+        {
+            load_class_data();
+            return static_values;
+        }
 
     };
 
@@ -292,7 +389,20 @@ namespace DEX
         /// for each class
         std::vector<classdef_t> class_defs;
         /// @brief Number of classes
-        std::uint32_t number_of_classes;
+        std::uint32_t number_of_classes = 0;
+        /// @brief types of the DEX file, used for the index of annotations
+        Types* types = nullptr;
+        /// @brief fields of the DEX file, used for the index of annotations
+        Fields* fields = nullptr;
+        /// @brief methods of the DEX file, used for the index of annotations
+        Methods* methods = nullptr;
+        /// @brief index from type of annotation to annotated items
+        AnnotationIndex annotation_index;
+        /// @brief flag to build only once the index of annotations
+        std::once_flag annotation_index_built;
+
+        /// @brief Read the annotations of all the classes and build the index
+        void build_annotation_index();
     public:
         /// @brief Constructor from Classes
         Classes() = default;
@@ -306,6 +416,12 @@ namespace DEX
         /// @param types types from the DEX file
         /// @param fields fields from the DEX file
         /// @param methods methods from the DEX file
+        /// @param arena arena where to allocate the objects of the classes
+        /// @param limits limits of the parser, they must live as long as the classes
+        /// @param lazy parse only the class_def table, the data of each
+        /// class is parsed the first time it is accessed
+        /// @param pool if given, and the DEX file is in memory, the class_defs
+        /// are parsed in chunks by the threads of the pool
         void parse_classes(
             stream::KunaiStream* stream,
             std::uint32_t number_of_classes,
@@ -313,7 +429,11 @@ namespace DEX
             Strings* strings,
             Types* types,
             Fields* fields,
-            Methods* methods 
+            Methods* methods,
+            utils::Arena* arena,
+            const resource_limits_t* limits,
+            bool lazy = false,
+            utils::ThreadPool* pool = nullptr
         );
 
         /// @brief Get the number of the classes from the DEX file
@@ -337,6 +457,39 @@ namespace DEX
             return class_defs;
         }
 
+        /// @brief Get a class def by the name of its class (e.g. Lcom/example/Main;),
+        /// this does not parse the data of any other class
+        /// @param name name of the class in raw format
+        /// @return pointer to the class def or nullptr if not found
+        ClassDef* get_classdef_by_name(std::string_view name);
+
+        /// @brief Get the index of annotations of the DEX file, it is
+        /// built the first time it is accessed reading only the type
+        /// of each annotation
+        /// @return constant reference to the index of annotations
+        const AnnotationIndex& get_annotation_index()
+        {
+            std::call_once(annotation_index_built, &Classes::build_annotation_index, this);
+            return annotation_index;
+        }
+
+        /// @brief Get the classes annotated with a type of annotation
+        /// @param annotation_type name of the annotation in raw format
+        /// (e.g. Ldalvik/annotation/MemberClasses;)
+        /// @return class defs with the annotation
+        std::vector<ClassDef*> get_annotated_classes(std::string_view annotation_type);
+
+        /// @brief Get the fields annotated with a type of annotation
+        /// @param annotation_type name of the annotation in raw format
+        /// @return fields with the annotation
+        std::vector<FieldID*> get_annotated_fields(std::string_view annotation_type);
+
+        /// @brief Get the methods annotated with a type of annotation
+        /// (e.g. Landroid/webkit/JavascriptInterface;)
+        /// @param annotation_type name of the annotation in raw format
+        /// @return methods with the annotation
+        std::vector<MethodID*> get_annotated_methods(std::string_view annotation_type);
+
         friend std::ostream& operator<<(std::ostream& os, const Classes& entry);
     };
 } // namespace DEX
@@ -0,0 +1,202 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file dex_visitor.hpp
+// @brief Streaming interface to inspect a DEX file without creating
+// the objects of the Parser. The DexWalker reads the file once and
+// calls the DexVisitor for each string, class definition, field,
+// method, code item and instruction, keeping only the state of the
+// element that is being visited.
+
+#ifndef KUNAI_DEX_PARSER_DEX_VISITOR_HPP
+#define KUNAI_DEX_PARSER_DEX_VISITOR_HPP
+
+#include "Kunai/DEX/parser/header.hpp"
+#include "Kunai/DEX/parser/classes.hpp"
+#include "Kunai/Utils/kunaistream.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace KUNAI
+{
+namespace DEX
+{
+    /// @brief Field of a class data item as it is in the file
+    struct visited_field_t
+    {
+        std::uint32_t field_idx;    //! id of the field in the field_ids table
+        std::uint32_t access_flags; //! access flags of the field
+        bool is_static;             //! static or instance field
+    };
+
+    /// @brief Method of a class data item as it is in the file
+    struct visited_method_t
+    {
+        std::uint32_t method_idx;   //! id of the method in the method_ids table
+        std::uint32_t access_flags; //! access flags of the method
+        std::uint32_t code_off;     //! offset of the code item, 0 if there is no code
+        bool is_virtual;            //! virtual or direct method
+    };
+
+    /// @brief Header of a code item and a view of its bytecode
+    struct visited_code_item_t
+    {
+        std::uint32_t method_idx;           //! method that owns the code
+        std::uint16_t registers_size;       //! number of registers
+        std::uint16_t ins_size;             //! number of words for incoming arguments
+        std::uint16_t outs_size;            //! number of words for outgoing arguments
+        std::uint16_t tries_size;           //! number of try items
+        std::uint32_t debug_info_off;       //! offset of the debug information
+        std::span<const std::uint8_t> insns;//! bytecode of the method
+    };
+
+    /// @brief Raw instruction from a code item
+    struct visited_instruction_t
+    {
+        std::uint32_t method_idx;           //! method that owns the instruction
+        std::uint32_t address;              //! offset in bytes from the start of the bytecode
+        std::uint8_t opcode;                //! opcode of the instruction
+        std::span<const std::uint8_t> bytes;//! bytes of the instruction, payloads included
+    };
+
+    /// @brief Interface with the callbacks called by the DexWalker, all of
+    /// them do nothing by default so a visitor only overrides the ones it
+    /// needs. The references given are only valid during the call.
+    class DexVisitor
+    {
+    public:
+        virtual ~DexVisitor() = default;
+
+        /// @brief Called once with the header of the file
+        /// @param header header of the DEX file
+        virtual void visit_header(const Header::dexheader_t &header) {}
+
+        /// @brief Called for every string of the string_ids table
+        /// @param id id of the string
+        /// @param value string decoded to UTF-8
+        virtual void visit_string(std::uint32_t id, const std::string &value) {}
+
+        /// @brief Called for every class definition
+        /// @param class_def structure of the class definition
+        virtual void visit_class_def(const ClassDef::classdefstruct_t &class_def) {}
+
+        /// @brief Called for every field of the class data items
+        /// @param field field visited
+        virtual void visit_field(const visited_field_t &field) {}
+
+        /// @brief Called for every method of the class data items
+        /// @param method method visited
+        virtual void visit_method(const visited_method_t &method) {}
+
+        /// @brief Called for every method with code
+        /// @param code_item code item visited
+        virtual void visit_code_item(const visited_code_item_t &code_item) {}
+
+        /// @brief Called for every instruction of a code item
+        /// @param instruction instruction visited
+        virtual void visit_instruction(const visited_instruction_t &instruction) {}
+
+        /// @brief Called once the whole file has been visited
+        virtual void visit_end() {}
+    };
+
+    /// @brief Options to choose which parts of the file are visited,
+    /// the parts not visited are not read
+    struct walker_options_t
+    {
+        /// @brief visit the strings of the string_ids table
+        bool visit_strings = true;
+
+        /// @brief visit the class data items (fields and methods)
+        bool visit_class_data = true;
+
+        /// @brief visit the code items of the methods
+        bool visit_code = true;
+
+        /// @brief visit each instruction of the code items
+        bool visit_instructions = true;
+    };
+
+    /// @brief Goes through a DEX file in one forward pass calling a visitor,
+    /// the DEX file is not parsed into objects, so the memory used does not
+    /// depend on the size of the file.
+    class DexWalker
+    {
+        /// @brief stream with the DEX file
+        stream::KunaiStream *stream;
+
+        /// @brief options for the walk
+        walker_options_t options;
+
+        /// @brief header of the DEX file, read when the walk starts
+        Header header;
+
+        /// @brief bytecode of the current code item for streams that
+        /// are not in memory, reused between methods
+        std::vector<std::uint8_t> code_buffer;
+
+        /// @brief visit the data of a class
+        /// @param visitor visitor to call
+        /// @param class_data_off offset of the class data item
+        void walk_class_data(DexVisitor &visitor, std::uint32_t class_data_off);
+
+        /// @brief visit a code item and its instructions
+        /// @param visitor visitor to call
+        /// @param method_idx id of the method with the code
+        /// @param code_off offset of the code item
+        void walk_code_item(DexVisitor &visitor, std::uint32_t method_idx, std::uint32_t code_off);
+
+        /// @brief read a value from the given offset of the file, the
+        /// cursor of the stream is left where it was, so it can be called
+        /// by the visitors in the middle of the walk
+        /// @tparam T type of the value
+        /// @param offset offset of the value
+        /// @return value read
+        template <typename T>
+        T read_at(std::uint64_t offset)
+        {
+            T value;
+            auto current_offset = stream->tellg();
+            stream->seekg(static_cast<std::streamoff>(offset), std::ios_base::beg);
+            stream->read_data<T>(value, sizeof(T));
+            stream->seekg(current_offset, std::ios_base::beg);
+            return value;
+        }
+
+    public:
+        /// @brief Constructor of the walker
+        /// @param stream stream with the DEX file, in memory or in a file
+        /// @param options parts of the file to visit
+        DexWalker(stream::KunaiStream *stream, const walker_options_t &options = {})
+            : stream(stream), options(options)
+        {
+        }
+
+        /// @brief Visit the whole DEX file, the header, the strings and
+        /// then each class with its fields, methods and code
+        /// @param visitor visitor to call
+        /// @throw exceptions::IncorrectDexFileException if the file is not a DEX file
+        /// @throw exceptions::StreamException if the file is truncated
+        void walk(DexVisitor &visitor);
+
+        /// @brief Read a string from the string_ids table, can be used
+        /// by the visitors to resolve the ids they receive, the position
+        /// of the walk is not modified
+        /// @param id id of the string
+        /// @return string decoded to UTF-8
+        std::string read_string(std::uint32_t id);
+
+        /// @brief Read the descriptor of a type from the type_ids table,
+        /// the position of the walk is not modified
+        /// @param id id of the type
+        /// @return descriptor of the type
+        std::string read_type(std::uint32_t id);
+    };
+} // namespace DEX
+} // namespace KUNAI
+
+#endif // KUNAI_DEX_PARSER_DEX_VISITOR_HPP
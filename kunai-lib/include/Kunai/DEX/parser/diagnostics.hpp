@@ -0,0 +1,52 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file diagnostics.hpp
+// @brief Result of the parsing of a DEX file given as an error code,
+// so the errors can be checked without catching exceptions.
+
+#ifndef KUNAI_DEX_PARSER_DIAGNOSTICS_HPP
+#define KUNAI_DEX_PARSER_DIAGNOSTICS_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace KUNAI
+{
+namespace DEX
+{
+    /// @brief Kind of error found while parsing a DEX file
+    enum class parse_error_e : std::uint32_t
+    {
+        NO_ERROR = 0,           //! the file was parsed correctly
+        INCORRECT_SIZE,         //! the file is smaller than the header
+        INCORRECT_MAGIC,        //! the file is not a DEX file
+        INCORRECT_TABLE,        //! a table of ids is out of the file or has incorrect ids
+        INCORRECT_ID,           //! an id points to an entry that does not exist
+        OUT_OF_BOUND,           //! an offset points out of the file
+        INCORRECT_STRING,       //! a string is not correct MUTF-8
+        INCORRECT_INTEGRITY,    //! the checksum or the signature are not correct
+        LIMIT_EXCEEDED,         //! a table needs more memory than the limit
+        STREAM_ERROR,           //! error reading the file
+        PARSER_ERROR,           //! other error of the parser
+    };
+
+    /// @brief Diagnostic of the parsing, the first error found
+    struct parse_diagnostic_t
+    {
+        parse_error_e error = parse_error_e::NO_ERROR; //! kind of error
+        std::string message;                           //! description of the error
+        std::uint64_t offset = 0;                      //! offset of the error in the file, if known
+
+        /// @brief Was the parsing correct?
+        /// @return true if there was no error
+        bool is_correct() const
+        {
+            return error == parse_error_e::NO_ERROR;
+        }
+    };
+} // namespace DEX
+} // namespace KUNAI
+
+#endif // KUNAI_DEX_PARSER_DIAGNOSTICS_HPP
@@ -16,10 +16,13 @@
 #include "Kunai/DEX/parser/fields.hpp"
 #include "Kunai/DEX/parser/methods.hpp"
 #include "Kunai/DEX/DVM/dvm_types.hpp"
+#include "Kunai/DEX/parser/limits.hpp"
 #include "Kunai/Utils/kunaistream.hpp"
+#include "Kunai/Utils/arena.hpp"
 
 #include <iostream>
 #include <vector>
+#include <span>
 
 namespace KUNAI
 {
@@ -28,15 +31,15 @@ namespace DEX
     /// @brief Forward declaration of EncodedValue for allowing its usage
     /// in EncodedArray and AnnotationElement
     class EncodedValue;
-    using encodedvalue_t = std::unique_ptr<EncodedValue>;
+    class EncodedAnnotation;
 
     /// @brief Information of an array with encoded values
     class EncodedArray
     {
         /// @brief size of the array
-        std::uint64_t array_size;
-        /// @brief encoded values of the array
-        std::vector<encodedvalue_t> values;
+        std::uint64_t array_size = 0;
+        /// @brief encoded values of the array, stored contiguously
+        std::vector<EncodedValue> values;
     public:
         /// @brief Constructor of the encoded array
         EncodedArray() = default;
@@ -47,9 +50,11 @@ namespace DEX
         /// @param stream stream where to read data
         /// @param types object with types for parsing encoded array
         /// @param strings object with strings for parsing encoded array
+        /// @param arena arena where to allocate the nested arrays and annotations
         void parse_encoded_array(stream::KunaiStream* stream,
                                 Types* types,
-                                Strings* strings);
+                                Strings* strings,
+                                utils::Arena* arena);
 
         /// @brief get the size of the array
         /// @return size of the array
@@ -60,14 +65,14 @@ namespace DEX
 
         /// @brief Get constant reference to encoded values
         /// @return constant reference to encoded values
-        const std::vector<encodedvalue_t>& get_values() const
+        const std::vector<EncodedValue>& get_values() const
         {
             return values;
         }
 
         /// @brief Get a reference to encoded values
         /// @return reference to encoded values
-        std::vector<encodedvalue_t>& get_values()
+        std::vector<EncodedValue>& get_values()
         {
             return values;
         }
@@ -75,6 +80,173 @@ namespace DEX
 
     using encodedarray_t = std::unique_ptr<EncodedArray>;
 
+    /// @brief encoded piece of (nearly) arbitrary hierarchically structured data.
+    /// The scalars and indexes are decoded once while parsing and stored
+    /// inline, only arrays and annotations are allocated in the arena.
+    class EncodedValue
+    {
+        /// @brief type of value
+        TYPES::value_format value_type = TYPES::value_format::VALUE_NULL;
+        /// @brief argument of the value, the size of the value minus
+        /// one, or the value for booleans
+        std::uint8_t value_args = 0;
+        /// @brief decoded value, the member used depends on the type
+        union
+        {
+            std::int64_t int_value;     //! byte, short, char, int and long
+            float float_value;          //! float
+            double double_value;        //! double
+            std::uint32_t index;        //! string, type, field, method, enum, method type and method handle
+            bool boolean_value;         //! boolean
+        } value = {0};
+        /// @brief In case the value is an array store an array
+        utils::arena_ptr<EncodedArray> array_data;
+        /// @brief In case it is an annotation, store an encoded annotation
+        utils::arena_ptr<EncodedAnnotation> annotation;
+
+    public:
+        /// @brief Constructor of EncodedValue
+        EncodedValue() = default;
+        /// @brief Destructor of EncodedValue
+        ~EncodedValue() = default;
+
+        /// @brief Move constructor of EncodedValue
+        EncodedValue(EncodedValue&&) = default;
+        /// @brief Move assignment of EncodedValue
+        EncodedValue& operator=(EncodedValue&&) = default;
+
+        /// @brief Parse the encoded value
+        /// @param stream stream to read data
+        /// @param types object with types for parsing encoded values
+        /// @param strings object with strings for parsing encoded values
+        /// @param arena arena where to allocate the nested arrays and annotations
+        void parse_encoded_value(stream::KunaiStream* stream,
+                                Types* types,
+                                Strings* strings,
+                                utils::Arena* arena);
+
+        /// @brief Get the enum with the value type
+        /// @return value_format of the encoded value
+        TYPES::value_format get_value_type() const
+        {
+            return value_type;
+        }
+
+        /// @brief Return the argument of the value, for the values
+        /// stored in bytes this is the number of bytes minus one
+        /// @return argument of the value
+        std::uint8_t size_of_value() const
+        {
+            return value_args;
+        }
+
+        /// @brief Get the value of a byte, short, char, int or long,
+        /// the value is already sign extended (zero extended for char)
+        /// @return integer value
+        std::int64_t as_int() const
+        {
+            return value.int_value;
+        }
+
+        /// @brief Get the value of a float
+        /// @return float value
+        float as_float() const
+        {
+            return value.float_value;
+        }
+
+        /// @brief Get the value of a double
+        /// @return double value
+        double as_double() const
+        {
+            return value.double_value;
+        }
+
+        /// @brief Get the value of a boolean
+        /// @return boolean value
+        bool as_boolean() const
+        {
+            return value.boolean_value;
+        }
+
+        /// @brief Get the string id of a VALUE_STRING
+        /// @return index in the string ids
+        std::uint32_t as_string_id() const
+        {
+            return value.index;
+        }
+
+        /// @brief Get the type id of a VALUE_TYPE
+        /// @return index in the type ids
+        std::uint32_t as_type_id() const
+        {
+            return value.index;
+        }
+
+        /// @brief Get the field id of a VALUE_FIELD or VALUE_ENUM
+        /// @return index in the field ids
+        std::uint32_t as_field_id() const
+        {
+            return value.index;
+        }
+
+        /// @brief Get the method id of a VALUE_METHOD
+        /// @return index in the method ids
+        std::uint32_t as_method_id() const
+        {
+            return value.index;
+        }
+
+        /// @brief Get the proto id of a VALUE_METHOD_TYPE
+        /// @return index in the proto ids
+        std::uint32_t as_proto_id() const
+        {
+            return value.index;
+        }
+
+        /// @brief Get the method handle of a VALUE_METHOD_HANDLE
+        /// @return index in the method handles
+        std::uint32_t as_method_handle_id() const
+        {
+            return value.index;
+        }
+
+        /// @brief Check if the value is null
+        /// @return true if the value is VALUE_NULL
+        bool is_null() const
+        {
+            return value_type == TYPES::value_format::VALUE_NULL;
+        }
+
+        /// @brief in case the value is an array return it
+        /// @return pointer to encoded array or nullptr
+        const EncodedArray* get_array() const
+        {
+            return array_data.get();
+        }
+
+        /// @brief get the array in case value is an array
+        /// @return pointer to encoded array or nullptr
+        EncodedArray* get_array()
+        {
+            return array_data.get();
+        }
+
+        /// @brief get the annotation in case it is annotation
+        /// @return pointer to encoded annotation or nullptr
+        const EncodedAnnotation* get_annotation() const
+        {
+            return annotation.get();
+        }
+
+        /// @brief get the annotation in case it is annotation
+        /// @return pointer to encoded annotation or nullptr
+        EncodedAnnotation* get_annotation()
+        {
+            return annotation.get();
+        }
+    };
+
     /// @brief Annotation element with value and a name
     /// this is contained in the EncodedAnnotation class
     class AnnotationElement
@@ -82,12 +254,12 @@ namespace DEX
         /// @brief name of the annotation element
         std::string& name;
         /// @brief element value
-        encodedvalue_t value;
+        EncodedValue value;
     public:
         /// @brief Constructor of the annotation element
         /// @param name name of the annotation
         /// @param value value of the annotation
-        AnnotationElement(std::string& name, encodedvalue_t value)
+        AnnotationElement(std::string& name, EncodedValue&& value)
             : name(name), value(std::move(value))
         {}
 
@@ -105,11 +277,11 @@ namespace DEX
         /// @return value of the annotation
         EncodedValue* get_value()
         {
-            return value.get();
+            return &value;
         }
     };
 
-    using annotationelement_t = std::unique_ptr<AnnotationElement>;
+    using annotationelement_t = utils::arena_ptr<AnnotationElement>;
 
     /// @brief Class to parse and create a vector of
     /// Annotations
@@ -132,10 +304,12 @@ namespace DEX
         /// @param stream stream with the DEX file
         /// @param types types for parsing the encoded annotation
         /// @param strings strings for parsing the encoded annotation
+        /// @param arena arena where to allocate the annotation elements
         void parse_encoded_annotation(
             stream::KunaiStream* stream,
             Types* types,
-            Strings* strings
+            Strings* strings,
+            utils::Arena* arena
         );
 
         /// @brief Get the type of the annotations
@@ -172,94 +346,6 @@ namespace DEX
         AnnotationElement* get_annotation_by_pos(std::uint32_t pos);
     };
 
-    /// @brief encoded piece of (nearly) arbitrary hierarchically structured data.
-    class EncodedValue
-    {
-        /// @brief type of value
-        TYPES::value_format value_type;
-        /// @brief number of values
-        std::uint8_t value_args;
-        /// @brief save the value in an array of bytes
-        /// the value can have different format
-        std::vector<std::uint8_t> values;
-        /// @brief In case the value is an array
-        /// store an array
-        EncodedArray array_data;
-        /// @brief In case it is an annotation, store
-        /// an encoded annotation
-        EncodedAnnotation annotation;
-    
-    public:
-        /// @brief Constructor of EncodedValue
-        EncodedValue() = default;
-        /// @brief Destructor of EncodedValue
-        ~EncodedValue() = default;
-
-        /// @brief Parse the encoded value
-        /// @param stream stream to read data
-        /// @param types object with types for parsing encoded values
-        /// @param strings object with strings for parsing encoded values
-        void parse_encoded_value(stream::KunaiStream* stream,
-                                Types* types,
-                                Strings* strings);
-
-        /// @brief Get the enum with the value type
-        /// @return value_format of the encoded value
-        TYPES::value_format get_value_type() const
-        {
-            return value_type;
-        }
-
-        /// @brief Return the size of the value
-        /// @return size of the value
-        std::uint8_t size_of_value() const
-        {
-            return value_args;
-        }
-
-        /// @brief Get a constant reference to the values
-        /// @return constant reference to values
-        const std::vector<std::uint8_t>& get_values() const
-        {
-            return values;
-        }
-
-        /// @brief Get a reference to the values
-        /// @return reference to the values
-        std::vector<std::uint8_t>& get_values()
-        {
-            return values;
-        }
-
-        /// @brief in case the value is an array return it
-        /// @return reference to encoded array
-        const EncodedArray& get_array() const
-        {
-            return array_data;
-        }
-
-        /// @brief get a reference to the array in case value is an array
-        /// @return reference to encoded array
-        EncodedArray& get_array()
-        {
-            return array_data;
-        }
-
-        /// @brief get a reference to annotation in case it is annotation
-        /// @return reference to encoded annotation
-        const EncodedAnnotation& get_annotation() const
-        {
-            return annotation;
-        }
-
-        /// @brief get a reference to annotation in case it is annotation
-        /// @return reference to encoded annotation
-        EncodedAnnotation& get_annotation()
-        {
-            return annotation;
-        }
-    };
-
     /// @brief Class that represent field information
     /// it contains a FieldID and also the access flags.
     class EncodedField
@@ -268,8 +354,8 @@ namespace DEX
         FieldID * field_idx;
         /// @brief access flags for the field
         TYPES::access_flags flags;
-        /// @brief Initial Value
-        EncodedArray* initial_value;
+        /// @brief Initial value of static fields
+        EncodedValue* initial_value = nullptr;
     public:
         /// @brief Constructor of an encoded field
         /// @param field_idx FieldID for the encoded field
@@ -305,19 +391,21 @@ namespace DEX
         }
 
         /// @brief Those fields that are static contains an initial value
-        /// @param initial_value 
-        void set_initial_value(EncodedArray* initial_value)
+        /// @param initial_value value from the static values of the class
+        void set_initial_value(EncodedValue* initial_value)
         {
             this->initial_value = initial_value;
         }
 
-        EncodedArray* get_initial_value()
+        /// @brief Get the initial value of a static field
+        /// @return pointer to the initial value or nullptr
+        EncodedValue* get_initial_value()
         {
             return initial_value;
         }
     };
 
-    using encodedfield_t = std::unique_ptr<EncodedField>;
+    using encodedfield_t = utils::arena_ptr<EncodedField>;
 
     /// @brief Type of exception to catch with its address
     class EncodedTypePair
@@ -358,7 +446,7 @@ namespace DEX
         }
     };
 
-    using encodedtypepair_t = std::unique_ptr<EncodedTypePair>;
+    using encodedtypepair_t = utils::arena_ptr<EncodedTypePair>;
 
     /// @brief Information of catch handlers
     class EncodedCatchHandler
@@ -385,8 +473,10 @@ namespace DEX
         /// @brief Parse all the encoded type pairs
         /// @param stream stream with DEX data
         /// @param types types for the EncodedTypePair
+        /// @param arena arena where to allocate the EncodedTypePair
         void parse_encoded_catch_handler(stream::KunaiStream* stream,
-                                         Types* types);
+                                         Types* types,
+                                         utils::Arena* arena);
 
         /// @brief Check value of size to test if there are encodedtypepairs 
         /// @return if there are explicit typed catches
@@ -436,7 +526,7 @@ namespace DEX
         EncodedTypePair *get_handler_by_pos(std::uint64_t pos);
     };
 
-    using encodedcatchhandler_t = std::unique_ptr<EncodedCatchHandler>;
+    using encodedcatchhandler_t = utils::arena_ptr<EncodedCatchHandler>;
 
     /// @brief Class that specify the information from a try
     /// specifies address, number of instructions, and offset
@@ -492,7 +582,7 @@ namespace DEX
         }
     };
 
-    using tryitem_t = std::unique_ptr<TryItem>;
+    using tryitem_t = utils::arena_ptr<TryItem>;
 
     /// @brief Save the information of the code from a Method
     class CodeItemStruct
@@ -512,8 +602,12 @@ namespace DEX
     private:
         /// @brief Information of code item
         code_item_struct_t code_item;
-        /// @brief Vector with the bytecode of the instructions
+        /// @brief Vector with a copy of the bytecode of the instructions,
+        /// only used when the DEX file is not in memory
         std::vector<std::uint8_t> instructions_raw;
+        /// @brief View of the bytecode of the instructions, it points
+        /// to the DEX file in memory or to instructions_raw
+        std::span<const std::uint8_t> bytecode;
         /// @brief Vector of try_item
         std::vector<tryitem_t> try_items;
         /// @brief encoded catch handler offset for exception
@@ -532,9 +626,14 @@ namespace DEX
         /// @brief Parser for the CodeItemStruct
         /// @param stream DEX file where to read data
         /// @param types types of the DEX
+        /// @param arena arena where to allocate the try-catch information
+        /// @param limits limits of the parser, a code item with more
+        /// instructions than the limit is kept without code
         void parse_code_item_struct(
             stream::KunaiStream* stream,
-            Types* types
+            Types* types,
+            utils::Arena* arena,
+            const resource_limits_t& limits
         );
         /// @brief Get the number of registers used in a method
         /// @return number of registers
@@ -573,23 +672,17 @@ namespace DEX
 
         /// @brief Get size of the dalvik instructions (number of opcodes)
         /// @return size of dalvik instructions
-        std::uint16_t get_instructions_size() const
+        std::uint32_t get_instructions_size() const
         {
             return code_item.insns_size;
         }
 
-        /// @brief Get a constant reference to the vector with the bytecode
-        /// @return constant reference to the bytecode of the method
-        const std::vector<std::uint8_t>& get_bytecode() const
-        {
-            return instructions_raw;
-        }
-
-        /// @brief Get a reference to the vector with the bytecode
-        /// @return reference to bytecode of the method
-        std::vector<std::uint8_t>& get_bytecode()
+        /// @brief Get a view of the bytecode of the method, the bytecode
+        /// is not copied from the DEX file when the file is in memory
+        /// @return view of the bytecode of the method
+        std::span<const std::uint8_t> get_bytecode() const
         {
-            return instructions_raw;
+            return bytecode;
         }
     
         /// @brief Get a constant reference to the vector of Try Items
@@ -656,9 +749,13 @@ namespace DEX
         /// @param stream stream with DEX file
         /// @param code_off offset where code item struct
         /// @param types types from the DEX
+        /// @param arena arena where to allocate the objects of the code item
+        /// @param limits limits of the parser
         void parse_encoded_method(stream::KunaiStream* stream,
                                   std::uint64_t code_off,
-                                  Types* types);
+                                  Types* types,
+                                  utils::Arena* arena,
+                                  const resource_limits_t& limits);
         
         /// @brief Get a constant pointer to the MethodID of the method
         /// @return constant pointer to the MethodID
@@ -696,7 +793,7 @@ namespace DEX
         }
     };
 
-    using encodedmethod_t = std::unique_ptr<EncodedMethod>;
+    using encodedmethod_t = utils::arena_ptr<EncodedMethod>;
 } // namespace DEX
 } // namespace KUNAI
 
@@ -11,9 +11,12 @@
 #include "Kunai/DEX/parser/types.hpp"
 #include "Kunai/DEX/parser/strings.hpp"
 #include "Kunai/Utils/kunaistream.hpp"
+#include "Kunai/Utils/arena.hpp"
 
 #include <memory>
+#include <mutex>
 #include <vector>
+#include <string_view>
 
 namespace KUNAI
 {
@@ -34,8 +37,11 @@ namespace DEX
         std::string& name_;
         /// @brief pretty name with all the information
         std::string pretty_name;
+        /// @brief flag to create only once the pretty name, the
+        /// fields can be printed from different threads
+        std::once_flag pretty_name_created;
         /// @brief parent EncodedField
-        EncodedField * encoded_field;
+        EncodedField * encoded_field = nullptr;
     public:
 
         /// @brief Constructor of the FieldID
@@ -102,12 +108,19 @@ namespace DEX
             return name_;
         }
 
+        /// @brief Get a view of the name of the field
+        /// @return view of name_
+        std::string_view get_name_view() const
+        {
+            return name_;
+        }
+
         /// @brief Get a string representation of the field
         /// @return reference to pretty print of field
         std::string& pretty_field();
     };
 
-    using fieldid_t = std::unique_ptr<FieldID>;
+    using fieldid_t = utils::arena_ptr<FieldID>;
 
     /// @brief Fields will contain all the FieldID from the DEX file
     class Fields
@@ -131,12 +144,16 @@ namespace DEX
         /// @param strings strings objects
         /// @param fields_offset offset to the ids of the fields
         /// @param fields_size number of fields to read
+        /// @param arena arena where to allocate the field ids
+        /// @param trusted the table was validated, read it without checks
         void parse_fields(
             stream::KunaiStream* stream,
             Types* types,
             Strings* strings,
             std::uint32_t fields_offset,
-            std::uint32_t fields_size
+            std::uint32_t fields_size,
+            utils::Arena* arena,
+            bool trusted = false
         );
 
         /// @brief Get a constant reference to all the fields
@@ -158,6 +175,16 @@ namespace DEX
         /// @return pointer to FieldID
         FieldID* get_field(std::uint32_t pos);
 
+        /// @brief Get one of the fields by its position without throwing exceptions
+        /// @param pos position in the vector
+        /// @return pointer to FieldID or nullptr if the position is not correct
+        FieldID* try_get_field(std::uint32_t pos)
+        {
+            if (pos >= fields.size())
+                return nullptr;
+            return fields[pos].get();
+        }
+
         /// @brief Get the number of the fields
         /// @return value of fields_size
         std::uint32_t get_number_of_fields() const
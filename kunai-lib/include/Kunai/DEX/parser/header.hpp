@@ -13,7 +13,9 @@
 
 #include "Kunai/Utils/logger.hpp"
 #include "Kunai/Utils/kunaistream.hpp"
+#include "Kunai/Utils/checksum.hpp"
 #include "Kunai/Exceptions/parser_exception.hpp"
+#include <array>
 #include <iostream>
 #include <iomanip>
 
@@ -102,6 +104,26 @@ namespace KUNAI
                 return sizeof(dexheader_t);
             }
 
+            /// @brief Compute the Adler-32 checksum of the file, it covers
+            /// all the file except the magic and the checksum field
+            /// @param stream stream with the dex file
+            /// @return checksum of the file
+            std::uint32_t compute_checksum(stream::KunaiStream* stream) const;
+
+            /// @brief Compute the SHA-1 signature of the file, it covers all
+            /// the file except the magic, the checksum and the signature fields
+            /// @param stream stream with the dex file
+            /// @return signature of the file
+            utils::Sha1::digest_t compute_signature(stream::KunaiStream* stream) const;
+
+            /// @brief Verify the checksum and the signature of the header with
+            /// the file. When the file is in memory, the stream is not moved,
+            /// so this can run while other thread parses the file.
+            /// @param stream stream with the dex file
+            /// @param checksum verify the checksum field
+            /// @param signature verify the signature field
+            void verify(stream::KunaiStream* stream, bool checksum, bool signature) const;
+
             /// @brief Pretty printer for the operator << of the DEX header
             /// @param os output stream to print the dex header
             /// @param entry entry to print
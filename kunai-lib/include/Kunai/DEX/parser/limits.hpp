@@ -0,0 +1,46 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file limits.hpp
+// @brief Limits of the resources used for parsing a DEX file, the
+// sizes read from the file are checked with these limits and with
+// the size of the file before allocating memory for them.
+
+#ifndef KUNAI_DEX_PARSER_LIMITS_HPP
+#define KUNAI_DEX_PARSER_LIMITS_HPP
+
+#include <cstdint>
+
+namespace KUNAI
+{
+namespace DEX
+{
+    /// @brief Limits for the parser, a table of the header that goes
+    /// over the limits stops the parsing, a class or a method that goes
+    /// over the limits is kept without its data or its code
+    struct resource_limits_t
+    {
+        /// @brief maximum memory in bytes that a table of the
+        /// header can take once it is parsed
+        std::uint64_t max_allocation = 1ULL << 30;
+
+        /// @brief maximum number of fields of a class
+        std::uint64_t max_fields = 1ULL << 16;
+
+        /// @brief maximum number of methods of a class
+        std::uint64_t max_methods = 1ULL << 16;
+
+        /// @brief maximum size in 16-bit code units of the
+        /// instructions of a method
+        std::uint64_t max_instructions = 1ULL << 20;
+
+        /// @brief maximum size in bytes of a DEX file inflated from
+        /// an APK, checked with the size given by the ZIP before
+        /// allocating the buffer for the DEX file
+        std::uint64_t max_dex_size = 1ULL << 30;
+    };
+} // namespace DEX
+} // namespace KUNAI
+
+#endif // KUNAI_DEX_PARSER_LIMITS_HPP
@@ -11,9 +11,12 @@
 #include "Kunai/DEX/parser/protos.hpp"
 #include "Kunai/DEX/parser/strings.hpp"
 #include "Kunai/Utils/kunaistream.hpp"
+#include "Kunai/Utils/arena.hpp"
 
 #include <memory>
+#include <mutex>
 #include <vector>
+#include <string_view>
 
 
 namespace KUNAI
@@ -34,8 +37,14 @@ namespace KUNAI
             std::string& name_;
             /// @brief pretty name with all the information
             std::string pretty_name;
+            /// @brief flag to create only once the pretty name, the
+            /// methods can be printed from different threads
+            std::once_flag pretty_name_created;
+
+            /// @brief Create the pretty name of the method
+            void create_pretty_name();
             /// @brief pointer to the encoded method
-            EncodedMethod * encoded_method;
+            EncodedMethod * encoded_method = nullptr;
         public:
             
             /// @brief Constructor of the MethodID
@@ -106,12 +115,19 @@ namespace KUNAI
                 return name_;
             }
 
+            /// @brief Get a view of the name of the method
+            /// @return view of name_
+            std::string_view get_name_view() const
+            {
+                return name_;
+            }
+
             /// @brief Get a string representation of the method
             /// @return reference to pretty print of method
             std::string& pretty_method();
         };
 
-        using methodid_t = std::unique_ptr<MethodID>;
+        using methodid_t = utils::arena_ptr<MethodID>;
 
         /// @brief Methods contains all the MethodIDs from the DEX file
         class Methods
@@ -135,13 +151,17 @@ namespace KUNAI
             /// @param strings strings objects
             /// @param methods_offset offset to the ids of the methods
             /// @param methods_size number of methods to read
+            /// @param arena arena where to allocate the method ids
+            /// @param trusted the table was validated, read it without checks
             void parse_methods(
                 stream::KunaiStream* stream,
                 Types* types,
                 Protos* protos,
                 Strings* strings,
                 std::uint32_t methods_offset,
-                std::uint32_t methods_size
+                std::uint32_t methods_size,
+                utils::Arena* arena,
+                bool trusted = false
             );
 
             /// @brief Get a constant reference to all the methods
@@ -163,6 +183,16 @@ namespace KUNAI
             /// @return pointer to MethodID
             MethodID* get_method(std::uint32_t pos);
 
+            /// @brief Get one of the methods by its position without throwing exceptions
+            /// @param pos position in the vector
+            /// @return pointer to MethodID or nullptr if the position is not correct
+            MethodID* try_get_method(std::uint32_t pos)
+            {
+                if (pos >= methods.size())
+                    return nullptr;
+                return methods[pos].get();
+            }
+
             /// @brief Get the number of the methods
             /// @return value of methods_size
             std::uint32_t get_number_of_methods() const
@@ -17,16 +17,84 @@
 #include "Kunai/DEX/parser/fields.hpp"
 #include "Kunai/DEX/parser/methods.hpp"
 #include "Kunai/DEX/parser/classes.hpp"
+#include "Kunai/DEX/parser/diagnostics.hpp"
+#include "Kunai/DEX/parser/limits.hpp"
 #include "Kunai/Utils/kunaistream.hpp"
+#include "Kunai/Utils/arena.hpp"
 
 
 namespace KUNAI
 {
 namespace DEX
 {
+    /// @brief How much of the DEX file is parsed, each level
+    /// parses also the previous ones
+    enum class parse_level_e : std::uint32_t
+    {
+        HEADER = 0,     //! header and map list
+        STRINGS,        //! table of strings, the strings are decoded on demand
+        IDS,            //! types, protos, fields and methods
+        CLASS_DEFS,     //! class_defs, the data of the classes is parsed on demand
+        FULL,           //! everything, including the data and code of the classes
+    };
+
+    /// @brief Options that modify how the DEX file is parsed
+    struct parser_options_t
+    {
+        /// @brief tables of the DEX file to parse, the lower levels are
+        /// useful to obtain quickly the strings or the names of the classes
+        parse_level_e parse_level = parse_level_e::FULL;
+
+        /// @brief parse only the class_def table, the data of each
+        /// class (class data item, code items, annotations...) is
+        /// parsed the first time it is accessed
+        bool lazy_classes = false;
+
+        /// @brief parse the independent tables of the DEX file in
+        /// parallel, only used when the DEX file is in memory
+        bool parallel_parsing = false;
+
+        /// @brief number of threads for the parallel parsing, 0 to
+        /// use the number of hardware threads
+        std::uint32_t number_of_threads = 0;
+
+        /// @brief verify the Adler-32 checksum of the header, the
+        /// parsing fails if it is not correct
+        bool verify_checksum = false;
+
+        /// @brief verify the SHA-1 signature of the header, the
+        /// parsing fails if it is not correct
+        bool verify_signature = false;
+
+        /// @brief validate once the tables of ids of a DEX file in
+        /// memory, and if all the offsets and ids are in range read
+        /// the tables without the checks of each access
+        bool trusted_fast_path = true;
+
+        /// @brief check the tables of ids before parsing them, and if one
+        /// is not correct stop the parsing with a diagnostic instead of
+        /// parsing the tables with the checks of each access. It works
+        /// also for DEX files read from disk, but those are read entry
+        /// by entry from the file, so it takes longer than in memory
+        bool fail_fast = false;
+
+        /// @brief check while parsing that every string is correct
+        /// MUTF-8, the parsing fails with a diagnostic if one is not.
+        /// Without the check, an incorrect string throws an exception
+        /// the first time it is accessed
+        bool validate_strings = true;
+
+        /// @brief limits of the resources used by the parser
+        resource_limits_t limits;
+    };
 
     class Parser
     {
+        /// @brief Arena with the objects created during the parsing
+        /// (ids, encoded fields and methods, try-catch information...),
+        /// declared first so it is destroyed after the tables that use it
+        utils::Arena arena;
+
         /// @brief Dex header class
         /// with the dex header structure
         Header header;
@@ -58,11 +126,58 @@ namespace DEX
         /// @brief stream with the file
         stream::KunaiStream* stream;
 
+        /// @brief options for the parsing
+        parser_options_t options;
+
+        /// @brief were the tables of ids validated?
+        bool tables_validated = false;
+
+        /// @brief first error found parsing the file
+        parse_diagnostic_t diagnostic;
+
+        /// @brief check that the tables of ids from the header and the map
+        /// list are inside of the file, and that every id of the tables points
+        /// to an existing entry, it does not throw exceptions. In DEX
+        /// files read from disk the cursor of the stream is moved
+        /// @return diagnostic with the first incorrect table
+        parse_diagnostic_t check_tables() const;
+
+        /// @brief check that the tables of the header are inside of the
+        /// file and that they do not need more memory than the limits,
+        /// this is done before allocating any table
+        /// @return diagnostic with the first table that is not correct
+        parse_diagnostic_t check_limits() const;
+
+        /// @brief check the size and the magic of the file, parse the header
+        /// and check the tables of ids, the errors found in the checks are
+        /// stored in the diagnostic without throwing exceptions
+        /// @return false if the file cannot be parsed
+        bool check_and_parse_header();
+
+        /// @brief parse all the tables of the file once the header was parsed,
+        /// up to the parse level from the options, the incorrect strings are
+        /// stored in the diagnostic without throwing exceptions
+        /// @return false if the file cannot be parsed
+        bool parse_tables();
+
+        /// @brief Is the data of the classes parsed on demand?
+        /// @return true if the classes are lazy by the options or the parse level
+        bool get_lazy_classes() const
+        {
+            return options.lazy_classes || options.parse_level == parse_level_e::CLASS_DEFS;
+        }
+
+        /// @brief parse the tables after the strings using a pool of threads,
+        /// every task reads the file with its own cursor
+        void parse_tables_parallel();
+
     public:
 
         /// @brief Constructor of the parser
         /// @param stream stream where to read the data
-        Parser(stream::KunaiStream* stream) : stream(stream)
+        /// @param options options for the parsing
+        Parser(stream::KunaiStream* stream, const parser_options_t& options = {}) 
+            : stream(stream), options(options)
         {}
 
         /// @brief Destructor of the parser
@@ -71,6 +186,40 @@ namespace DEX
         /// @brief parse the dex file and obtain the different objects
         void parse_file();
 
+        /// @brief parse the dex file without throwing exceptions, the
+        /// first error found is returned as a diagnostic
+        /// @return constant reference to the diagnostic of the parsing
+        const parse_diagnostic_t& try_parse_file();
+
+        /// @brief Get the diagnostic of the parsing
+        /// @return constant reference to the diagnostic
+        const parse_diagnostic_t& get_diagnostic() const
+        {
+            return diagnostic;
+        }
+
+        /// @brief Get the options used for parsing
+        /// @return constant reference to the options
+        const parser_options_t& get_options() const
+        {
+            return options;
+        }
+
+        /// @brief Were the tables of ids validated and parsed
+        /// without the checks of each access?
+        /// @return true if the fast path was used
+        bool get_tables_validated() const
+        {
+            return tables_validated;
+        }
+
+        /// @brief Get the arena with the objects of the parser
+        /// @return constant reference to the arena
+        const utils::Arena& get_arena() const
+        {
+            return arena;
+        }
+
         /// @brief Return a const reference from the dex header
         /// @return const dex header reference
         const Header& get_header_const() const
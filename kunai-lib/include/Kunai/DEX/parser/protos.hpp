@@ -37,10 +37,12 @@
 #define KUNAI_DEX_PARSER_PROTOS_HPP
 
 #include "Kunai/Utils/kunaistream.hpp"
+#include "Kunai/Utils/arena.hpp"
 #include "Kunai/DEX/parser/types.hpp"
 #include "Kunai/DEX/parser/strings.hpp"
 
 #include <vector>
+#include <string_view>
 
 namespace KUNAI
 {
@@ -86,6 +88,20 @@ namespace DEX
             parse_parameters(stream, types, parameters_off);
         }
 
+        /// @brief Constructor of a ProtoID with the types already resolved
+        /// @param shorty_idx string with prototype
+        /// @param return_type type of the return
+        /// @param parameters types of the parameters
+        ProtoID(
+            std::string& shorty_idx,
+            DVMType* return_type,
+            std::vector<DVMType*>&& parameters)
+            : shorty_idx(shorty_idx),
+              return_type(return_type),
+              parameters(std::move(parameters))
+        {
+        }
+
         /// @brief Get constant reference to shorty_idx string
         /// @return constant reference to shorty_idx
         const std::string& get_shorty_idx() const
@@ -100,6 +116,13 @@ namespace DEX
             return shorty_idx;
         }
 
+        /// @brief Get a view of the shorty_idx string
+        /// @return view of shorty_idx
+        std::string_view get_shorty_idx_view() const
+        {
+            return shorty_idx;
+        }
+
         /// @brief Get a constant reference to the return type
         /// @return constant reference to return type
         const DVMType* get_return_type() const
@@ -129,7 +152,7 @@ namespace DEX
         } 
     };
 
-    using protoid_t = std::unique_ptr<ProtoID>;
+    using protoid_t = utils::arena_ptr<ProtoID>;
 
     /// @brief Class to manage all the ProtoID from the 
     /// DEX file
@@ -139,7 +162,7 @@ namespace DEX
         /// it has memory ownership
         std::vector<protoid_t> proto_ids;
         /// @brief nummber of protos to read
-        std::uint32_t number_of_protos;
+        std::uint32_t number_of_protos = 0;
 
     public:
         /// @brief Default constructor of protos
@@ -153,11 +176,15 @@ namespace DEX
         /// @param offset offset where to read the protos
         /// @param strings object with all the strings from the dex
         /// @param types object with all the types from the dex
+        /// @param arena arena where to allocate the proto ids
+        /// @param trusted the table was validated, read it without checks
         void parse_protos(stream::KunaiStream* stream,
                           std::uint32_t number_of_protos,
                           std::uint32_t offset,
                           Strings* strings,
-                          Types* types);
+                          Types* types,
+                          utils::Arena* arena,
+                          bool trusted = false);
 
         /// @brief Return a constant reference to proto_ids vector
         /// @return const reference to the proto_id vector
@@ -185,6 +212,26 @@ namespace DEX
         /// @return pointer to a ProtoID*
         ProtoID* get_proto_by_order(std::uint32_t pos);
 
+        /// @brief Given a position in the vector of protos, return a ProtoID
+        /// without throwing exceptions
+        /// @param pos position to obtain the ProtoID
+        /// @return pointer to a ProtoID or nullptr if the position is not correct
+        ProtoID* try_get_proto_by_order(std::uint32_t pos)
+        {
+            if (pos >= proto_ids.size())
+                return nullptr;
+            return proto_ids[pos].get();
+        }
+
+        /// @brief Given a position in the vector of protos, return a ProtoID
+        /// without checking the position, only for validated positions
+        /// @param pos position to obtain the ProtoID
+        /// @return pointer to a ProtoID*
+        ProtoID* get_proto_by_order_unchecked(std::uint32_t pos) const
+        {
+            return proto_ids[pos].get();
+        }
+
         /// @brief Return a pretty printed version of the proto_ids
         /// @param os stream where to print it
         /// @param entry entry to print
@@ -6,7 +6,8 @@
 // @file strings.hpp
 // @brief Class for managing the list of strings, these strings
 // follow an specific format where a `string_data_off` is used
-// to point to an `string_data_item`
+// to point to an `string_data_item`. The strings are decoded lazily,
+// only the offsets of the string table are read during parsing.
 
 #ifndef KUNAI_DEX_PARSER_STRINGS_HPP
 #define KUNAI_DEX_PARSER_STRINGS_HPP
@@ -14,7 +15,10 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
-#include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
 
 #include "Kunai/Utils/kunaistream.hpp"
 
@@ -26,20 +30,53 @@ namespace DEX
     /// dex file, also it will be used to access by order.
     using ordered_strings_t = std::vector<std::string>;
 
-    using offset_string_t = std::unordered_map<std::uint32_t, std::string*>;
+    /// @brief container with the offsets of the string_data_item
+    /// of each string, accessed by order.
+    using strings_offsets_t = std::vector<std::uint32_t>;
 
     /// @brief Storage class for all the strings
-    /// of the DEX file.
+    /// of the DEX file. Only the offsets of the strings are
+    /// read while parsing, each string is decoded the first
+    /// time it is accessed.
     class Strings
     {
         /// @brief offset of the table with the strings
         std::uint32_t strings_offset;
         /// @brief number of strings, returned for size of strings
-        std::uint32_t number_of_strings;
-        /// @brief variable with all the strings by id
+        std::uint32_t number_of_strings = 0;
+        /// @brief stream used to decode the strings on demand
+        stream::KunaiStream* stream = nullptr;
+        /// @brief offset of the string_data_item of every string by id
+        strings_offsets_t strings_offsets;
+        /// @brief are the offsets sorted? used to look for strings by offset
+        bool strings_offsets_sorted = true;
+        /// @brief variable with all the strings by id, a string
+        /// is empty until it is decoded
         ordered_strings_t ordered_strings;
-        /// @brief variable with all the strings by offset (pointer)
-        offset_string_t offset_strings;
+        /// @brief which strings have been decoded already, the strings
+        /// can be decoded from different threads
+        std::unique_ptr<std::atomic<bool>[]> decoded_strings;
+        /// @brief mutex to store the decoded strings
+        std::mutex decode_mutex;
+
+        /// @brief Find the data of a string in the file in memory
+        /// @param id id of the string, it must be a correct id
+        /// @param pos offset of the MUTF-8 data of the string
+        /// @param utf16_size size of the string in UTF-16 code units
+        /// @return false if the string is out of the file
+        bool locate_string_data(std::uint32_t id, std::size_t& pos, std::uint64_t& utf16_size);
+
+        /// @brief Decode (if necessary) the string with the given id
+        /// without throwing exceptions
+        /// @param id id of the string, it must be a correct id
+        /// @return pointer to decoded string, nullptr if the string
+        /// is out of the file or it is not correct MUTF-8
+        std::string* try_decode_string(std::uint32_t id);
+
+        /// @brief Decode (if necessary) the string with the given id
+        /// @param id id of the string, it must be a correct id
+        /// @return reference to decoded string
+        std::string& decode_string(std::uint32_t id);
 
     public:
         /// @brief Constructor of string class
@@ -56,20 +93,17 @@ namespace DEX
         /// @param strings_offset offset where to read the strings
         /// @param number_of_strings number of strings to read
         /// @param stream stream with file
+        /// @param trusted the table was validated, read it without checks
         void parse_strings(std::uint32_t strings_offset, 
             std::uint32_t number_of_strings, 
-            stream::KunaiStream* stream);
+            stream::KunaiStream* stream,
+            bool trusted = false);
 
-        const ordered_strings_t& get_ordered_strings() const
+        /// @brief Return the offsets of the strings as constant
+        /// @return offsets of the strings by id
+        const strings_offsets_t& get_strings_offsets() const
         {
-            return ordered_strings;
-        }
-
-        /// @brief Return the offset strings map as constant
-        /// @return offset-strings map
-        const offset_string_t& get_offset_strings() const
-        {
-            return offset_strings;
+            return strings_offsets;
         }
 
         /// @brief Return a pointer to an string giving an offset
@@ -77,10 +111,44 @@ namespace DEX
         /// @return pointer to string in the offset
         std::string* get_string_from_offset(std::uint32_t offset);
 
-        /// @brief Get reference to string by a given id
+        /// @brief Get reference to string by a given id, the string
+        /// is decoded the first time is accessed
         /// @param id id commonly refers to position
         /// @return reference to string
         std::string& get_string_by_id(std::uint32_t id);
+
+        /// @brief Get a string by a given id without throwing exceptions
+        /// @param id id commonly refers to position
+        /// @return pointer to string, nullptr if the id or the string
+        /// are not correct
+        std::string* try_get_string_by_id(std::uint32_t id);
+
+        /// @brief Get reference to string by a given id without checking
+        /// the id, only for ids that were validated before
+        /// @param id id of the string
+        /// @return reference to string
+        std::string& get_string_by_id_unchecked(std::uint32_t id)
+        {
+            return decode_string(id);
+        }
+
+        /// @brief Get a view of a string by a given id, in case the
+        /// stream is backed by memory and the string is ASCII the view
+        /// points to the data of the file and nothing is allocated
+        /// @param id id commonly refers to position
+        /// @return view of the string
+        std::string_view get_string_view_by_id(std::uint32_t id);
+
+        /// @brief Decode all the strings from the string_data section
+        /// that have not been decoded yet
+        void decode_all_strings();
+
+        /// @brief Check that all the strings are inside of the file and
+        /// that they are correct MUTF-8, the strings are not stored so they
+        /// are still decoded the first time they are accessed
+        /// @param incorrect_id id of the first incorrect string
+        /// @return true if all the strings are correct
+        bool validate_strings(std::uint32_t& incorrect_id);
         
         /// @brief Get the number of the strings stored.
         /// @return uint32_t with number of strings
@@ -93,7 +161,7 @@ namespace DEX
         /// @param os stream where to print to
         /// @param entry entry with the strings
         /// @return 
-        friend std::ostream& operator<<(std::ostream& os, const Strings& entry);
+        friend std::ostream& operator<<(std::ostream& os, Strings& entry);
 
         /// @brief Dump the Strings to an XML
         /// @param fos xml where to dump
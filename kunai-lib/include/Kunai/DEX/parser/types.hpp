@@ -14,6 +14,7 @@
 
 #include <vector>
 #include <unordered_map>
+#include <string_view>
 #include <memory>
 
 namespace KUNAI
@@ -21,7 +22,10 @@ namespace KUNAI
 namespace DEX
 {
     /// @brief Represents the base class of a Type in the DVM
-    /// we have different types
+    /// we have different types. The types are interned, there is
+    /// only one object for each type in a DEX file (the fundamental
+    /// types are shared by all the files), so two types can be
+    /// compared by their pointers.
     class DVMType
     {
     public:
@@ -67,6 +71,13 @@ namespace DEX
             return raw_type;
         }
 
+        /// @brief get a view of the raw string from the type object
+        /// @return view of the string from the type
+        std::string_view get_raw_view() const
+        {
+            return raw_type;
+        }
+
         /// @brief Pretty print the name of the type
         /// @return pretty print version of the name
         virtual const std::string& pretty_print()
@@ -102,7 +113,7 @@ namespace DEX
         /// @brief fundamental in string format
         std::string name;
 
-        const std::unordered_map<fundamental_e, std::string> fundamental_s =
+        inline static const std::unordered_map<fundamental_e, std::string> fundamental_s =
         {
             {BOOLEAN, "boolean"},
             {BYTE, "byte"},
@@ -125,6 +136,12 @@ namespace DEX
         /// @brief Destructor of the fundamental
         ~DVMFundamental() = default;
 
+        /// @brief Get the shared instance of a fundamental type, the
+        /// same object is used by all the DEX files
+        /// @param f_type enum of the fundamental type
+        /// @return pointer to the fundamental type
+        static DVMFundamental* get_fundamental(fundamental_e f_type);
+
         /// @brief get the type of the object
         /// @return return FUNDAMENTAL type
         type_e get_type() const override
@@ -174,15 +191,14 @@ namespace DEX
     {
         /// @brief name of the class
         std::string name;
-        /// @brief Name printed with pretty_print
+        /// @brief Name printed with pretty_print, it is created in
+        /// the constructor so it can be printed from different threads
         std::string pretty_name;
 
     public:
         /// @brief constructor of DVM class with the name of the class
         /// @param name name of the class
-        DVMClass(std::string name) :
-            DVMType(CLASS, name), name(name)
-        {}
+        DVMClass(std::string name);
 
         /// @brief default destructor of DVMClass
         ~DVMClass() = default;
@@ -215,7 +231,12 @@ namespace DEX
             return name;
         }
 
-        const std::string& pretty_print() override;
+        /// @brief Get a pretty printed version of the name
+        /// @return pretty printed name
+        const std::string& pretty_print() override
+        {
+            return pretty_name;
+        }
     };
 
     /// @brief Class that represent the array types
@@ -225,18 +246,17 @@ namespace DEX
         /// @brief depth of the array, it is possible to
         /// create arrays with different depth like [[C
         size_t depth;
-        /// @brief type of the array
-        dvmtype_t array_type;
-        /// @brief pretty name of array
+        /// @brief type of the array, it points to the interned type
+        DVMType* array_type;
+        /// @brief pretty name of array, it is created in the
+        /// constructor so it can be printed from different threads
         std::string pretty_name;
     public:
         /// @brief Constructor of DVMArray
         /// @param raw array type in raw
         /// @param depth how many depth the array contains
-        /// @param array type of the array as a std::unique_ptr
-        DVMArray(std::string raw, size_t depth, dvmtype_t& array) :
-            DVMType(ARRAY, raw), depth(depth), array_type(std::move(array))
-        {}
+        /// @param array interned type of the elements of the array
+        DVMArray(std::string raw, size_t depth, DVMType* array);
 
         /// @brief Destructor of DVMArray
         ~DVMArray() = default;
@@ -259,7 +279,7 @@ namespace DEX
         /// @return type of the array
         const DVMType* get_array_type() const
         {
-            return array_type.get();
+            return array_type;
         }
 
         /// @brief Get the depth of the array specified as [[
@@ -269,7 +289,12 @@ namespace DEX
             return depth;
         }
 
-        const std::string& pretty_print() override;
+        /// @brief Get a pretty printed version of the name
+        /// @return pretty printed name
+        const std::string& pretty_print() override
+        {
+            return pretty_name;
+        }
     };
 
     /// @brief In case something unknown is found, we categorize it
@@ -303,14 +328,21 @@ namespace DEX
 
     class Types
     {
+        /// @brief types created for this file (classes, arrays and unknown),
+        /// the fundamental types are shared and not stored here
+        std::vector<dvmtype_t> owned_types;
+        /// @brief interned types by their raw name, the keys point
+        /// to the raw name stored in the type
+        std::unordered_map<std::string_view, DVMType*> interned_types;
         /// @brief types in the order they are parsed
-        std::vector<dvmtype_t> ordered_types;
-        /// @brief types by the id of the type
-        std::unordered_map<std::uint32_t, DVMType*> types_by_id;
+        std::vector<DVMType*> ordered_types;
+        /// @brief types by the id of their string, sorted by the id
+        /// (the DEX format already sorts the type_ids in this way)
+        std::vector<std::pair<std::uint32_t, DVMType*>> types_by_id;
         //! @brief number of types according to header
-        std::uint32_t number_of_types;
+        std::uint32_t number_of_types = 0;
         //! @brief The offset where the types are
-        std::uint32_t offset;
+        std::uint32_t offset = 0;
     public:
         /// @brief Constructor of the Types object, nothing for initialization
         Types() = default;
@@ -322,23 +354,25 @@ namespace DEX
         /// @param strings strings to retrieve the type
         /// @param number_of_types number of types to retrieve
         /// @param types_offset offset where to read the types
+        /// @param trusted the table was validated, read it without checks
         void parse_types(
             stream::KunaiStream* stream,
             Strings* strings,
             std::uint32_t number_of_types,
-            std::uint32_t types_offset
+            std::uint32_t types_offset,
+            bool trusted = false
         );
 
         /// @brief Get a reference to the vector with all the types
         /// @return constant reference to vector
-        const std::vector<dvmtype_t>& get_ordered_types() const
+        const std::vector<DVMType*>& get_ordered_types() const
         {
             return ordered_types;
         }
 
-        /// @brief Get the types with the map of string id - type
-        /// @return constant reference to map
-        const std::unordered_map<std::uint32_t, DVMType*>& get_types_by_id() const
+        /// @brief Get the types with their string id, sorted by the id
+        /// @return constant reference to vector of string id - type
+        const std::vector<std::pair<std::uint32_t, DVMType*>>& get_types_by_id() const
         {
             return types_by_id;
         }
@@ -348,11 +382,40 @@ namespace DEX
         /// @return pointer to the type
         DVMType* get_type_by_id(std::uint32_t type_id);
 
+        /// @brief Get a type given its string ID without throwing exceptions
+        /// @param type_id ID of the type
+        /// @return pointer to the type or nullptr if the ID is not correct
+        DVMType* try_get_type_by_id(std::uint32_t type_id) const;
+
         /// @brief Get a type given position
         /// @param pos position of the Type
         /// @return pointer to the type
         DVMType* get_type_from_order(std::uint32_t pos);
 
+        /// @brief Get a type given position without throwing exceptions
+        /// @param pos position of the Type
+        /// @return pointer to the type or nullptr if the position is not correct
+        DVMType* try_get_type_from_order(std::uint32_t pos) const
+        {
+            if (pos >= ordered_types.size())
+                return nullptr;
+            return ordered_types[pos];
+        }
+
+        /// @brief Get a type given position without checking it, only
+        /// for positions that were validated before
+        /// @param pos position of the Type
+        /// @return pointer to the type
+        DVMType* get_type_from_order_unchecked(std::uint32_t pos) const
+        {
+            return ordered_types[pos];
+        }
+
+        /// @brief Get the interned type with the given raw name
+        /// @param name raw name of the type (e.g. Ljava/lang/String;)
+        /// @return pointer to the type, nullptr if there is no type with that name
+        DVMType* get_type_by_name(std::string_view name) const;
+
         /// @brief Get the number of types stored
         /// @return number of types
         std::uint32_t get_number_of_types() const
@@ -378,10 +441,11 @@ namespace DEX
         void to_xml(std::ofstream& xml_file);
     private:
         /// @brief Parse the given name in order to find what
-        /// DEX type is
+        /// DEX type is, if the type was already parsed the same
+        /// object is returned
         /// @param name type from DEX
-        /// @return object with the type
-        dvmtype_t parse_type(std::string& name);
+        /// @return interned object with the type
+        DVMType* parse_type(std::string_view name);
     };
 } // namespace DEX
 } // namespace KUNAI
@@ -0,0 +1,154 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file arena.hpp
+// @brief Monotonic allocator for the objects created by the parser, the
+// objects are allocated one after the other in big blocks and the memory
+// is released at once when the arena is destroyed. The objects are still
+// owned one by one, so the destructors of the objects that are not trivially
+// destructible (strings, vectors...) run one at a time before the release.
+#ifndef KUNAI_UTILS_ARENA_HPP
+#define KUNAI_UTILS_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace KUNAI
+{
+    namespace utils
+    {
+        /// @brief Deleter for the objects allocated in an Arena, it only
+        /// calls the destructor, the memory belongs to the arena. Nothing
+        /// is done for the trivially destructible types.
+        template <typename T>
+        struct arena_deleter
+        {
+            void operator()(T *ptr) const noexcept
+            {
+                if constexpr (!std::is_trivially_destructible_v<T>)
+                    ptr->~T();
+            }
+        };
+
+        /// @brief Owner of an object allocated in an Arena, the arena
+        /// must live longer than the pointer
+        template <typename T>
+        using arena_ptr = std::unique_ptr<T, arena_deleter<T>>;
+
+        /// @brief Bump allocator, memory is taken from blocks and it is
+        /// never given back until the arena is destroyed. The allocation
+        /// is thread safe so different threads of the parser can share it,
+        /// each thread takes small chunks of the blocks and allocates from
+        /// its chunk without locking the arena.
+        class Arena
+        {
+        public:
+            /// @brief default size of each block of the arena
+            static constexpr std::size_t default_block_size = 64 * 1024;
+
+            /// @brief size of the chunks taken by each thread
+            static constexpr std::size_t chunk_size = 4 * 1024;
+
+        private:
+            /// @brief chunk of an arena used by the current thread
+            struct thread_chunk_t
+            {
+                std::uint64_t arena_id = 0; //! arena of the chunk, 0 for none
+                std::byte *current = nullptr; //! next free byte of the chunk
+                std::size_t remaining = 0; //! free bytes in the chunk
+            };
+
+            /// @brief chunk of the current thread, it belongs to the last
+            /// arena used by the thread
+            static thread_local thread_chunk_t thread_chunk;
+
+            /// @brief counter to give a different id to each arena, so
+            /// a chunk is never used after its arena is destroyed
+            static std::atomic<std::uint64_t> next_arena_id;
+
+            /// @brief id of the arena
+            std::uint64_t arena_id;
+
+            /// @brief blocks of memory of the arena
+            std::vector<std::unique_ptr<std::byte[]>> blocks;
+
+            /// @brief next free byte of the current block
+            std::byte *current = nullptr;
+
+            /// @brief free bytes in the current block
+            std::size_t remaining = 0;
+
+            /// @brief size used for new blocks
+            std::size_t block_size;
+
+            /// @brief bytes given by the arena
+            std::atomic<std::size_t> allocated_size = 0;
+
+            /// @brief mutex for the blocks, only taken to give
+            /// a chunk to a thread or for big objects
+            std::mutex arena_mutex;
+
+            /// @brief Allocate memory from the blocks of the arena,
+            /// the mutex must be taken
+            /// @param size size of the memory
+            /// @param alignment alignment of the memory, power of two
+            /// @return pointer to the memory
+            void *allocate_from_blocks(std::size_t size, std::size_t alignment);
+
+        public:
+            /// @brief Constructor of the arena, no memory is allocated
+            /// until the first object is created
+            /// @param block_size size of the blocks of memory
+            Arena(std::size_t block_size = default_block_size)
+                : arena_id(++next_arena_id), block_size(block_size)
+            {
+            }
+
+            Arena(const Arena &) = delete;
+            Arena &operator=(const Arena &) = delete;
+
+            /// @brief Allocate memory from the arena
+            /// @param size size of the memory
+            /// @param alignment alignment of the memory, power of two
+            /// @return pointer to the memory
+            void *allocate(std::size_t size, std::size_t alignment);
+
+            /// @brief Create an object in the arena
+            /// @tparam T type of the object
+            /// @tparam Args types of the arguments of the constructor
+            /// @param args arguments for the constructor
+            /// @return owner of the object, it only calls the destructor
+            template <typename T, typename... Args>
+            arena_ptr<T> make(Args &&...args)
+            {
+                void *memory = allocate(sizeof(T), alignof(T));
+                return arena_ptr<T>(new (memory) T(std::forward<Args>(args)...));
+            }
+
+            /// @brief Get the number of bytes given by the arena
+            /// @return bytes allocated
+            std::size_t get_allocated_size() const
+            {
+                return allocated_size.load(std::memory_order_relaxed);
+            }
+
+            /// @brief Get the number of blocks reserved by the arena
+            /// @return number of blocks
+            std::size_t get_number_of_blocks()
+            {
+                std::lock_guard<std::mutex> lock(arena_mutex);
+                return blocks.size();
+            }
+        };
+    } // namespace utils
+} // namespace KUNAI
+
+#endif // KUNAI_UTILS_ARENA_HPP
@@ -0,0 +1,80 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file checksum.hpp
+// @brief Checksums used by the DEX header: Adler-32 for the checksum
+// field (with an AVX2 version selected at runtime) and SHA-1 for the
+// signature field.
+#ifndef KUNAI_UTILS_CHECKSUM_HPP
+#define KUNAI_UTILS_CHECKSUM_HPP
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace KUNAI
+{
+    namespace utils
+    {
+        /// @brief Compute the Adler-32 checksum of a buffer
+        /// @param data buffer with the data
+        /// @param adler previous value of the checksum, to compute
+        /// it in different steps
+        /// @return checksum of the data
+        std::uint32_t adler32(std::span<const std::uint8_t> data, std::uint32_t adler = 1);
+
+        /// @brief Streaming SHA-1, the data can be given in different
+        /// calls to update
+        class Sha1
+        {
+        public:
+            /// @brief size of the digest in bytes
+            static constexpr std::size_t digest_size = 20;
+
+            using digest_t = std::array<std::uint8_t, digest_size>;
+
+        private:
+            /// @brief current state of the hash
+            std::uint32_t state[5];
+
+            /// @brief bytes waiting to complete a block
+            std::uint8_t block[64];
+
+            /// @brief number of bytes in block
+            std::size_t block_size = 0;
+
+            /// @brief total number of bytes processed
+            std::uint64_t total_size = 0;
+
+            /// @brief process a complete block of 64 bytes
+            /// @param data block to process
+            void process_block(const std::uint8_t *data);
+
+        public:
+            /// @brief Constructor, initializes the state of the hash
+            Sha1();
+
+            /// @brief Add data to the hash
+            /// @param data data to add
+            void update(std::span<const std::uint8_t> data);
+
+            /// @brief Finish the hash, the object must not be
+            /// updated after this call
+            /// @return digest of all the data
+            digest_t finish();
+
+            /// @brief Compute the SHA-1 of a buffer
+            /// @param data buffer with the data
+            /// @return digest of the data
+            static digest_t digest(std::span<const std::uint8_t> data)
+            {
+                Sha1 sha1;
+                sha1.update(data);
+                return sha1.finish();
+            }
+        };
+    } // namespace utils
+} // namespace KUNAI
+
+#endif // KUNAI_UTILS_CHECKSUM_HPP
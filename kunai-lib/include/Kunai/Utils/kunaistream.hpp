@@ -8,7 +8,10 @@
 #ifndef KUNAI_UTILS_KUNAISTREAM_HPP
 #define KUNAI_UTILS_KUNAISTREAM_HPP
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <span>
 #include "Kunai/Exceptions/stream_exception.hpp"
 
 namespace KUNAI
@@ -16,10 +19,21 @@ namespace KUNAI
     namespace stream
     {
         /// @brief Class to manage an input file stream given for the analysis.
+        /// The stream can read from an std::ifstream or from a buffer in memory
+        /// (e.g. a memory mapped file), in the second case the data is read
+        /// directly from the buffer without any copy into intermediate buffers.
         class KunaiStream
         {
-            /// @brief Input file to read from
-            std::ifstream& input_file;
+            /// @brief Input file to read from, nullptr if the stream
+            /// reads from a memory buffer
+            std::ifstream* input_file = nullptr;
+
+            /// @brief Buffer in memory to read from, this buffer
+            /// is not owned by the stream
+            std::span<const std::uint8_t> buffer;
+
+            /// @brief Current position in the memory buffer
+            std::size_t cursor = 0;
             
             /// @brief Size of the file
             std::size_t file_size;
@@ -33,13 +47,20 @@ namespace KUNAI
 
             /// @brief Constructor from KunaiStream class.
             /// @param input_file file for the analysis this must be an std::ifstream
-            KunaiStream(std::ifstream& input_file) : input_file(input_file)
+            KunaiStream(std::ifstream& input_file) : input_file(&input_file)
             {
                 if (!input_file.is_open())
                     throw exceptions::StreamException("KunaiStream: error input_file not open");
                 initialize();
             }
 
+            /// @brief Constructor from KunaiStream class for a buffer in memory,
+            /// the buffer must live as long as the stream.
+            /// @param buffer bytes of the file for the analysis
+            KunaiStream(std::span<const std::uint8_t> buffer) : buffer(buffer), file_size(buffer.size())
+            {
+            }
+
             /// @brief Destructor from KunaiStream, nothing done here
             /// for the moment
             ~KunaiStream() = default;
@@ -51,6 +72,21 @@ namespace KUNAI
                 return file_size;
             }
 
+            /// @brief Check if the stream reads from a buffer in memory
+            /// @return true if the stream is backed by memory
+            bool is_memory_backed() const
+            {
+                return input_file == nullptr;
+            }
+
+            /// @brief Get the buffer in memory the stream reads from, the
+            /// span is empty if the stream is not backed by memory
+            /// @return view of the whole file
+            std::span<const std::uint8_t> get_buffer() const
+            {
+                return buffer;
+            }
+
             /// @brief Read data given a buffer of a T data type and with
             /// a size specified by the user
             /// @tparam T type of the buffer where to read the data
@@ -61,18 +97,44 @@ namespace KUNAI
             {
                 if (read_size < 0)
                     throw exceptions::StreamException("read_data(): read_size given incorrect");
+
+                if (input_file == nullptr)
+                {
+                    if (static_cast<std::size_t>(read_size) > file_size - cursor)
+                        throw exceptions::StreamException("read_data(): error reading input file");
+                    std::memcpy(&buffer, this->buffer.data() + cursor, read_size);
+                    cursor += read_size;
+                    return;
+                }
+
                 // read the data
-                input_file.read(reinterpret_cast<char*>(&buffer), read_size);
+                input_file->read(reinterpret_cast<char*>(&buffer), read_size);
 
-                if(!input_file)
+                if(!(*input_file))
                     throw exceptions::StreamException("read_data(): error reading input file");
             }
 
+            /// @brief Read a value from the buffer in memory without any check
+            /// and without moving the cursor, only for data that was validated
+            /// before and for streams backed by memory
+            /// @tparam T type of the value
+            /// @param offset offset of the value in the buffer
+            /// @return value read
+            template <typename T>
+            T read_unchecked(std::size_t offset) const
+            {
+                T value;
+                std::memcpy(&value, buffer.data() + offset, sizeof(T));
+                return value;
+            }
+
             /// @brief Obtain the current pointer of the file
             /// @return position of file
             std::streampos tellg() const
             {
-                return input_file.tellg();
+                if (input_file == nullptr)
+                    return static_cast<std::streamoff>(cursor);
+                return input_file->tellg();
             }
 
             /// @brief Move the pointer from the input file
@@ -80,9 +142,26 @@ namespace KUNAI
             /// @param dir directorion to move
             void seekg(std::streamoff off, std::ios_base::seekdir dir)
             {
-                if (off >= file_size)
+                if (off >= static_cast<std::streamoff>(file_size))
                     throw exceptions::StreamException("seekg(): offset provided is out of bound");
-                input_file.seekg(off, dir);
+
+                if (input_file != nullptr)
+                {
+                    input_file->seekg(off, dir);
+                    return;
+                }
+
+                std::streamoff new_cursor = off;
+
+                if (dir == std::ios_base::cur)
+                    new_cursor += static_cast<std::streamoff>(cursor);
+                else if (dir == std::ios_base::end)
+                    new_cursor += static_cast<std::streamoff>(file_size);
+
+                if (new_cursor < 0 || new_cursor > static_cast<std::streamoff>(file_size))
+                    throw exceptions::StreamException("seekg(): offset provided is out of bound");
+
+                cursor = static_cast<std::size_t>(new_cursor);
             }
 
             /// @brief Read a string as an array of char finished in a 0 byte
@@ -91,9 +170,11 @@ namespace KUNAI
             std::string read_ansii_string(std::int64_t offset);
 
             /// @brief Read a DEX string, the dex string contains the next format:
-            /// <size in uleb128><string with size>
+            /// <size in uleb128><MUTF-8 string finished in 0>, the string is
+            /// validated and decoded to UTF-8.
             /// @param offset the offset in the file where to read the string
             /// @return string read
+            /// @throw exceptions::StreamException if the string is not correct
             std::string read_dex_string(std::int64_t offset);
 
             /// @brief Read a number in uleb128 format.
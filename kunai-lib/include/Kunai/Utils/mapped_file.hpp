@@ -0,0 +1,68 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file mapped_file.hpp
+// @brief Read-only memory mapping of a file, the mapping is used as
+// backend for a KunaiStream so the parser can read the file without
+// copying it into intermediate buffers.
+#ifndef KUNAI_UTILS_MAPPED_FILE_HPP
+#define KUNAI_UTILS_MAPPED_FILE_HPP
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace KUNAI
+{
+    namespace stream
+    {
+        /// @brief Read-only view of a whole file in memory. In POSIX
+        /// systems the file is mapped with mmap, in other systems the
+        /// file is read into an owned buffer.
+        class MappedFile
+        {
+            /// @brief address where the file is mapped
+            void *mapped_address = nullptr;
+
+            /// @brief size of the mapped file
+            std::size_t mapped_size = 0;
+
+            /// @brief buffer used when memory mapping is not available
+            std::vector<std::uint8_t> fallback_buffer;
+
+        public:
+            /// @brief Map a file in memory, the file is mapped read-only
+            /// and the kernel is advised that the pages will be needed.
+            /// @param file_path path to the file to map
+            /// @throw exceptions::StreamException in case the file cannot
+            /// be opened or mapped
+            MappedFile(const std::string &file_path);
+
+            /// @brief Unmap the file
+            ~MappedFile();
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            /// @brief Get the size of the mapped file
+            /// @return size of the file
+            std::size_t get_size() const
+            {
+                return mapped_size;
+            }
+
+            /// @brief Get a view of the whole file
+            /// @return span with the bytes of the file
+            std::span<const std::uint8_t> get_span() const
+            {
+                if (mapped_address == nullptr)
+                    return {fallback_buffer.data(), fallback_buffer.size()};
+                return {reinterpret_cast<const std::uint8_t *>(mapped_address), mapped_size};
+            }
+        };
+    } // namespace stream
+} // namespace KUNAI
+
+#endif // KUNAI_UTILS_MAPPED_FILE_HPP
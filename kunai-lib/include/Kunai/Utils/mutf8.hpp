@@ -0,0 +1,58 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file mutf8.hpp
+// @brief Decoding and validation of MUTF-8 strings, the encoding used
+// by the string_data_item of the DEX files. ASCII runs are scanned with
+// SSE2/AVX2 when the CPU supports them.
+#ifndef KUNAI_UTILS_MUTF8_HPP
+#define KUNAI_UTILS_MUTF8_HPP
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace KUNAI
+{
+    namespace stream
+    {
+        namespace mutf8
+        {
+            /// @brief Get the length of the run of ASCII characters at the
+            /// beginning of the buffer, the run finishes in the first byte
+            /// that is 0 or that has the high bit set.
+            /// @param data buffer to scan
+            /// @param size size of the buffer
+            /// @return number of ASCII bytes different to 0
+            std::size_t ascii_length(const std::uint8_t *data, std::size_t size);
+
+            /// @brief Decode a MUTF-8 string finished in a 0 byte into UTF-8,
+            /// the surrogate pairs are joined into a four byte sequence and
+            /// the encoded null (0xC0 0x80) is decoded as a 0 byte.
+            /// @param input buffer that starts with the string, the terminator
+            /// must be in the buffer
+            /// @param utf16_size expected size of the string in UTF-16 code units
+            /// @param output string where to write the decoded string
+            /// @return number of bytes read from input (without the terminator),
+            /// or -1 if the string is not correctly encoded, its size is not
+            /// utf16_size or it is not finished in a 0 byte
+            std::int64_t decode_to_utf8(std::span<const std::uint8_t> input,
+                                        std::uint64_t utf16_size,
+                                        std::string &output);
+
+            /// @brief Decode a MUTF-8 string finished in a 0 byte into UTF-16.
+            /// @param input buffer that starts with the string, the terminator
+            /// must be in the buffer
+            /// @param utf16_size expected size of the string in UTF-16 code units
+            /// @param output string where to write the decoded string
+            /// @return number of bytes read from input (without the terminator),
+            /// or -1 in case of error
+            std::int64_t decode_to_utf16(std::span<const std::uint8_t> input,
+                                         std::uint64_t utf16_size,
+                                         std::u16string &output);
+        } // namespace mutf8
+    }     // namespace stream
+} // namespace KUNAI
+
+#endif // KUNAI_UTILS_MUTF8_HPP
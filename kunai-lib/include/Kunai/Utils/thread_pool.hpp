@@ -0,0 +1,154 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file thread_pool.hpp
+// @brief Simple pool of worker threads used to run independent tasks
+// of the parsing and analysis in parallel.
+#ifndef KUNAI_UTILS_THREAD_POOL_HPP
+#define KUNAI_UTILS_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace KUNAI
+{
+    namespace utils
+    {
+        /// @brief Pool with a fixed number of threads, tasks are submitted
+        /// to a queue and their result is obtained through an std::future.
+        class ThreadPool
+        {
+            /// @brief threads of the pool
+            std::vector<std::thread> workers;
+
+            /// @brief tasks waiting for a thread
+            std::queue<std::function<void()>> tasks;
+
+            /// @brief mutex for the queue of tasks
+            std::mutex tasks_mutex;
+
+            /// @brief used to wake up the threads
+            std::condition_variable tasks_condition;
+
+            /// @brief is the pool being destroyed?
+            bool stopping = false;
+
+            /// @brief loop executed by each one of the threads
+            void worker_loop()
+            {
+                while (true)
+                {
+                    std::function<void()> task;
+
+                    {
+                        std::unique_lock<std::mutex> lock(tasks_mutex);
+                        tasks_condition.wait(lock, [this]
+                                             { return stopping || !tasks.empty(); });
+
+                        if (stopping && tasks.empty())
+                            return;
+
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                    }
+
+                    task();
+                }
+            }
+
+        public:
+            /// @brief Get the number of threads to use by default
+            /// @return number of hardware threads, at least 1
+            static std::uint32_t default_number_of_threads()
+            {
+                auto threads = std::thread::hardware_concurrency();
+                return threads == 0 ? 1 : threads;
+            }
+
+            /// @brief Constructor of the pool
+            /// @param number_of_threads threads to create, 0 to use
+            /// the number of hardware threads
+            ThreadPool(std::uint32_t number_of_threads = 0)
+            {
+                if (number_of_threads == 0)
+                    number_of_threads = default_number_of_threads();
+
+                workers.reserve(number_of_threads);
+
+                for (std::uint32_t I = 0; I < number_of_threads; ++I)
+                    workers.emplace_back(&ThreadPool::worker_loop, this);
+            }
+
+            /// @brief Destructor of the pool, the pending tasks are
+            /// executed before the threads finish
+            ~ThreadPool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(tasks_mutex);
+                    stopping = true;
+                }
+
+                tasks_condition.notify_all();
+
+                for (auto &worker : workers)
+                    worker.join();
+            }
+
+            ThreadPool(const ThreadPool &) = delete;
+            ThreadPool &operator=(const ThreadPool &) = delete;
+
+            /// @brief Get the number of threads of the pool
+            /// @return number of threads
+            std::size_t get_number_of_threads() const
+            {
+                return workers.size();
+            }
+
+            /// @brief Submit a task to the pool
+            /// @tparam F type of the callable
+            /// @param task callable to execute in one of the threads
+            /// @return future with the result of the task, the exceptions
+            /// thrown by the task are rethrown by the future
+            template <typename F>
+            std::future<std::invoke_result_t<F>> submit(F &&task)
+            {
+                using result_t = std::invoke_result_t<F>;
+
+                auto packaged = std::make_shared<std::packaged_task<result_t()>>(std::forward<F>(task));
+                auto future = packaged->get_future();
+
+                {
+                    std::lock_guard<std::mutex> lock(tasks_mutex);
+                    tasks.emplace([packaged]
+                                  { (*packaged)(); });
+                }
+
+                tasks_condition.notify_one();
+
+                return future;
+            }
+
+            /// @brief Wait for all the given futures, and once all of
+            /// them have finished, rethrow the first exception found
+            /// @param futures futures to wait for
+            static void wait_all(std::vector<std::future<void>> &futures)
+            {
+                for (auto &future : futures)
+                    future.wait();
+
+                for (auto &future : futures)
+                    future.get();
+            }
+        };
+    } // namespace utils
+} // namespace KUNAI
+
+#endif // KUNAI_UTILS_THREAD_POOL_HPP
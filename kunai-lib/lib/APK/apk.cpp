@@ -0,0 +1,181 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file apk.cpp
+
+#include "Kunai/APK/apk.hpp"
+#include "Kunai/Exceptions/apkunzip_exception.hpp"
+#include "Kunai/Utils/logger.hpp"
+#include "Kunai/Utils/thread_pool.hpp"
+
+#include <zip.h>
+
+#include <regex>
+
+using namespace KUNAI::APK;
+
+namespace
+{
+    /// @brief entry of the ZIP with a DEX file
+    struct dex_entry_t
+    {
+        std::size_t index;  //! index of the entry in the central directory
+        std::string name;   //! name of the entry
+        std::uint64_t size; //! size of the inflated entry
+    };
+
+    /// @brief Owner of a ZIP opened from memory
+    class ZipReader
+    {
+        struct zip_t *zip;
+
+    public:
+        /// @brief Open a ZIP in memory for reading, the buffer is not copied
+        /// @param buffer bytes of the ZIP file
+        ZipReader(std::span<const std::uint8_t> buffer)
+            : zip(zip_stream_open(reinterpret_cast<const char *>(buffer.data()), buffer.size(), 0, 'r'))
+        {
+            if (zip == nullptr)
+                throw exceptions::ApkUnzipException("apk.cpp: the file is not a correct zip file");
+        }
+
+        ~ZipReader()
+        {
+            zip_stream_close(zip);
+        }
+
+        ZipReader(const ZipReader &) = delete;
+        ZipReader &operator=(const ZipReader &) = delete;
+
+        struct zip_t *get()
+        {
+            return zip;
+        }
+    };
+
+    /// @brief Inflate an entry of the ZIP into a buffer in memory
+    /// @param buffer bytes of the ZIP file
+    /// @param entry entry to inflate
+    /// @return bytes of the entry
+    std::vector<std::uint8_t> inflate_entry(std::span<const std::uint8_t> buffer, const dex_entry_t &entry)
+    {
+        // each thread reads the ZIP with its own handler
+        ZipReader reader(buffer);
+        std::vector<std::uint8_t> dex_bytes(entry.size);
+
+        auto error = zip_entry_openbyindex(reader.get(), entry.index);
+
+        if (error < 0)
+            throw exceptions::ApkUnzipException("apk.cpp: error opening " + entry.name + ": " + zip_strerror(error));
+
+        auto read_size = zip_entry_noallocread(reader.get(), dex_bytes.data(), dex_bytes.size());
+
+        zip_entry_close(reader.get());
+
+        if (read_size < 0 || static_cast<std::uint64_t>(read_size) != entry.size)
+            throw exceptions::ApkUnzipException("apk.cpp: error inflating " + entry.name);
+
+        return dex_bytes;
+    }
+} // namespace
+
+std::unique_ptr<Apk> Apk::parse_apk_file(const std::string &path_to_apk_file,
+                                         const DEX::parser_options_t &options)
+{
+    return std::make_unique<Apk>(path_to_apk_file, options);
+}
+
+void Apk::analyze_apk_file()
+{
+    auto logger = LOGGER::logger();
+    const std::regex dex_name("classes[0-9]*\\.dex");
+    std::vector<dex_entry_t> dex_entries;
+
+    try
+    {
+        mapped_file = std::make_unique<stream::MappedFile>(path_to_apk_file);
+    }
+    catch (const exceptions::StreamException &e)
+    {
+        throw exceptions::ApkUnzipException(std::string("apk.cpp: error reading the apk: ") + e.what());
+    }
+
+    auto buffer = mapped_file->get_span();
+
+    // the central directory is read once to find the DEX files
+    {
+        ZipReader reader(buffer);
+        auto number_of_entries = zip_entries_total(reader.get());
+
+        if (number_of_entries < 0)
+            throw exceptions::ApkUnzipException("apk.cpp: error reading the central directory");
+
+        for (std::size_t I = 0; I < static_cast<std::size_t>(number_of_entries); ++I)
+        {
+            if (zip_entry_openbyindex(reader.get(), I) < 0)
+                continue;
+
+            std::string name = zip_entry_name(reader.get());
+            auto size = zip_entry_size(reader.get());
+
+            // the size comes from the ZIP, do not trust it for the allocation
+            if (std::regex_match(name, dex_name))
+            {
+                if (size > parser_options.limits.max_dex_size)
+                    logger->error("apk.cpp: {} over the size limit ({} bytes)", name, size);
+                else
+                    dex_entries.push_back({I, name, size});
+            }
+
+            zip_entry_close(reader.get());
+        }
+    }
+
+    logger->debug("apk.cpp: found {} dex files in {}", dex_entries.size(), path_to_apk_file);
+
+    // each DEX file is inflated and parsed in its own task
+    utils::ThreadPool pool(parser_options.number_of_threads);
+    std::vector<std::future<std::unique_ptr<DEX::Dex>>> futures;
+
+    for (const auto &entry : dex_entries)
+        futures.push_back(pool.submit([&, entry]()
+        {
+            return DEX::Dex::parse_dex_buffer(inflate_entry(buffer, entry), parser_options);
+        }));
+
+    for (size_t I = 0; I < dex_entries.size(); ++I)
+    {
+        auto dex = futures[I].get();
+
+        if (!dex->get_parsing_correct())
+            logger->error("apk.cpp: error parsing {}", dex_entries[I].name);
+
+        dex_files[dex_entries[I].name] = std::move(dex);
+    }
+}
+
+KUNAI::DEX::Analysis *Apk::get_analysis(bool create_xrefs)
+{
+    if (global_analysis)
+        return global_analysis.get();
+
+    std::vector<DEX::Dex *> correct_dex_files;
+
+    // the DEX files parsed without classes have no disassembler
+    for (auto &dex_file : dex_files)
+        if (dex_file.second->get_parsing_correct() && dex_file.second->get_dex_disassembler() != nullptr)
+            correct_dex_files.push_back(dex_file.second.get());
+
+    if (correct_dex_files.empty())
+        return nullptr;
+
+    global_analysis = std::make_unique<DEX::Analysis>(nullptr, nullptr, create_xrefs);
+
+    // each DEX file keeps its disassembler, the instructions
+    // resolve the ids with the parser of their own DEX file
+    for (auto dex : correct_dex_files)
+        global_analysis->add(dex->get_parser(), dex->get_dex_disassembler());
+
+    return global_analysis.get();
+}
@@ -7,6 +7,7 @@
 
 #include "Kunai/DEX/DVM/dalvik_instructions.hpp"
 #include "Kunai/Exceptions/invalidinstruction_exception.hpp"
+#include "Kunai/Exceptions/incorrectid_exception.hpp"
 
 using namespace KUNAI::DEX;
 
@@ -149,7 +150,7 @@ bool Instruction::may_throw() const
     return false;
 }
 
-Instruction10x::Instruction10x(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction10x::Instruction10x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION10X, 2)
 {
     if (op_codes[1] != 0)
@@ -158,7 +159,7 @@ Instruction10x::Instruction10x(std::vector<uint8_t> &bytecode, std::size_t index
     op = op_codes[0];
 }
 
-Instruction12x::Instruction12x(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction12x::Instruction12x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION12X, 2)
 {
     op = op_codes[0];
@@ -166,7 +167,7 @@ Instruction12x::Instruction12x(std::vector<uint8_t> &bytecode, std::size_t index
     vB = (op_codes[1] & 0xF0) >> 4;
 }
 
-Instruction11n::Instruction11n(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction11n::Instruction11n(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION11N, 2)
 {
     op = op_codes[0];
@@ -174,70 +175,70 @@ Instruction11n::Instruction11n(std::vector<uint8_t> &bytecode, std::size_t index
     nB = static_cast<std::int8_t>((op_codes[1] & 0xF0) >> 4);
 }
 
-Instruction11x::Instruction11x(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction11x::Instruction11x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION11X, 2)
 {
     op = op_codes[0];
     vAA = op_codes[1];
 }
 
-Instruction10t::Instruction10t(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction10t::Instruction10t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION10T, 2)
 {
     op = op_codes[0];
     nAA = static_cast<std::int8_t>(op_codes[1]);
 }
 
-Instruction20t::Instruction20t(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction20t::Instruction20t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION20T, 4)
 {
     if (op_codes[1] != 0)
         throw exceptions::InvalidInstructionException("Error reading Instruction20t padding must be 0", 4);
     op = op_codes[0];
-    nAAAA = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
+    nAAAA = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
 }
 
-Instruction20bc::Instruction20bc(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction20bc::Instruction20bc(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION20BC, 4)
 {
     op = op_codes[0];
     nAA = op_codes[1];
-    nBBBB = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
+    nBBBB = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
 }
 
-Instruction22x::Instruction22x(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction22x::Instruction22x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION22X, 4)
 {
     op = op_codes[0];
     vAA = op_codes[1];
-    vBBBB = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
+    vBBBB = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
 }
 
-Instruction21t::Instruction21t(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction21t::Instruction21t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION21T, 4)
 {
     op = op_codes[0];
     vAA = op_codes[1];
-    nBBBB = *(reinterpret_cast<std::int16_t *>(&op_codes[2]));
+    nBBBB = *(reinterpret_cast<const std::int16_t *>(&op_codes[2]));
 
     if (nBBBB == 0)
         throw exceptions::InvalidInstructionException("Error reading Instruction21t offset cannot be 0", 4);
 }
 
-Instruction21s::Instruction21s(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction21s::Instruction21s(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION21S, 4)
 {
     op = op_codes[0];
     vAA = op_codes[1];
-    nBBBB = *(reinterpret_cast<std::int16_t *>(&op_codes[2]));
+    nBBBB = *(reinterpret_cast<const std::int16_t *>(&op_codes[2]));
 }
 
-Instruction21h::Instruction21h(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction21h::Instruction21h(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION21H, 4)
 {
     op = op_codes[0];
     vAA = op_codes[1];
-    std::int16_t const nBBBB_aux = *(reinterpret_cast<std::int16_t *>(&op_codes[2]));
+    std::int16_t const nBBBB_aux = *(reinterpret_cast<const std::int16_t *>(&op_codes[2]));
 
     switch (op)
     {
@@ -254,26 +255,28 @@ Instruction21h::Instruction21h(std::vector<uint8_t> &bytecode, std::size_t index
     }
 }
 
-Instruction21c::Instruction21c(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction21c::Instruction21c(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION21C, 4), parser(parser)
 {
     op = op_codes[0];
     vAA = op_codes[1];
-    iBBBB = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
+    iBBBB = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
 
     /// The instruction has a kind of operation depending
-    /// on the op code, check it, and use it wisely
+    /// on the op code, check it, and use it wisely. Only
+    /// the id is checked here, the strings are created
+    /// when the instruction is printed
     switch (get_kind())
     {
     case TYPES::Kind::STRING:
         is_str = true;
-        source_str = "\"" + parser->get_strings().get_string_by_id(iBBBB) + "\"";
+        if (iBBBB >= parser->get_strings().get_number_of_strings())
+            throw exceptions::IncorrectIDException("Instruction21c: id for string incorrect");
         break;
     case TYPES::Kind::TYPE:
     {
         is_type = true;
         auto type = parser->get_types().get_type_from_order(iBBBB);
-        source_str = type->pretty_print();
         if (type->get_type() == DVMType::FUNDAMENTAL)
             is_fundamental = true;
         else if (type->get_type() == DVMType::CLASS)
@@ -286,20 +289,35 @@ Instruction21c::Instruction21c(std::vector<uint8_t> &bytecode, std::size_t index
     break;
     case TYPES::Kind::FIELD:
         is_field = true;
-        source_str = parser->get_fields().get_field(iBBBB)->pretty_field();
+        parser->get_fields().get_field(iBBBB);
         break;
     case TYPES::Kind::METH:
         is_method = true;
-        source_str = parser->get_methods().get_method(iBBBB)->pretty_method();
+        parser->get_methods().get_method(iBBBB);
         break;
     case TYPES::Kind::PROTO:
         is_proto = true;
-        source_str = parser->get_protos().get_proto_by_order(iBBBB)->get_shorty_idx();
+        parser->get_protos().get_proto_by_order(iBBBB);
         break;
     }
 }
 
-Instruction23x::Instruction23x(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+std::string Instruction21c::pretty_print_source() const
+{
+    if (is_str)
+        return "\"" + parser->get_strings().get_string_by_id(iBBBB) + "\"";
+    if (is_type)
+        return parser->get_types().get_type_from_order(iBBBB)->pretty_print();
+    if (is_field)
+        return parser->get_fields().get_field(iBBBB)->pretty_field();
+    if (is_method)
+        return parser->get_methods().get_method(iBBBB)->pretty_method();
+    if (is_proto)
+        return parser->get_protos().get_proto_by_order(iBBBB)->get_shorty_idx();
+    return "";
+}
+
+Instruction23x::Instruction23x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION23X, 4)
 {
     op = op_codes[0];
@@ -308,7 +326,7 @@ Instruction23x::Instruction23x(std::vector<uint8_t> &bytecode, std::size_t index
     vCC = op_codes[3];
 }
 
-Instruction22b::Instruction22b(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction22b::Instruction22b(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION22B, 4)
 {
     op = op_codes[0];
@@ -317,110 +335,120 @@ Instruction22b::Instruction22b(std::vector<uint8_t> &bytecode, std::size_t index
     nCC = static_cast<std::int8_t>(op_codes[3]);
 }
 
-Instruction22t::Instruction22t(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction22t::Instruction22t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION22T, 4)
 {
     op = op_codes[0];
     vA = op_codes[1] & 0x0F;
     vB = (op_codes[1] & 0xF0) >> 4;
-    nCCCC = *(reinterpret_cast<std::int16_t *>(&op_codes[2]));
+    nCCCC = *(reinterpret_cast<const std::int16_t *>(&op_codes[2]));
 
     if (nCCCC == 0)
         throw exceptions::InvalidInstructionException("Error reading Instruction22t offset cannot be 0", 4);
 }
 
-Instruction22s::Instruction22s(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction22s::Instruction22s(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION22S, 4)
 {
     op = op_codes[0];
     vA = op_codes[1] & 0x0F;
     vB = (op_codes[1] & 0xF0) >> 4;
-    nCCCC = *(reinterpret_cast<std::int16_t *>(&op_codes[2]));
+    nCCCC = *(reinterpret_cast<const std::int16_t *>(&op_codes[2]));
 }
 
-Instruction22c::Instruction22c(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction22c::Instruction22c(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION22C, 4), parser(parser)
 {
     op = op_codes[0];
     vA = op_codes[1] & 0x0F;
     vB = (op_codes[1] & 0xF0) >> 4;
-    iCCCC = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
+    iCCCC = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
 
     /// as in Instruction21c we have a type for the instruction
     switch (get_kind())
     {
     case TYPES::Kind::FIELD:
         is_field = true;
-        iCCCC_str = parser->get_fields().get_field(iCCCC)->pretty_field();
+        parser->get_fields().get_field(iCCCC);
         break;
     case TYPES::Kind::TYPE:
         is_type = true;
-        iCCCC_str = parser->get_types().get_type_from_order(iCCCC)->pretty_print();
+        parser->get_types().get_type_from_order(iCCCC);
         break;
     default:
-        iCCCC_str = std::to_string(iCCCC);
         break;
     }
 }
 
-Instruction22cs::Instruction22cs(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+std::string Instruction22c::get_checked_value_str() const
+{
+    if (is_field)
+        return parser->get_fields().get_field(iCCCC)->pretty_field();
+    if (is_type)
+        return parser->get_types().get_type_from_order(iCCCC)->pretty_print();
+    return std::to_string(iCCCC);
+}
+
+Instruction22cs::Instruction22cs(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION22CS, 4), parser(parser)
 {
     op = op_codes[0];
     vA = op_codes[1] & 0x0F;
     vB = (op_codes[1] & 0xF0) >> 4;
-    iCCCC = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
+    iCCCC = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
 
-    switch (get_kind())
+    if (get_kind() == TYPES::Kind::FIELD)
     {
-    case TYPES::Kind::FIELD:
         is_field = true;
-        iCCCC_str = parser->get_fields().get_field(iCCCC)->pretty_field();
-        break;
-    default:
-        iCCCC_str = std::to_string(iCCCC);
-        break;
+        parser->get_fields().get_field(iCCCC);
     }
 }
 
-Instruction30t::Instruction30t(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+std::string Instruction22cs::get_field_string() const
+{
+    if (is_field)
+        return parser->get_fields().get_field(iCCCC)->pretty_field();
+    return std::to_string(iCCCC);
+}
+
+Instruction30t::Instruction30t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION30T, 6)
 {
     if (op_codes[1] != 0)
         throw exceptions::InvalidInstructionException("Error reading Instruction30t padding must be 0", 6);
 
     op = op_codes[0];
-    nAAAAAAAA = *(reinterpret_cast<std::int32_t *>(&op_codes[2]));
+    nAAAAAAAA = *(reinterpret_cast<const std::int32_t *>(&op_codes[2]));
 
     if (nAAAAAAAA == 0)
         throw exceptions::InvalidInstructionException("Error reading Instruction30t offset cannot be 0", 6);
 }
 
-Instruction32x::Instruction32x(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction32x::Instruction32x(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION32X, 6)
 {
     if (op_codes[1] != 0)
         throw exceptions::InvalidInstructionException("Error reading Instruction32x padding must be 0", 6);
 
     op = op_codes[0];
-    vAAAA = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
-    vBBBB = *(reinterpret_cast<std::uint16_t *>(&op_codes[4]));
+    vAAAA = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
+    vBBBB = *(reinterpret_cast<const std::uint16_t *>(&op_codes[4]));
 }
 
-Instruction31i::Instruction31i(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction31i::Instruction31i(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION31I, 6)
 {
     op = op_codes[0];
     vAA = op_codes[1];
-    nBBBBBBBB = *(reinterpret_cast<std::uint32_t *>(&op_codes[2]));
+    nBBBBBBBB = *(reinterpret_cast<const std::uint32_t *>(&op_codes[2]));
 }
 
-Instruction31t::Instruction31t(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction31t::Instruction31t(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION31T, 6)
 {
     op = op_codes[0];
     vAA = op_codes[1];
-    nBBBBBBBB = *(reinterpret_cast<std::int32_t *>(&op_codes[2]));
+    nBBBBBBBB = *(reinterpret_cast<const std::int32_t *>(&op_codes[2]));
 
     switch (op)
     {
@@ -436,16 +464,18 @@ Instruction31t::Instruction31t(std::vector<uint8_t> &bytecode, std::size_t index
     }
 }
 
-Instruction31c::Instruction31c(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
-    : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION31C, 6)
+Instruction31c::Instruction31c(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
+    : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION31C, 6), parser(parser)
 {
     op = op_codes[0];
     vAA = op_codes[1];
-    iBBBBBBBB = *(reinterpret_cast<std::uint32_t *>(&op_codes[2]));
-    str_value = parser->get_strings().get_string_by_id(iBBBBBBBB);
+    iBBBBBBBB = *(reinterpret_cast<const std::uint32_t *>(&op_codes[2]));
+
+    if (iBBBBBBBB >= parser->get_strings().get_number_of_strings())
+        throw exceptions::IncorrectIDException("Instruction31c: id for string incorrect");
 }
 
-Instruction35c::Instruction35c(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction35c::Instruction35c(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION35C, 6), parser(parser)
 {
     /// for reading the registers
@@ -453,7 +483,7 @@ Instruction35c::Instruction35c(std::vector<uint8_t> &bytecode, std::size_t index
 
     op = op_codes[0];
     array_size = (op_codes[1] & 0xF0) >> 4;
-    type_index = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
+    type_index = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
 
     /// assign the values to the registers
     reg[4] = op_codes[1] & 0x0F;
@@ -472,26 +502,35 @@ Instruction35c::Instruction35c(std::vector<uint8_t> &bytecode, std::size_t index
     {
     case TYPES::Kind::TYPE:
         is_type = true;
-        type_str = parser->get_types().get_type_from_order(type_index)->pretty_print();
+        parser->get_types().get_type_from_order(type_index);
         break;
     case TYPES::Kind::METH:
         is_method = true;
-        type_str = parser->get_methods().get_method(type_index)->pretty_method();
+        parser->get_methods().get_method(type_index);
         break;
     /// others I don't know how to manage...
     default:
-        type_str = std::to_string(type_index);
+        break;
     }
 }
 
-Instruction3rc::Instruction3rc(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+std::string Instruction35c::get_operand_str() const
+{
+    if (is_type)
+        return parser->get_types().get_type_from_order(type_index)->pretty_print();
+    if (is_method)
+        return parser->get_methods().get_method(type_index)->pretty_method();
+    return std::to_string(type_index);
+}
+
+Instruction3rc::Instruction3rc(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION3RC, 6), parser(parser)
 {
     std::uint16_t vCCCC;
     op = op_codes[0];
     array_size = op_codes[1];
-    index = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
-    vCCCC = *(reinterpret_cast<std::uint16_t *>(&op_codes[4]));
+    this->index = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
+    vCCCC = *(reinterpret_cast<const std::uint16_t *>(&op_codes[4]));
 
     /// assign the registers starting by vCCCC
     for (std::uint16_t I = vCCCC, E = vCCCC + array_size;
@@ -504,19 +543,28 @@ Instruction3rc::Instruction3rc(std::vector<uint8_t> &bytecode, std::size_t index
     {
     case TYPES::Kind::TYPE:
         is_type = true;
-        index_str = parser->get_types().get_type_from_order(index)->pretty_print();
+        parser->get_types().get_type_from_order(this->index);
         break;
     case TYPES::Kind::METH:
         is_method = true;
-        index_str = parser->get_methods().get_method(index)->pretty_method();
+        parser->get_methods().get_method(this->index);
         break;
     /// other maybe needs to be managed
     default:
-        index_str = std::to_string(index);
+        break;
     }
 }
 
-Instruction45cc::Instruction45cc(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+std::string Instruction3rc::get_operand_str() const
+{
+    if (is_type)
+        return parser->get_types().get_type_from_order(index)->pretty_print();
+    if (is_method)
+        return parser->get_methods().get_method(index)->pretty_method();
+    return std::to_string(index);
+}
+
+Instruction45cc::Instruction45cc(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION45CC, 8)
 {
     std::uint8_t regC, regD, regE, regF, regG;
@@ -524,12 +572,12 @@ Instruction45cc::Instruction45cc(std::vector<uint8_t> &bytecode, std::size_t ind
     op = op_codes[0];
     reg_count = (op_codes[1] & 0xF0) >> 4;
     regG = op_codes[1] & 0x0F;
-    method_reference = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
+    method_reference = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
     regD = (op_codes[4] & 0xF0) >> 4;
     regC = op_codes[4] & 0x0F;
     regF = (op_codes[5] & 0xF0) >> 4;
     regE = op_codes[5] & 0x0F;
-    prototype_reference = *(reinterpret_cast<std::uint16_t *>(&op_codes[8]));
+    prototype_reference = *(reinterpret_cast<const std::uint16_t *>(&op_codes[8]));
 
     if (reg_count > 5)
         throw exceptions::InvalidInstructionException("Error in reg_count from Instruction45cc cannot be greater than 5", 8);
@@ -555,16 +603,16 @@ Instruction45cc::Instruction45cc(std::vector<uint8_t> &bytecode, std::size_t ind
     proto_id = parser->get_protos().get_proto_by_order(prototype_reference);
 }
 
-Instruction4rcc::Instruction4rcc(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction4rcc::Instruction4rcc(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION4RCC, 8)
 {
     std::uint16_t vCCCC;
 
     op = op_codes[0];
     reg_count = op_codes[1];
-    method_reference = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
-    vCCCC = *(reinterpret_cast<std::uint16_t *>(&op_codes[4]));
-    prototype_reference = *(reinterpret_cast<std::uint16_t *>(&op_codes[6]));
+    method_reference = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
+    vCCCC = *(reinterpret_cast<const std::uint16_t *>(&op_codes[4]));
+    prototype_reference = *(reinterpret_cast<const std::uint16_t *>(&op_codes[6]));
 
     if (method_reference >= parser->get_methods().get_number_of_methods())
         throw exceptions::InvalidInstructionException("Error method reference out of bound in Instruction4rcc", 8);
@@ -579,52 +627,60 @@ Instruction4rcc::Instruction4rcc(std::vector<uint8_t> &bytecode, std::size_t ind
     prototype_id = parser->get_protos().get_proto_by_order(prototype_reference);
 }
 
-Instruction51l::Instruction51l(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+Instruction51l::Instruction51l(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_INSTRUCTION51L, 10)
 {
     op = op_codes[0];
     vAA = op_codes[1];
-    nBBBBBBBBBBBBBBBB = *(reinterpret_cast<std::int64_t *>(&op_codes[2]));
+    nBBBBBBBBBBBBBBBB = *(reinterpret_cast<const std::int64_t *>(&op_codes[2]));
 }
 
-PackedSwitch::PackedSwitch(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+PackedSwitch::PackedSwitch(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_PACKEDSWITCH, 8)
 {
     std::int32_t aux;
 
-    op = *(reinterpret_cast<std::uint16_t *>(&op_codes[0]));
-    size = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
-    first_key = *(reinterpret_cast<std::int32_t *>(&op_codes[4]));
+    op = *(reinterpret_cast<const std::uint16_t *>(&op_codes[0]));
+    size = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
+    first_key = *(reinterpret_cast<const std::int32_t *>(&op_codes[4]));
 
     // because the instruction is larger, we have to
     // re-accomodate the op_codes span and the length
     // we have to increment it
     length += (size * 4);
 
+    if (index + length > bytecode.size())
+        throw exceptions::InvalidInstructionException("payload out of bytecode bounds",
+                                                      static_cast<std::uint32_t>(bytecode.size() - index));
+
     op_codes = {bytecode.begin() + index, bytecode.begin() + index + length};
 
     // now read the targets
     auto multiplier = sizeof(std::int32_t);
     for (size_t I = 0; I < size; ++I)
     {
-        aux = *(reinterpret_cast<std::int32_t *>(&op_codes[8 + (I * multiplier)]));
+        aux = *(reinterpret_cast<const std::int32_t *>(&op_codes[8 + (I * multiplier)]));
         targets.push_back(aux);
     }
 }
 
-SparseSwitch::SparseSwitch(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+SparseSwitch::SparseSwitch(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_SPARSESWITCH, 4)
 {
     std::int32_t aux_key, aux_target;
 
-    op = *(reinterpret_cast<std::uint16_t *>(&op_codes[0]));
-    size = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
+    op = *(reinterpret_cast<const std::uint16_t *>(&op_codes[0]));
+    size = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
 
     // now we have to do as before, we have to set the appropiate
     // length and also fix the span object
     // the length is the number of keys and targets multiplied by
     // the size of each one
     length += (sizeof(std::int32_t) * size) * 2;
+    if (index + length > bytecode.size())
+        throw exceptions::InvalidInstructionException("payload out of bytecode bounds",
+                                                      static_cast<std::uint32_t>(bytecode.size() - index));
+
     op_codes = {bytecode.begin() + index, bytecode.begin() + index + length};
 
     auto base_targets = 4 + sizeof(std::int32_t) * size;
@@ -632,21 +688,21 @@ SparseSwitch::SparseSwitch(std::vector<uint8_t> &bytecode, std::size_t index, Pa
 
     for (size_t I = 0; I < size; ++I)
     {
-        aux_key = *(reinterpret_cast<std::int32_t *>(&op_codes[4 + I * multiplier]));
-        aux_target = *(reinterpret_cast<std::int32_t *>(&op_codes[base_targets + I * multiplier]));
+        aux_key = *(reinterpret_cast<const std::int32_t *>(&op_codes[4 + I * multiplier]));
+        aux_target = *(reinterpret_cast<const std::int32_t *>(&op_codes[base_targets + I * multiplier]));
 
         keys_targets.push_back({aux_key, aux_target});
     }
 }
 
-FillArrayData::FillArrayData(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+FillArrayData::FillArrayData(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     : Instruction(bytecode, index, dexinsttype_t::DEX_FILLARRAYDATA, 8)
 {
     std::uint8_t aux;
 
-    op = *(reinterpret_cast<std::uint16_t *>(&op_codes[0]));
-    element_width = *(reinterpret_cast<std::uint16_t *>(&op_codes[2]));
-    size = *(reinterpret_cast<std::uint32_t *>(&op_codes[4]));
+    op = *(reinterpret_cast<const std::uint16_t *>(&op_codes[0]));
+    element_width = *(reinterpret_cast<const std::uint16_t *>(&op_codes[2]));
+    size = *(reinterpret_cast<const std::uint32_t *>(&op_codes[4]));
 
     // again we have to fix the length of the instruction
     // and also the opcodes
@@ -654,6 +710,10 @@ FillArrayData::FillArrayData(std::vector<uint8_t> &bytecode, std::size_t index,
     length += buff_size;
     if (buff_size % 2 != 0)
         length += 1;
+    if (index + length > bytecode.size())
+        throw exceptions::InvalidInstructionException("payload out of bytecode bounds",
+                                                      static_cast<std::uint32_t>(bytecode.size() - index));
+
     op_codes = {bytecode.begin() + index, bytecode.begin() + index + length};
 
     for (size_t I = 0; I < buff_size; ++I)
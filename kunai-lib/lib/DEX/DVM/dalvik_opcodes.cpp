@@ -6,33 +6,37 @@
 // @file dalvik_opcodes.cpp
 #include "Kunai/DEX/DVM/dalvik_opcodes.hpp"
 
-using namespace KUNAI::DEX;
+#include <array>
+#include <unordered_map>
 
-/// @brief Map of the opcodes and the name of the instructions
-/// we will obtain its value from a definition file
-static const std::unordered_map<TYPES::opcodes, std::string>
-    opcodes_instruction_name =
-        {
-#define INST_NAME(OP, NAME) {OP, NAME},
-#include "Kunai/DEX/DVM/definitions/dvm_inst_names.def"
-};
-
-static const std::unordered_map<TYPES::opcodes, TYPES::Kind>
-    opcodes_instruction_kind =
-        {
-#define INST_KIND(OP, VAL) {OP, VAL},
-#include "Kunai/DEX/DVM/definitions/dvm_inst_kind.def"
-};
-
-static const std::unordered_map<TYPES::opcodes, TYPES::Operation>
-    opcodes_instruction_operation =
-        {
-#define INST_OP(OP, VAL) {OP, VAL},
-#include "Kunai/DEX/DVM/definitions/dvm_inst_operation.def"
-};
+using namespace KUNAI::DEX;
 
 namespace
 {
+    /// @brief names of the instructions as strings, for the
+    /// functions that return a reference to the name
+    const std::array<std::string, 256> instruction_names = []
+    {
+        std::array<std::string, 256> names;
+
+        for (std::size_t I = 0; I < names.size(); ++I)
+            names[I] = std::string(opcode_tables::names[I]);
+
+        return names;
+    }();
+
+    /// @brief names of the pseudo-opcodes and the jumbo opcodes
+    const std::unordered_map<std::uint32_t, std::string> extended_instruction_names = []
+    {
+        std::unordered_map<std::uint32_t, std::string> names;
+
+        for (const auto &entry : opcode_tables::name_entries)
+            if (entry.opcode >= instruction_names.size())
+                names.emplace(entry.opcode, std::string(entry.value));
+
+        return names;
+    }();
+
     std::string access_flags_to_str(TYPES::access_flags ac)
     {
         std::string access_flags = "";
@@ -99,30 +103,13 @@ namespace
 
 const std::string &DalvikOpcodes::get_instruction_name(std::uint32_t instruction)
 {
-    auto it = opcodes_instruction_name.find(static_cast<TYPES::opcodes>(instruction));
-
-    if (it == opcodes_instruction_name.end())
-        return opcodes_instruction_name.at(TYPES::opcodes::OP_NONE);
+    if (instruction < ::instruction_names.size())
+        return ::instruction_names[instruction];
 
-    return it->second;
-}
-
-TYPES::Kind DalvikOpcodes::get_instruction_type(std::uint32_t instruction)
-{
-    auto it = opcodes_instruction_kind.find(static_cast<TYPES::opcodes>(instruction));
-
-    if (it == opcodes_instruction_kind.end())
-        return TYPES::Kind::NONE_KIND;
-
-    return it->second;
-}
-
-TYPES::Operation DalvikOpcodes::get_instruction_operation(std::uint32_t instruction)
-{
-    auto it = opcodes_instruction_operation.find(static_cast<TYPES::opcodes>(instruction));
+    auto it = ::extended_instruction_names.find(instruction);
 
-    if (it == opcodes_instruction_operation.end())
-        return TYPES::Operation::NONE_OPCODE;
+    if (it == ::extended_instruction_names.end())
+        return ::extended_instruction_names.at(TYPES::opcodes::OP_NONE);
 
     return it->second;
 }
@@ -6,16 +6,76 @@
 // @file dex_disassembler.cpp
 
 #include "Kunai/DEX/DVM/dex_disassembler.hpp"
+#include "Kunai/Utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
 
 using namespace KUNAI::DEX;
 
+bool DexDisassembler::decode_method(EncodedMethod *method,
+                                    LinearSweepDisassembler &linear_sweep,
+                                    RecursiveTraversalDisassembler &recursive_traversal,
+                                    std::vector<std::unique_ptr<Instruction>> &instructions)
+{
+    auto &code_item_struct = method->get_code_item();
+
+    auto buffer_instructions = code_item_struct.get_bytecode();
+
+    try
+    {
+        if (algorithm == disassembly_algorithm::LINEAR_SWEEP_ALGORITHM)
+            linear_sweep.disassembly(buffer_instructions, instructions);
+        else if (algorithm == disassembly_algorithm::RECURSIVE_TRAVERSAL_ALGORITHM)
+            recursive_traversal.disassembly(buffer_instructions, method, instructions);
+    }
+    catch (const std::exception &e)
+    {
+        auto logger = LOGGER::logger();
+
+        logger->error("decode_method: incorrect disassembly of method {}: {}",
+                      method->getMethodID()->pretty_method(), e.what());
+
+        instructions.clear();
+        return false;
+    }
+
+    return true;
+}
+
+std::vector<std::unique_ptr<Instruction>> &DexDisassembler::disassemble_method(EncodedMethod *method)
+{
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+
+        auto it = dex_instructions.find(method);
+
+        if (it != dex_instructions.end())
+            return it->second;
+    }
+
+    // decode without holding the lock, with disassemblers of this call
+    method_decoder_t decoder(parser);
+    std::vector<std::unique_ptr<Instruction>> instructions;
+
+    bool correct = decode_method(method, decoder.linear_sweep, decoder.recursive_traversal, instructions);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    // if other thread decoded the method meanwhile, its
+    // instructions are kept since they may be in use
+    auto [it, inserted] = dex_instructions.try_emplace(method, std::move(instructions));
+
+    if (inserted && !correct)
+        incorrect_methods.insert(method);
+
+    return it->second;
+}
+
 void DexDisassembler::disassembly_dex()
 {
     auto logger = LOGGER::logger();
 
-    // set disassembly as correct, this will be fixed in case of an error
-    disassembly_correct = true;
-
     logger->debug("disassembly_dex: started disassembly of dex file");
 
     auto &classes = parser->get_classes();
@@ -30,36 +90,105 @@ void DexDisassembler::disassembly_dex()
         auto &methods = class_data_item.get_methods();
 
         for (auto method : methods)
+            disassemble_method(method);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        disassembly_correct = incorrect_methods.empty();
+    }
+
+    logger->debug("disassembly_dex: finished disassembly of dex file");
+}
+
+void DexDisassembler::disassembly_dex_parallel(std::uint32_t number_of_threads)
+{
+    auto logger = LOGGER::logger();
+    std::vector<EncodedMethod *> methods;
+
+    logger->debug("disassembly_dex_parallel: started disassembly of dex file");
+
+    // the class data items are parsed here, before the threads start
+    for (auto &class_def : parser->get_classes().get_classdefs())
+    {
+        for (auto method : class_def->get_class_data_item().get_methods())
         {
-            auto &code_item_struct = method->get_code_item();
+            std::lock_guard<std::mutex> lock(cache_mutex);
+
+            if (!dex_instructions.contains(method))
+                methods.push_back(method);
+        }
+    }
 
-            auto &buffer_instructions = code_item_struct.get_bytecode();
+    // the largest methods go first, so the threads end with
+    // the smallest ones and all of them finish at the same time
+    std::stable_sort(methods.begin(), methods.end(), [](EncodedMethod *a, EncodedMethod *b)
+                     { return a->get_code_item().get_bytecode().size() > b->get_code_item().get_bytecode().size(); });
 
-            std::vector<std::unique_ptr<Instruction>> instructions;
+    // one slot for each method, every method is written by one thread
+    std::vector<std::vector<std::unique_ptr<Instruction>>> results(methods.size());
+    std::vector<std::uint8_t> correct(methods.size(), true);
+    std::atomic<std::size_t> next_method = 0;
 
-            try
-            {
-                if (algorithm == disassembly_algorithm::LINEAR_SWEEP_ALGORITHM)
-                    linear_sweep.disassembly(buffer_instructions, instructions);
-                else if (algorithm == disassembly_algorithm::RECURSIVE_TRAVERSAL_ALGORITHM)
-                    recursive_traversal.disassembly(buffer_instructions, method, instructions);
-
-                dex_instructions[method] = std::move(instructions);
-            }
-            catch (const std::exception &e)
+    {
+        utils::ThreadPool pool(number_of_threads);
+        std::vector<std::future<void>> futures;
+
+        logger->debug("disassembly_dex_parallel: disassembly of {} methods with {} threads",
+                      methods.size(), pool.get_number_of_threads());
+
+        for (std::size_t I = 0; I < pool.get_number_of_threads(); ++I)
+        {
+            futures.push_back(pool.submit([&]()
             {
-                disassembly_correct = false;
-                instructions.clear();
-                dex_instructions[method] = std::move(instructions);
-            }
+                // the disassemblers keep state, so each thread has its own ones
+                method_decoder_t decoder(parser);
+
+                // each thread takes the next method not disassembled yet
+                for (auto J = next_method++; J < methods.size(); J = next_method++)
+                    correct[J] = decode_method(methods[J], decoder.linear_sweep, decoder.recursive_traversal, results[J]);
+            }));
         }
+
+        utils::ThreadPool::wait_all(futures);
     }
 
-    logger->debug("disassembly_dex: finished disassembly of dex file");
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    dex_instructions.reserve(dex_instructions.size() + methods.size());
+
+    for (std::size_t I = 0; I < methods.size(); ++I)
+    {
+        // a method disassembled on demand meanwhile keeps its
+        // instructions, references to them may have been returned
+        auto inserted = dex_instructions.try_emplace(methods[I], std::move(results[I])).second;
+
+        if (inserted && !correct[I])
+            incorrect_methods.insert(methods[I]);
+    }
+
+    disassembly_correct = incorrect_methods.empty();
+
+    logger->debug("disassembly_dex_parallel: finished disassembly of dex file");
+}
+
+void DexDisassembler::disassembly_flat_dex()
+{
+    auto logger = LOGGER::logger();
+
+    logger->debug("disassembly_flat_dex: started flat disassembly of dex file");
+
+    for (auto &class_def : parser->get_classes().get_classdefs())
+    {
+        for (auto method : class_def->get_class_data_item().get_methods())
+            flat_instructions[method].disassembly(method->get_code_item().get_bytecode());
+    }
+
+    logger->debug("disassembly_flat_dex: finished flat disassembly of dex file");
 }
 
 std::vector<std::unique_ptr<Instruction>>
-DexDisassembler::disassembly_buffer(std::vector<std::uint8_t> &buffer)
+DexDisassembler::disassembly_buffer(std::span<const std::uint8_t> buffer)
 {
     std::vector<std::unique_ptr<Instruction>> instructions;
 
@@ -71,16 +200,58 @@ DexDisassembler::disassembly_buffer(std::vector<std::uint8_t> &buffer)
 }
 
 
-void DexDisassembler::add_disassembly(DexDisassembler& other)
+void DexDisassembler::add_disassembly(const DexDisassembler& other)
 {
-    for (auto & methods_instrs : other.dex_instructions)
+    if (&other == this)
+        return;
+
+    std::vector<EncodedMethod *> methods;
+    std::vector<std::pair<EncodedMethod *, FlatInstructions>> flat_methods;
+
     {
-        dex_instructions[methods_instrs.first] = std::move(methods_instrs.second);
+        std::lock_guard<std::mutex> lock(other.cache_mutex);
+
+        for (auto & methods_instrs : other.dex_instructions)
+            methods.push_back(methods_instrs.first);
+
+        for (auto & methods_instrs : other.flat_instructions)
+            flat_methods.push_back(methods_instrs);
     }
+
+    // the instructions resolve the ids with the parser
+    // of the other disassembler, so it decodes them
+    method_decoder_t decoder(other.parser);
+
+    for (auto method : methods)
+    {
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+
+            // the instructions already given are never replaced
+            if (dex_instructions.contains(method))
+                continue;
+        }
+
+        std::vector<std::unique_ptr<Instruction>> instructions;
+
+        bool correct = decode_method(method, decoder.linear_sweep, decoder.recursive_traversal, instructions);
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+
+        auto inserted = dex_instructions.try_emplace(method, std::move(instructions)).second;
+
+        if (inserted && !correct)
+            incorrect_methods.insert(method);
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    for (auto & methods_instrs : flat_methods)
+        flat_instructions.try_emplace(methods_instrs.first, std::move(methods_instrs.second));
 }
 
 
-DexDisassembler& DexDisassembler::operator+=(DexDisassembler& other)
+DexDisassembler& DexDisassembler::operator+=(const DexDisassembler& other)
 {
     this->add_disassembly(other);
     return *this;
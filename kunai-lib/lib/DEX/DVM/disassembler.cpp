@@ -11,6 +11,7 @@
 #include "Kunai/Exceptions/disassembler_exception.hpp"
 #include "Kunai/DEX/DVM/dalvik_opcodes.hpp"
 
+#include <array>
 #include <unordered_map>
 
 using namespace KUNAI::DEX;
@@ -19,7 +20,7 @@ namespace
 {
     /// @brief definition of a generator function for
     /// generating the different instructions
-    typedef std::unique_ptr<Instruction> (*generator_func)(std::vector<uint8_t> &, std::size_t, Parser *);
+    typedef std::unique_ptr<Instruction> (*generator_func)(std::span<const std::uint8_t>, std::size_t, Parser *);
 
     /// @brief Template that will generate all the instructions
     /// getter user in the disassembler
@@ -30,310 +31,94 @@ namespace
     /// @return unique pointer with a new instruction
     template <class T>
     std::unique_ptr<Instruction>
-    get_instruction(std::vector<uint8_t> &bytecode, std::size_t index, Parser *parser)
+    get_instruction(std::span<const std::uint8_t> bytecode, std::size_t index, Parser *parser)
     {
         return std::make_unique<T>(bytecode, index, parser);
     }
 
-    /// @brief table of opcodes and generator pointers
-    /// generators are generated for each instruction
-    std::unordered_map<TYPES::opcodes, generator_func> function_pointers = {
-        // Instruction00x
-        {TYPES::opcodes::OP_IGET_VOLATILE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_IPUT_VOLATILE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_SGET_VOLATILE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_SPUT_VOLATILE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_IGET_OBJECT_VOLATILE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_IGET_WIDE_VOLATILE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_IPUT_WIDE_VOLATILE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_SGET_WIDE_VOLATILE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_SPUT_WIDE_VOLATILE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_BREAKPOINT, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_THROW_VERIFICATION_ERROR, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_EXECUTE_INLINE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_EXECUTE_INLINE_RANGE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_INVOKE_OBJECT_INIT_RANGE, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_RETURN_VOID_BARRIER, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_IGET_QUICK, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_IGET_WIDE_QUICK, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_IGET_OBJECT_QUICK, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_IPUT_QUICK, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_IPUT_WIDE_QUICK, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_IPUT_OBJECT_QUICK, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_INVOKE_VIRTUAL_QUICK, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_INVOKE_VIRTUAL_QUICK_RANGE, &get_instruction<Instruction00x>},
-        // Instruction12x
-        {TYPES::opcodes::OP_MOVE, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_MOVE_WIDE, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_MOVE_OBJECT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_ARRAY_LENGTH, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_NEG_INT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_NOT_INT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_NEG_LONG, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_NOT_LONG, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_NEG_FLOAT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_NEG_DOUBLE, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_INT_TO_LONG, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_INT_TO_FLOAT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_INT_TO_DOUBLE, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_LONG_TO_INT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_LONG_TO_FLOAT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_LONG_TO_DOUBLE, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_FLOAT_TO_INT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_FLOAT_TO_LONG, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_FLOAT_TO_DOUBLE, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_DOUBLE_TO_INT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_DOUBLE_TO_LONG, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_DOUBLE_TO_FLOAT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_INT_TO_BYTE, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_INT_TO_CHAR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_INT_TO_SHORT, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_ADD_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_SUB_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_MUL_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_DIV_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_REM_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_AND_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_OR_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_XOR_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_SHL_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_SHR_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_USHR_INT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_ADD_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_SUB_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_MUL_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_DIV_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_REM_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_AND_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_OR_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_XOR_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_SHL_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_SHR_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_USHR_LONG_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_ADD_FLOAT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_SUB_FLOAT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_MUL_FLOAT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_DIV_FLOAT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_REM_FLOAT_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_ADD_DOUBLE_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_SUB_DOUBLE_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_MUL_DOUBLE_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_DIV_DOUBLE_2ADDR, &get_instruction<Instruction12x>},
-        {TYPES::opcodes::OP_REM_DOUBLE_2ADDR, &get_instruction<Instruction12x>},
-        // Instruction22x
-        {TYPES::opcodes::OP_MOVE_FROM16, &get_instruction<Instruction22x>},
-        {TYPES::opcodes::OP_MOVE_WIDE_FROM16, &get_instruction<Instruction22x>},
-        {TYPES::opcodes::OP_MOVE_OBJECT_FROM16, &get_instruction<Instruction22x>},
-        // Instruction32x
-        {TYPES::opcodes::OP_MOVE_16, &get_instruction<Instruction32x>},
-        {TYPES::opcodes::OP_MOVE_WIDE_16, &get_instruction<Instruction32x>},
-        {TYPES::opcodes::OP_MOVE_OBJECT_16, &get_instruction<Instruction32x>},
-        // Instruction11x
-        {TYPES::opcodes::OP_MOVE_RESULT, &get_instruction<Instruction11x>},
-        {TYPES::opcodes::OP_MOVE_RESULT_WIDE, &get_instruction<Instruction11x>},
-        {TYPES::opcodes::OP_MOVE_RESULT_OBJECT, &get_instruction<Instruction11x>},
-        {TYPES::opcodes::OP_MOVE_EXCEPTION, &get_instruction<Instruction11x>},
-        {TYPES::opcodes::OP_RETURN, &get_instruction<Instruction11x>},
-        {TYPES::opcodes::OP_RETURN_WIDE, &get_instruction<Instruction11x>},
-        {TYPES::opcodes::OP_RETURN_OBJECT, &get_instruction<Instruction11x>},
-        {TYPES::opcodes::OP_MONITOR_ENTER, &get_instruction<Instruction11x>},
-        {TYPES::opcodes::OP_MONITOR_EXIT, &get_instruction<Instruction11x>},
-        {TYPES::opcodes::OP_THROW, &get_instruction<Instruction11x>},
-        // Instruction10x
-        {TYPES::opcodes::OP_RETURN_VOID, &get_instruction<Instruction10x>},
-        {TYPES::opcodes::OP_NOP, &get_instruction<Instruction10x>},
-        // Instruction11n
-        {TYPES::opcodes::OP_CONST_4, &get_instruction<Instruction11n>},
-        // Instruction21s
-        {TYPES::opcodes::OP_CONST_16, &get_instruction<Instruction21s>},
-        {TYPES::opcodes::OP_CONST_WIDE_16, &get_instruction<Instruction21s>},
-        // Instruction31i
-        {TYPES::opcodes::OP_CONST, &get_instruction<Instruction31i>},
-        {TYPES::opcodes::OP_CONST_WIDE_32, &get_instruction<Instruction31i>},
-        // Instruction21h
-        {TYPES::opcodes::OP_CONST_HIGH16, &get_instruction<Instruction21h>},
-        {TYPES::opcodes::OP_CONST_WIDE_HIGH16, &get_instruction<Instruction21h>},
-        // Instruction51l
-        {TYPES::opcodes::OP_CONST_WIDE, &get_instruction<Instruction51l>},
-        // Instruction21c
-        {TYPES::opcodes::OP_CONST_STRING, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_CONST_CLASS, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_CHECK_CAST, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_NEW_INSTANCE, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SGET, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SGET_WIDE, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SGET_OBJECT, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SGET_BOOLEAN, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SGET_BYTE, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SGET_CHAR, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SGET_SHORT, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SPUT, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SPUT_WIDE, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SPUT_OBJECT, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SPUT_BOOLEAN, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SPUT_BYTE, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SPUT_CHAR, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SPUT_SHORT, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_SPUT_OBJECT_VOLATILE, &get_instruction<Instruction21c>},
-        {TYPES::opcodes::OP_CONST_METHOD_TYPE, &get_instruction<Instruction21c>},
-        // Instruction31c
-        {TYPES::opcodes::OP_CONST_STRING_JUMBO, &get_instruction<Instruction31c>},
-        // Instruction22c
-        {TYPES::opcodes::OP_INSTANCE_OF, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_NEW_ARRAY, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IGET, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IGET_WIDE, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IGET_OBJECT, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IGET_BOOLEAN, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IGET_BYTE, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IGET_CHAR, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IGET_SHORT, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IPUT, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IPUT_WIDE, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IPUT_OBJECT, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IPUT_BOOLEAN, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IPUT_BYTE, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IPUT_CHAR, &get_instruction<Instruction22c>},
-        {TYPES::opcodes::OP_IPUT_SHORT, &get_instruction<Instruction22c>},
-        // Instruction35c
-        {TYPES::opcodes::OP_FILLED_NEW_ARRAY, &get_instruction<Instruction35c>},
-        {TYPES::opcodes::OP_INVOKE_VIRTUAL, &get_instruction<Instruction35c>},
-        {TYPES::opcodes::OP_INVOKE_SUPER, &get_instruction<Instruction35c>},
-        {TYPES::opcodes::OP_INVOKE_DIRECT, &get_instruction<Instruction35c>},
-        {TYPES::opcodes::OP_INVOKE_STATIC, &get_instruction<Instruction35c>},
-        {TYPES::opcodes::OP_INVOKE_INTERFACE, &get_instruction<Instruction35c>},
-        // Instruction3rc
-        {TYPES::opcodes::OP_FILLED_NEW_ARRAY_RANGE, &get_instruction<Instruction3rc>},
-        {TYPES::opcodes::OP_INVOKE_VIRTUAL_RANGE, &get_instruction<Instruction3rc>},
-        {TYPES::opcodes::OP_INVOKE_SUPER_RANGE, &get_instruction<Instruction3rc>},
-        {TYPES::opcodes::OP_INVOKE_DIRECT_RANGE, &get_instruction<Instruction3rc>},
-        {TYPES::opcodes::OP_INVOKE_STATIC_RANGE, &get_instruction<Instruction3rc>},
-        {TYPES::opcodes::OP_INVOKE_INTERFACE_RANGE, &get_instruction<Instruction3rc>},
-        // Instruction31t
-        {TYPES::opcodes::OP_FILL_ARRAY_DATA, &get_instruction<Instruction31t>},
-        {TYPES::opcodes::OP_PACKED_SWITCH, &get_instruction<Instruction31t>},
-        {TYPES::opcodes::OP_SPARSE_SWITCH, &get_instruction<Instruction31t>},
-        // Instruction10t
-        {TYPES::opcodes::OP_GOTO, &get_instruction<Instruction10t>},
-        // Instruction20t
-        {TYPES::opcodes::OP_GOTO_16, &get_instruction<Instruction20t>},
-        // Instruction30t
-        {TYPES::opcodes::OP_GOTO_32, &get_instruction<Instruction30t>},
-        // Instruction23x
-        {TYPES::opcodes::OP_CMPL_FLOAT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_CMPG_FLOAT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_CMPL_DOUBLE, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_CMPG_DOUBLE, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_CMP_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_ADD_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_SUB_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_MUL_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_DIV_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_REM_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_AND_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_OR_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_XOR_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_SHL_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_SHR_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_USHR_INT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_ADD_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_SUB_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_MUL_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_DIV_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_REM_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_AND_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_OR_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_XOR_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_SHL_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_SHR_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_USHR_LONG, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_ADD_FLOAT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_SUB_FLOAT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_MUL_FLOAT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_DIV_FLOAT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_REM_FLOAT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_ADD_DOUBLE, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_SUB_DOUBLE, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_MUL_DOUBLE, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_DIV_DOUBLE, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_REM_DOUBLE, &get_instruction<Instruction23x>},
-        // Instruction22t
-        {TYPES::opcodes::OP_IF_EQ, &get_instruction<Instruction22t>},
-        {TYPES::opcodes::OP_IF_NE, &get_instruction<Instruction22t>},
-        {TYPES::opcodes::OP_IF_LT, &get_instruction<Instruction22t>},
-        {TYPES::opcodes::OP_IF_GE, &get_instruction<Instruction22t>},
-        {TYPES::opcodes::OP_IF_GT, &get_instruction<Instruction22t>},
-        {TYPES::opcodes::OP_IF_LE, &get_instruction<Instruction22t>},
-        // Instruction21t
-        {TYPES::opcodes::OP_IF_EQZ, &get_instruction<Instruction21t>},
-        {TYPES::opcodes::OP_IF_NEZ, &get_instruction<Instruction21t>},
-        {TYPES::opcodes::OP_IF_LTZ, &get_instruction<Instruction21t>},
-        {TYPES::opcodes::OP_IF_GEZ, &get_instruction<Instruction21t>},
-        {TYPES::opcodes::OP_IF_GTZ, &get_instruction<Instruction21t>},
-        {TYPES::opcodes::OP_IF_LEZ, &get_instruction<Instruction21t>},
-        // Instruction00x
-        {TYPES::opcodes::OP_UNUSED_3E, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_UNUSED_3F, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_UNUSED_40, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_UNUSED_41, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_UNUSED_42, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_UNUSED_43, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_UNUSED_73, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_UNUSED_79, &get_instruction<Instruction00x>},
-        {TYPES::opcodes::OP_UNUSED_7A, &get_instruction<Instruction00x>},
-        // Instruction23x
-        {TYPES::opcodes::OP_AGET, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_AGET_WIDE, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_AGET_OBJECT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_AGET_BOOLEAN, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_AGET_BYTE, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_AGET_CHAR, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_AGET_SHORT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_APUT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_APUT_WIDE, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_APUT_OBJECT, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_APUT_BOOLEAN, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_APUT_BYTE, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_APUT_CHAR, &get_instruction<Instruction23x>},
-        {TYPES::opcodes::OP_APUT_SHORT, &get_instruction<Instruction23x>},
-        // Instruction22s
-        {TYPES::opcodes::OP_ADD_INT_LIT16, &get_instruction<Instruction22s>},
-        {TYPES::opcodes::OP_SUB_INT_LIT16, &get_instruction<Instruction22s>},
-        {TYPES::opcodes::OP_MUL_INT_LIT16, &get_instruction<Instruction22s>},
-        {TYPES::opcodes::OP_DIV_INT_LIT16, &get_instruction<Instruction22s>},
-        {TYPES::opcodes::OP_REM_INT_LIT16, &get_instruction<Instruction22s>},
-        {TYPES::opcodes::OP_AND_INT_LIT16, &get_instruction<Instruction22s>},
-        {TYPES::opcodes::OP_OR_INT_LIT16, &get_instruction<Instruction22s>},
-        {TYPES::opcodes::OP_XOR_INT_LIT16, &get_instruction<Instruction22s>},
-        // Instruction22b
-        {TYPES::opcodes::OP_ADD_INT_LIT8, &get_instruction<Instruction22b>},
-        {TYPES::opcodes::OP_SUB_INT_LIT8, &get_instruction<Instruction22b>},
-        {TYPES::opcodes::OP_MUL_INT_LIT8, &get_instruction<Instruction22b>},
-        {TYPES::opcodes::OP_DIV_INT_LIT8, &get_instruction<Instruction22b>},
-        {TYPES::opcodes::OP_REM_INT_LIT8, &get_instruction<Instruction22b>},
-        {TYPES::opcodes::OP_AND_INT_LIT8, &get_instruction<Instruction22b>},
-        {TYPES::opcodes::OP_OR_INT_LIT8, &get_instruction<Instruction22b>},
-        {TYPES::opcodes::OP_XOR_INT_LIT8, &get_instruction<Instruction22b>},
-        {TYPES::opcodes::OP_SHL_INT_LIT8, &get_instruction<Instruction22b>},
-        {TYPES::opcodes::OP_SHR_INT_LIT8, &get_instruction<Instruction22b>},
-        {TYPES::opcodes::OP_USHR_INT_LIT8, &get_instruction<Instruction22b>},
-        // Instruction45cc
-        {TYPES::opcodes::OP_INVOKE_SUPER_QUICK, &get_instruction<Instruction45cc>},
-        // Instruction4rcc
-        {TYPES::opcodes::OP_INVOKE_SUPER_QUICK_RANGE, &get_instruction<Instruction4rcc>},
-        // Instruction35c
-        {TYPES::opcodes::OP_IPUT_OBJECT_VOLATILE, &get_instruction<Instruction35c>},
-        // Instruction3rc
-        {TYPES::opcodes::OP_SGET_OBJECT_VOLATILE, &get_instruction<Instruction3rc>},
-        // Instruction21c
-
-    };
+    /// @brief Get the generator of the instructions of a format
+    /// @param format format of the instruction
+    /// @return generator function, or nullptr for a format without generator
+    constexpr generator_func get_generator(dexinsttype_t format)
+    {
+        switch (format)
+        {
+        case dexinsttype_t::DEX_INSTRUCTION00X:
+            return &get_instruction<Instruction00x>;
+        case dexinsttype_t::DEX_INSTRUCTION10X:
+            return &get_instruction<Instruction10x>;
+        case dexinsttype_t::DEX_INSTRUCTION12X:
+            return &get_instruction<Instruction12x>;
+        case dexinsttype_t::DEX_INSTRUCTION11N:
+            return &get_instruction<Instruction11n>;
+        case dexinsttype_t::DEX_INSTRUCTION11X:
+            return &get_instruction<Instruction11x>;
+        case dexinsttype_t::DEX_INSTRUCTION10T:
+            return &get_instruction<Instruction10t>;
+        case dexinsttype_t::DEX_INSTRUCTION20T:
+            return &get_instruction<Instruction20t>;
+        case dexinsttype_t::DEX_INSTRUCTION22X:
+            return &get_instruction<Instruction22x>;
+        case dexinsttype_t::DEX_INSTRUCTION21T:
+            return &get_instruction<Instruction21t>;
+        case dexinsttype_t::DEX_INSTRUCTION21S:
+            return &get_instruction<Instruction21s>;
+        case dexinsttype_t::DEX_INSTRUCTION21H:
+            return &get_instruction<Instruction21h>;
+        case dexinsttype_t::DEX_INSTRUCTION21C:
+            return &get_instruction<Instruction21c>;
+        case dexinsttype_t::DEX_INSTRUCTION23X:
+            return &get_instruction<Instruction23x>;
+        case dexinsttype_t::DEX_INSTRUCTION22B:
+            return &get_instruction<Instruction22b>;
+        case dexinsttype_t::DEX_INSTRUCTION22T:
+            return &get_instruction<Instruction22t>;
+        case dexinsttype_t::DEX_INSTRUCTION22S:
+            return &get_instruction<Instruction22s>;
+        case dexinsttype_t::DEX_INSTRUCTION22C:
+            return &get_instruction<Instruction22c>;
+        case dexinsttype_t::DEX_INSTRUCTION30T:
+            return &get_instruction<Instruction30t>;
+        case dexinsttype_t::DEX_INSTRUCTION32X:
+            return &get_instruction<Instruction32x>;
+        case dexinsttype_t::DEX_INSTRUCTION31I:
+            return &get_instruction<Instruction31i>;
+        case dexinsttype_t::DEX_INSTRUCTION31T:
+            return &get_instruction<Instruction31t>;
+        case dexinsttype_t::DEX_INSTRUCTION31C:
+            return &get_instruction<Instruction31c>;
+        case dexinsttype_t::DEX_INSTRUCTION35C:
+            return &get_instruction<Instruction35c>;
+        case dexinsttype_t::DEX_INSTRUCTION3RC:
+            return &get_instruction<Instruction3rc>;
+        case dexinsttype_t::DEX_INSTRUCTION45CC:
+            return &get_instruction<Instruction45cc>;
+        case dexinsttype_t::DEX_INSTRUCTION4RCC:
+            return &get_instruction<Instruction4rcc>;
+        case dexinsttype_t::DEX_INSTRUCTION51L:
+            return &get_instruction<Instruction51l>;
+        default:
+            return nullptr;
+        }
+    }
+
+    /// @brief table of opcodes and generator pointers, generated
+    /// at compile time from the format of each opcode
+    constexpr std::array<generator_func, 256> function_pointers = []
+    {
+        std::array<generator_func, 256> table{};
+
+        for (std::size_t I = 0; I < table.size(); ++I)
+            table[I] = get_generator(opcode_tables::formats[I]);
+
+        return table;
+    }();
 
 } // namespace
 
 std::unique_ptr<Instruction> Disassembler::disassemble_instruction(
     std::uint32_t opcode,
-    std::vector<uint8_t> &bytecode,
+    std::span<const std::uint8_t> bytecode,
     std::size_t index)
 {
     auto logger = LOGGER::logger();
@@ -354,10 +139,10 @@ std::unique_ptr<Instruction> Disassembler::disassemble_instruction(
     }
     else
     {
-        auto it = ::function_pointers.find(static_cast<TYPES::opcodes>(opcode));
+        auto generator = opcode < ::function_pointers.size() ? ::function_pointers[opcode] : nullptr;
 
-        if (it != ::function_pointers.end())
-            instr = it->second(bytecode, index, parser);
+        if (generator)
+            instr = generator(bytecode, index, parser);
         else
         {
             logger->error("Error in disassembler, opcode {} not recognized", opcode);
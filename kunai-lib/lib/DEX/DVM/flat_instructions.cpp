@@ -0,0 +1,363 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file flat_instructions.cpp
+
+#include "Kunai/DEX/DVM/flat_instructions.hpp"
+#include "Kunai/Exceptions/invalidinstruction_exception.hpp"
+#include "Kunai/Utils/logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace KUNAI::DEX;
+
+namespace
+{
+    /// @brief identifiers of the payloads, read as 16-bit values
+    constexpr std::uint16_t packed_switch_payload = 0x0100;
+    constexpr std::uint16_t sparse_switch_payload = 0x0200;
+    constexpr std::uint16_t fill_array_data_payload = 0x0300;
+
+    template <typename T>
+    T read_bytecode(std::span<const std::uint8_t> bytecode, std::size_t index)
+    {
+        T value;
+        std::memcpy(&value, bytecode.data() + index, sizeof(T));
+        return value;
+    }
+
+    /// @brief Check that an instruction or payload is inside of the bytecode
+    /// @param bytecode bytecode of the method
+    /// @param index index of the instruction
+    /// @param length length of the instruction in bytes
+    void check_bounds(std::span<const std::uint8_t> bytecode, std::size_t index, std::uint64_t length)
+    {
+        if (index + length > bytecode.size())
+            throw exceptions::InvalidInstructionException("FlatInstructions: instruction out of bytecode bounds",
+                                                          static_cast<std::uint32_t>(bytecode.size() - index));
+    }
+} // namespace
+
+void FlatInstructions::clear()
+{
+    instructions.clear();
+    switch_keys.clear();
+    switch_targets.clear();
+    array_data.clear();
+}
+
+void FlatInstructions::disassembly(std::span<const std::uint8_t> bytecode)
+{
+    std::size_t idx = 0;
+
+    clear();
+
+    // an instruction takes at least one code unit, this is
+    // enough for most of the methods without reallocations
+    instructions.reserve(bytecode.size() / 4);
+
+    while (idx < bytecode.size())
+    {
+        flat_instruction_t instruction = {};
+
+        decode_or_mark_incorrect(bytecode, idx, instruction);
+
+        instructions.push_back(instruction);
+        idx += instruction.length;
+    }
+}
+
+void FlatInstructions::disassembly(std::span<const std::uint8_t> bytecode,
+                                   std::span<const std::uint64_t> addresses)
+{
+    clear();
+
+    instructions.reserve(addresses.size());
+
+    for (auto address : addresses)
+    {
+        if (address >= bytecode.size())
+            continue;
+
+        flat_instruction_t instruction = {};
+
+        decode_or_mark_incorrect(bytecode, address, instruction);
+
+        instructions.push_back(instruction);
+    }
+
+    // the instructions are kept sorted by address for the lookups
+    std::sort(instructions.begin(), instructions.end(),
+              [](const flat_instruction_t &a, const flat_instruction_t &b)
+              { return a.address < b.address; });
+}
+
+void FlatInstructions::decode_or_mark_incorrect(std::span<const std::uint8_t> bytecode,
+                                                std::size_t index,
+                                                flat_instruction_t &instruction)
+{
+    try
+    {
+        decode_instruction(bytecode, index, instruction);
+    }
+    catch (const exceptions::InvalidInstructionException &i)
+    {
+        auto logger = LOGGER::logger();
+
+        logger->debug("FlatInstructions: invalid instruction in the index {}: {}", index, i.what());
+
+        instruction = {};
+        instruction.address = static_cast<std::uint32_t>(index);
+        instruction.length = std::max<std::uint32_t>(i.size(), 1);
+        instruction.opcode = bytecode[index];
+        instruction.format = dexinsttype_t::DEX_DALVIKINCORRECT;
+    }
+}
+
+const flat_instruction_t *FlatInstructions::get_instruction_by_address(std::uint64_t address) const
+{
+    auto it = std::lower_bound(instructions.begin(), instructions.end(), address,
+                               [](const flat_instruction_t &instruction, std::uint64_t address)
+                               { return instruction.address < address; });
+
+    if (it == instructions.end() || it->address != address)
+        return nullptr;
+
+    return &(*it);
+}
+
+void FlatInstructions::decode_instruction(std::span<const std::uint8_t> bytecode,
+                                          std::size_t index,
+                                          flat_instruction_t &instruction)
+{
+    std::uint8_t op = bytecode[index];
+
+    instruction.address = static_cast<std::uint32_t>(index);
+    instruction.opcode = op;
+    instruction.format = DalvikOpcodes::get_instruction_format(op);
+    instruction.length = DalvikOpcodes::get_instruction_length(op) * 2;
+
+    check_bounds(bytecode, index, instruction.length);
+
+    auto bytes = bytecode.subspan(index);
+
+    switch (instruction.format)
+    {
+    case dexinsttype_t::DEX_INSTRUCTION10X:
+    {
+        if (op != TYPES::opcodes::OP_NOP || bytes[1] == 0)
+        {
+            if (bytes[1] != 0)
+                throw exceptions::InvalidInstructionException("Instruction10x high byte should be 0", 2);
+            break;
+        }
+
+        check_bounds(bytecode, index, 4);
+
+        auto payload = read_bytecode<std::uint16_t>(bytes, 0);
+
+        if (payload == packed_switch_payload)
+        {
+            auto size = read_bytecode<std::uint16_t>(bytes, 2);
+
+            instruction.format = dexinsttype_t::DEX_PACKEDSWITCH;
+            instruction.length = 8 + size * 4;
+            check_bounds(bytecode, index, instruction.length);
+
+            instruction.index = static_cast<std::uint32_t>(switch_keys.size());
+            instruction.second_index = size;
+            instruction.literal = read_bytecode<std::int32_t>(bytes, 4);
+
+            for (std::uint16_t I = 0; I < size; ++I)
+            {
+                switch_keys.push_back(static_cast<std::int32_t>(instruction.literal + I));
+                switch_targets.push_back(read_bytecode<std::int32_t>(bytes, 8 + I * 4));
+            }
+        }
+        else if (payload == sparse_switch_payload)
+        {
+            auto size = read_bytecode<std::uint16_t>(bytes, 2);
+
+            instruction.format = dexinsttype_t::DEX_SPARSESWITCH;
+            instruction.length = 4 + size * 8;
+            check_bounds(bytecode, index, instruction.length);
+
+            instruction.index = static_cast<std::uint32_t>(switch_keys.size());
+            instruction.second_index = size;
+
+            for (std::uint16_t I = 0; I < size; ++I)
+            {
+                switch_keys.push_back(read_bytecode<std::int32_t>(bytes, 4 + I * 4));
+                switch_targets.push_back(read_bytecode<std::int32_t>(bytes, 4 + size * 4 + I * 4));
+            }
+        }
+        else if (payload == fill_array_data_payload)
+        {
+            check_bounds(bytecode, index, 8);
+
+            auto element_width = read_bytecode<std::uint16_t>(bytes, 2);
+            auto size = read_bytecode<std::uint32_t>(bytes, 4);
+            std::uint64_t data_size = static_cast<std::uint64_t>(element_width) * size;
+
+            check_bounds(bytecode, index, 8 + data_size + (data_size % 2));
+
+            instruction.format = dexinsttype_t::DEX_FILLARRAYDATA;
+            instruction.length = static_cast<std::uint32_t>(8 + data_size + (data_size % 2));
+            instruction.index = static_cast<std::uint32_t>(array_data.size());
+            instruction.second_index = size;
+            instruction.literal = element_width;
+
+            array_data.insert(array_data.end(), bytes.begin() + 8, bytes.begin() + 8 + data_size);
+        }
+        else
+            throw exceptions::InvalidInstructionException("Instruction10x high byte should be 0", 2);
+
+        instruction.opcode = payload;
+    }
+    break;
+    case dexinsttype_t::DEX_INSTRUCTION12X:
+        instruction.number_of_registers = 2;
+        instruction.registers[0] = bytes[1] & 0x0F;
+        instruction.registers[1] = (bytes[1] & 0xF0) >> 4;
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION11N:
+        instruction.number_of_registers = 1;
+        instruction.registers[0] = bytes[1] & 0x0F;
+        // the literal is a signed nibble
+        instruction.literal = static_cast<std::int8_t>(bytes[1]) >> 4;
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION11X:
+        instruction.number_of_registers = 1;
+        instruction.registers[0] = bytes[1];
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION10T:
+        instruction.literal = static_cast<std::int8_t>(bytes[1]);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION20T:
+        if (bytes[1] != 0)
+            throw exceptions::InvalidInstructionException("Error reading Instruction20t padding must be 0", 4);
+        instruction.literal = read_bytecode<std::int16_t>(bytes, 2);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION20BC:
+        instruction.literal = bytes[1];
+        instruction.index = read_bytecode<std::uint16_t>(bytes, 2);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION22X:
+        instruction.number_of_registers = 2;
+        instruction.registers[0] = bytes[1];
+        instruction.registers[1] = read_bytecode<std::uint16_t>(bytes, 2);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION21T:
+        instruction.number_of_registers = 1;
+        instruction.registers[0] = bytes[1];
+        instruction.literal = read_bytecode<std::int16_t>(bytes, 2);
+        if (instruction.literal == 0)
+            throw exceptions::InvalidInstructionException("Error reading Instruction21t offset cannot be 0", 4);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION21S:
+        instruction.number_of_registers = 1;
+        instruction.registers[0] = bytes[1];
+        instruction.literal = read_bytecode<std::int16_t>(bytes, 2);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION21H:
+        instruction.number_of_registers = 1;
+        instruction.registers[0] = bytes[1];
+        instruction.literal = read_bytecode<std::int16_t>(bytes, 2);
+        if (op == TYPES::opcodes::OP_CONST_HIGH16)
+            instruction.literal <<= 16;
+        else if (op == TYPES::opcodes::OP_CONST_WIDE_HIGH16)
+            instruction.literal <<= 48;
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION21C:
+        instruction.number_of_registers = 1;
+        instruction.registers[0] = bytes[1];
+        instruction.index = read_bytecode<std::uint16_t>(bytes, 2);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION23X:
+        instruction.number_of_registers = 3;
+        instruction.registers[0] = bytes[1];
+        instruction.registers[1] = bytes[2];
+        instruction.registers[2] = bytes[3];
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION22B:
+        instruction.number_of_registers = 2;
+        instruction.registers[0] = bytes[1];
+        instruction.registers[1] = bytes[2];
+        instruction.literal = static_cast<std::int8_t>(bytes[3]);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION22T:
+    case dexinsttype_t::DEX_INSTRUCTION22S:
+        instruction.number_of_registers = 2;
+        instruction.registers[0] = bytes[1] & 0x0F;
+        instruction.registers[1] = (bytes[1] & 0xF0) >> 4;
+        instruction.literal = read_bytecode<std::int16_t>(bytes, 2);
+        if (instruction.format == dexinsttype_t::DEX_INSTRUCTION22T && instruction.literal == 0)
+            throw exceptions::InvalidInstructionException("Error reading Instruction22t offset cannot be 0", 4);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION22C:
+    case dexinsttype_t::DEX_INSTRUCTION22CS:
+        instruction.number_of_registers = 2;
+        instruction.registers[0] = bytes[1] & 0x0F;
+        instruction.registers[1] = (bytes[1] & 0xF0) >> 4;
+        instruction.index = read_bytecode<std::uint16_t>(bytes, 2);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION30T:
+        if (bytes[1] != 0)
+            throw exceptions::InvalidInstructionException("Error reading Instruction30t padding must be 0", 6);
+        instruction.literal = read_bytecode<std::int32_t>(bytes, 2);
+        if (instruction.literal == 0)
+            throw exceptions::InvalidInstructionException("Error reading Instruction30t offset cannot be 0", 6);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION32X:
+        if (bytes[1] != 0)
+            throw exceptions::InvalidInstructionException("Error reading Instruction32x padding must be 0", 6);
+        instruction.number_of_registers = 2;
+        instruction.registers[0] = read_bytecode<std::uint16_t>(bytes, 2);
+        instruction.registers[1] = read_bytecode<std::uint16_t>(bytes, 4);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION31I:
+    case dexinsttype_t::DEX_INSTRUCTION31T:
+        instruction.number_of_registers = 1;
+        instruction.registers[0] = bytes[1];
+        instruction.literal = read_bytecode<std::int32_t>(bytes, 2);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION31C:
+        instruction.number_of_registers = 1;
+        instruction.registers[0] = bytes[1];
+        instruction.index = read_bytecode<std::uint32_t>(bytes, 2);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION35C:
+    case dexinsttype_t::DEX_INSTRUCTION45CC:
+        instruction.number_of_registers = (bytes[1] & 0xF0) >> 4;
+        if (instruction.number_of_registers > 5)
+            throw exceptions::InvalidInstructionException("Error in number of registers, cannot be greater than 5",
+                                                          instruction.length);
+        instruction.registers[0] = bytes[4] & 0x0F;
+        instruction.registers[1] = (bytes[4] & 0xF0) >> 4;
+        instruction.registers[2] = bytes[5] & 0x0F;
+        instruction.registers[3] = (bytes[5] & 0xF0) >> 4;
+        instruction.registers[4] = bytes[1] & 0x0F;
+        instruction.index = read_bytecode<std::uint16_t>(bytes, 2);
+        if (instruction.format == dexinsttype_t::DEX_INSTRUCTION45CC)
+            instruction.second_index = read_bytecode<std::uint16_t>(bytes, 6);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION3RC:
+    case dexinsttype_t::DEX_INSTRUCTION4RCC:
+        instruction.number_of_registers = bytes[1];
+        instruction.registers[0] = read_bytecode<std::uint16_t>(bytes, 4);
+        instruction.index = read_bytecode<std::uint16_t>(bytes, 2);
+        if (instruction.format == dexinsttype_t::DEX_INSTRUCTION4RCC)
+            instruction.second_index = read_bytecode<std::uint16_t>(bytes, 6);
+        break;
+    case dexinsttype_t::DEX_INSTRUCTION51L:
+        instruction.number_of_registers = 1;
+        instruction.registers[0] = bytes[1];
+        instruction.literal = read_bytecode<std::int64_t>(bytes, 2);
+        break;
+    default:
+        // unused opcodes (format 00x), they do not have operands
+        break;
+    }
+}
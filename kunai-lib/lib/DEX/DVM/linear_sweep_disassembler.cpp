@@ -23,7 +23,7 @@ using namespace KUNAI::DEX;
 ///     }
 /// }
 
-void LinearSweepDisassembler::disassembly(std::vector<std::uint8_t> &buffer_bytes,
+void LinearSweepDisassembler::disassembly(std::span<const std::uint8_t> buffer_bytes,
                                           std::vector<std::unique_ptr<Instruction>> &instructions)
 {
     auto logger = LOGGER::logger();
@@ -21,7 +21,7 @@ using namespace KUNAI::DEX;
 ///    }
 ///}
 
-void RecursiveTraversalDisassembler::disassembly(std::vector<std::uint8_t> &buffer_bytes,
+void RecursiveTraversalDisassembler::disassembly(std::span<const std::uint8_t> buffer_bytes,
                                                  EncodedMethod *method,
                                                  std::vector<std::unique_ptr<Instruction>> &instructions)
 {
@@ -155,7 +155,7 @@ void RecursiveTraversalDisassembler::disassembly(std::vector<std::uint8_t> &buff
 void RecursiveTraversalDisassembler::analyze_switch(
     std::vector<std::unique_ptr<Instruction>> &instructions,
     std::unordered_map<std::uint64_t, Instruction *> &cache_instrs,
-    std::vector<std::uint8_t> &buffer_bytes)
+    std::span<const std::uint8_t> buffer_bytes)
 {
     auto instr31t = reinterpret_cast<Instruction31t *>(instructions.back().get());
 
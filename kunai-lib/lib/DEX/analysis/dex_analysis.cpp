@@ -13,17 +13,21 @@
 using namespace KUNAI::DEX;
 
 void Analysis::add(Parser *parser)
+{
+    add(parser, disassembler);
+}
+
+void Analysis::add(Parser *parser, DexDisassembler *parser_disassembler)
 {
     auto logger = LOGGER::logger();
 
     parsers.push_back(parser);
+    parser_disassemblers[parser] = parser_disassembler;
 
     auto &class_dex = parser->get_classes();
 
     logger->debug("Addind to the analysis {} number of classes", class_dex.get_number_of_classes());
 
-    auto & all_methods_instructions = disassembler->get_dex_instructions();
-
     for (auto &class_def_item : class_dex.get_classdefs())
     {
         /// save the class with the name
@@ -42,7 +46,8 @@ void Analysis::add(Parser *parser)
             /// now create a method analysis
             auto method_name = method_id->pretty_method();
 
-            methods[method_name] = std::make_unique<MethodAnalysis>(encoded_method, all_methods_instructions[encoded_method]);
+            // the instructions are disassembled when they are needed
+            methods[method_name] = std::make_unique<MethodAnalysis>(encoded_method, parser_disassembler);
             auto new_method = methods[method_name].get();
 
             new_class->add_method(new_method);
@@ -74,27 +79,57 @@ void Analysis::create_xrefs()
 
     for (auto parser : parsers)
     {
-        static size_t i = 0;
-        logger->debug("Analyzing {} parser", i++);
+        // the xrefs loaded from a snapshot do not need to go
+        // through the instructions again
+        auto it = xref_records.find(parser);
 
-        auto &class_dex = parser->get_classes();
-        auto &class_def_items = class_dex.get_classdefs();
+        if (it == xref_records.end())
+        {
+            auto &records = xref_records[parser];
+            std::uint32_t method_position = 0;
 
-        logger->debug("Number of classes to analyze: {}", class_dex.get_number_of_classes());
+            auto &class_dex = parser->get_classes();
 
-        for (auto &class_def_item : class_def_items)
-        {
-            static size_t j = 0;
-            logger->debug("Analyzing class number {}", j++);
+            logger->debug("Number of classes to analyze: {}", class_dex.get_number_of_classes());
 
-            _create_xrefs(class_def_item.get());
+            for (auto &class_def_item : class_dex.get_classdefs())
+                _collect_xrefs(parser, class_def_item.get(), method_position, records);
+
+            it = xref_records.find(parser);
         }
+
+        _apply_xrefs(parser, it->second);
     }
 
     logger->info("Cross-references correctly created");
 }
 
-void Analysis::_create_xrefs(ClassDef *current_class)
+bool Analysis::set_xrefs(Parser *parser, std::vector<xref_record_t> &&records)
+{
+    if (!_check_xrefs(parser, records))
+        return false;
+
+    xref_records[parser] = std::move(records);
+
+    return true;
+}
+
+const std::vector<xref_record_t> &Analysis::get_xrefs(Parser *parser)
+{
+    static const std::vector<xref_record_t> no_xrefs;
+
+    auto it = xref_records.find(parser);
+
+    if (it == xref_records.end())
+        return no_xrefs;
+
+    return it->second;
+}
+
+void Analysis::_collect_xrefs(Parser *parser,
+                              ClassDef *current_class,
+                              std::uint32_t &method_position,
+                              std::vector<xref_record_t> &records)
 {
     auto logger = LOGGER::logger();
 
@@ -102,150 +137,103 @@ void Analysis::_create_xrefs(ClassDef *current_class)
     auto &current_class_name = current_class->get_class_idx()->get_name();
     auto &class_data_item = current_class->get_class_data_item();
 
-    auto class_analysis_working_on = classes[current_class_name].get();
-
     /// get all the methods
     auto &current_methods = class_data_item.get_methods();
 
+    /// the instructions are decoded in the flat representation,
+    /// only the ids are needed and the ids are checked here
+    FlatInstructions flat_instructions;
+
+    /// the recursive traversal does not decode the bytecode that is
+    /// not reachable, so only its instructions give xrefs
+    auto parser_disassembler = parser_disassemblers[parser];
+    bool recursive_traversal = parser_disassembler != nullptr &&
+                               parser_disassembler->get_disassembly_algorithm() ==
+                                   DexDisassembler::disassembly_algorithm::RECURSIVE_TRAVERSAL_ALGORITHM;
+    std::vector<std::uint64_t> addresses;
+
     for (auto &method : current_methods)
     {
-        // Obtain the MethodAnalysis*
-        auto current_method_analysis = methods[method->getMethodID()->pretty_method()].get();
+        auto position = method_position++;
+
+        if (recursive_traversal)
+        {
+            addresses.clear();
 
-        for (auto &instr : current_method_analysis->get_instructions())
+            for (const auto &instr : parser_disassembler->disassemble_method(method))
+                addresses.push_back(instr->get_address());
+
+            flat_instructions.disassembly(method->get_code_item().get_bytecode(), addresses);
+        }
+        else
+            flat_instructions.disassembly(method->get_code_item().get_bytecode());
+
+        for (const auto &instr : flat_instructions.get_instructions())
         {
-            auto off = instr->get_address();
-            auto instruction = instr.get();
-            auto op_value = instr->get_instruction_opcode();
+            auto off = instr.address;
+            std::uint32_t op_value = instr.opcode;
+
+            if (instr.format == dexinsttype_t::DEX_DALVIKINCORRECT)
+                continue;
 
             // check for: `const-class` and `new-instance` instructions
             if (op_value == TYPES::opcodes::OP_CONST_CLASS ||
                 op_value == TYPES::opcodes::OP_NEW_INSTANCE)
             {
-                auto const_class_new_instance = reinterpret_cast<Instruction21c *>(instruction);
+                // check we get a class, not a fundamental
+                // type or an array
+                auto type = parser->get_types().try_get_type_from_order(instr.index);
 
-                // check we get a TYPE from CONST_CLASS
-                // or from NEW_INSTANCE, any other Kind (FIELD, PROTO, etc)
-                // it is not valid in this case
-                if (const_class_new_instance->get_kind() != TYPES::Kind::TYPE ||
-                    const_class_new_instance->get_source_dvmtype()->get_type() != DVMType::CLASS)
+                if (type == nullptr || type->get_type() != DVMType::CLASS)
                     continue;
 
-                auto cls_name = const_class_new_instance->get_source_dvmclass()->get_name();
-
                 // avoid analyzing our own class name
-                if (cls_name == current_class_name)
+                if (reinterpret_cast<DVMClass *>(type)->get_name() == current_class_name)
                     continue;
 
-                // if the name of the class is not already in the classes,
-                // probably we are treating with an external class
-                if (classes.find(cls_name) == classes.end())
-                {
-                    external_classes[cls_name] = std::make_unique<ExternalClass>(cls_name);
-                    classes[cls_name] = std::make_unique<ClassAnalysis>(external_classes[cls_name].get());
-                }
-
-                auto oth_cls = classes[cls_name].get();
-
-                /// add the cross references
-                class_analysis_working_on->add_xref_to(static_cast<TYPES::REF_TYPE>(op_value),
-                                                       oth_cls, current_method_analysis, off);
-                oth_cls->add_xref_from(static_cast<TYPES::REF_TYPE>(op_value),
-                                       class_analysis_working_on, current_method_analysis, off);
-
-                /// check if is a const-class
-                if (op_value == TYPES::opcodes::OP_CONST_CLASS)
-                {
-                    current_method_analysis->add_xrefconstclass(oth_cls, off);
-                    oth_cls->add_xref_const_class(current_method_analysis, off);
-                }
-                /// check if it is a new instance
-                else if (op_value == TYPES::opcodes::OP_NEW_INSTANCE)
-                {
-                    current_method_analysis->add_xrefnewinstance(oth_cls, off);
-                    oth_cls->add_xref_new_instance(current_method_analysis, off);
-                }
+                records.push_back({position, off, instr.index, op_value});
             }
 
             /// check for instructions like: invoke-*
             else if (TYPES::opcodes::OP_INVOKE_VIRTUAL <= op_value &&
                      op_value <= TYPES::opcodes::OP_INVOKE_INTERFACE)
             {
-                auto invoke_ = reinterpret_cast<Instruction35c *>(instruction);
+                auto method_called = parser->get_methods().try_get_method(instr.index);
 
-                // get the invoke of method
-                if (invoke_->get_kind() != TYPES::Kind::METH)
+                if (method_called == nullptr)
                     continue;
 
                 /// check that called method comes from a class
                 /// (not from other type like an Array)
-                if (invoke_->get_method()->get_class()->get_type() != DVMType::CLASS)
+                if (method_called->get_class()->get_type() != DVMType::CLASS)
                 {
                     logger->warn("Found a call to a method from non class (type found {})",
-                                 invoke_->get_method()->get_class()->print_type());
+                                 method_called->get_class()->print_type());
                     continue;
                 }
 
-                auto method_called = invoke_->get_method();
-
-                auto &cls_name = reinterpret_cast<DVMClass *>(method_called->get_class())->get_name();
-                auto &method_name = method_called->get_name();
-                auto &proto = method_called->get_proto()->get_shorty_idx();
-
-                /// information of method and class called
-                auto oth_meth = _resolve_method(cls_name, method_name, proto);
-                auto oth_cls = classes[cls_name].get();
-
-                class_analysis_working_on->add_method_xref_to(current_method_analysis, oth_cls, oth_meth, off);
-                oth_cls->add_method_xref_from(oth_meth, class_analysis_working_on, current_method_analysis, off);
-
-                class_analysis_working_on->add_xref_to(static_cast<TYPES::REF_TYPE>(op_value), oth_cls, oth_meth, off);
-                oth_cls->add_xref_from(static_cast<TYPES::REF_TYPE>(op_value), class_analysis_working_on, current_method_analysis, off);
+                records.push_back({position, off, instr.index, op_value});
             }
             /// check for instructions like: invoke-xxx/range
             else if (TYPES::opcodes::OP_INVOKE_VIRTUAL_RANGE <= op_value &&
                      op_value <= TYPES::opcodes::OP_INVOKE_INTERFACE_RANGE)
             {
-                auto invoke_xxx_range = reinterpret_cast<Instruction3rc *>(instruction);
+                auto method_called = parser->get_methods().try_get_method(instr.index);
 
-                // check if we are calling something different to a method
-                if (invoke_xxx_range->get_kind() != TYPES::Kind::METH)
+                if (method_called == nullptr ||
+                    method_called->get_class()->get_type() != DVMType::CLASS)
                     continue;
 
-                auto method_id = invoke_xxx_range->get_operand_method();
-
-                auto &cls_name = reinterpret_cast<DVMClass *>(method_id->get_class())->get_name();
-                auto &method_name = method_id->get_name();
-                auto &proto = method_id->get_proto()->get_shorty_idx();
-
-                auto oth_meth = _resolve_method(cls_name, method_name, proto);
-                auto oth_cls = classes[cls_name].get();
-
-                class_analysis_working_on->add_method_xref_to(
-                    current_method_analysis, oth_cls, oth_meth, off);
-                oth_cls->add_method_xref_from(
-                    oth_meth, class_analysis_working_on, current_method_analysis, off);
-
-                class_analysis_working_on->add_xref_to(
-                    static_cast<TYPES::REF_TYPE>(op_value), oth_cls, oth_meth, off);
-                oth_cls->add_xref_from(
-                    static_cast<TYPES::REF_TYPE>(op_value), class_analysis_working_on, current_method_analysis, off);
+                records.push_back({position, off, instr.index, op_value});
             }
 
             // now check for string usage: const-string
             else if (op_value == TYPES::opcodes::OP_CONST_STRING)
             {
-                auto const_string = reinterpret_cast<Instruction21c *>(instruction);
-
-                if (!const_string->is_source_string())
+                if (instr.index >= parser->get_strings().get_number_of_strings())
                     continue;
 
-                auto &string_value = const_string->get_source_str();
-
-                if (strings.find(string_value) == strings.end())
-                    strings[string_value] = std::make_unique<StringAnalysis>(string_value);
-
-                strings[string_value]->add_xreffrom(class_analysis_working_on, current_method_analysis, off);
+                records.push_back({position, off, instr.index, op_value});
             }
 
             /// check now for field usage, we first
@@ -254,85 +242,207 @@ void Analysis::_create_xrefs(ClassDef *current_class)
             else if (TYPES::opcodes::OP_IGET <= op_value &&
                      op_value <= TYPES::opcodes::OP_IPUT_SHORT)
             {
-                auto op_i = reinterpret_cast<Instruction22c *>(instruction);
-                auto checked_field = op_i->get_checked_field();
+                auto checked_field = parser->get_fields().try_get_field(instr.index);
 
-                if (op_i->get_kind() != TYPES::Kind::FIELD ||
-                    checked_field == nullptr)
+                /// the fields of other DEX files have no EncodedField
+                if (checked_field == nullptr ||
+                    checked_field->get_encoded_field() == nullptr)
                     continue;
 
-                auto operation = DalvikOpcodes::get_instruction_operation(op_i->get_instruction_opcode());
-
-                /// is a read operation?
-                if (operation == TYPES::Operation::FIELD_READ_DVM_OPCODE)
-                {
-                    // retrieve the encoded field from the FieldID
-                    auto field_item = checked_field->get_encoded_field();
-
-                    classes[current_class_name]->add_field_xref_read(
-                        current_method_analysis, class_analysis_working_on, field_item, off);
-
-                    // necessary to give a field analysis to the add_xref_read method
-                    // we can get the created by the add_field_xref_read.
-                    auto field_analysis = classes[current_class_name]->get_field_analysis(field_item);
-                    current_method_analysis->add_xrefread(class_analysis_working_on, field_analysis, off);
-                }
-                /// is a write operation?
-                else if (operation == TYPES::Operation::FIELD_WRITE_DVM_OPCODE)
-                {
-                    // retrieve the encoded field from the FieldID
-                    auto field_item = checked_field->get_encoded_field();
-
-                    classes[current_class_name]->add_field_xref_write(
-                        current_method_analysis, class_analysis_working_on, field_item, off);
-
-                    // same as before
-                    auto field_analysis = classes[current_class_name]->get_field_analysis(field_item);
-
-                    current_method_analysis->add_xrefwrite(class_analysis_working_on, field_analysis, off);
-                }
+                records.push_back({position, off, instr.index, op_value});
             }
             /// now time to check OP_SGET to OP_SPUT_SHORT
             else if (TYPES::opcodes::OP_SGET <= op_value &&
                      op_value <= TYPES::opcodes::OP_SPUT_SHORT)
             {
-                auto op_s = reinterpret_cast<Instruction21c *>(instruction);
-                auto checked_field = op_s->get_source_field();
+                auto checked_field = parser->get_fields().try_get_field(instr.index);
 
-                /// if the instruction is not a FIELD Kind instruction
                 /// if there are not checked field, or the EncodedField
                 /// of the Field is nullptr (an external field), leave!
-                if (op_s->get_kind() != TYPES::Kind::FIELD ||
-                    checked_field == nullptr ||
+                if (checked_field == nullptr ||
                     checked_field->get_encoded_field() == nullptr)
                     continue;
 
-                auto operation = DalvikOpcodes::get_instruction_operation(op_s->get_instruction_opcode());
+                records.push_back({position, off, instr.index, op_value});
+            }
+        }
+    }
+}
 
-                // is read operation
-                if (operation == TYPES::Operation::FIELD_READ_DVM_OPCODE)
-                {
-                    auto field_item = checked_field->get_encoded_field();
+bool Analysis::_check_xrefs(Parser *parser, const std::vector<xref_record_t> &records)
+{
+    auto logger = LOGGER::logger();
+    std::size_t number_of_methods = 0;
 
-                    classes[current_class_name]->add_field_xref_read(
-                        current_method_analysis, class_analysis_working_on, field_item, off);
+    for (auto &class_def_item : parser->get_classes().get_classdefs())
+        number_of_methods += class_def_item->get_class_data_item().get_methods().size();
 
-                    /// necessary to give a field analysis to the add_xref_read method
-                    /// we can get the created by the add_field_xref_read.
-                    auto field_analysis = classes[current_class_name]->get_field_analysis(field_item);
-                    current_method_analysis->add_xrefread(class_analysis_working_on, field_analysis, off);
-                }
-                else if (operation == TYPES::Operation::FIELD_WRITE_DVM_OPCODE)
-                {
-                    auto field_item = checked_field->get_encoded_field();
+    for (const auto &record : records)
+    {
+        auto op_value = record.opcode;
+        bool correct = false;
+
+        if (op_value == TYPES::opcodes::OP_CONST_CLASS ||
+                 op_value == TYPES::opcodes::OP_NEW_INSTANCE)
+        {
+            auto type = parser->get_types().try_get_type_from_order(record.target);
 
-                    classes[current_class_name]->add_field_xref_write(
-                        current_method_analysis, class_analysis_working_on, field_item, off);
+            correct = type != nullptr && type->get_type() == DVMType::CLASS;
+        }
+        else if ((TYPES::opcodes::OP_INVOKE_VIRTUAL <= op_value &&
+                  op_value <= TYPES::opcodes::OP_INVOKE_INTERFACE) ||
+                 (TYPES::opcodes::OP_INVOKE_VIRTUAL_RANGE <= op_value &&
+                  op_value <= TYPES::opcodes::OP_INVOKE_INTERFACE_RANGE))
+        {
+            auto method_called = parser->get_methods().try_get_method(record.target);
 
-                    /// same as before
-                    auto field_analysis = classes[current_class_name]->get_field_analysis(field_item);
-                    current_method_analysis->add_xrefwrite(class_analysis_working_on, field_analysis, off);
-                }
+            correct = method_called != nullptr &&
+                      method_called->get_class()->get_type() == DVMType::CLASS;
+        }
+        else if (op_value == TYPES::opcodes::OP_CONST_STRING)
+            correct = parser->get_strings().try_get_string_by_id(record.target) != nullptr;
+        else if ((TYPES::opcodes::OP_IGET <= op_value &&
+                  op_value <= TYPES::opcodes::OP_IPUT_SHORT) ||
+                 (TYPES::opcodes::OP_SGET <= op_value &&
+                  op_value <= TYPES::opcodes::OP_SPUT_SHORT))
+        {
+            auto field = parser->get_fields().try_get_field(record.target);
+
+            correct = field != nullptr && field->get_encoded_field() != nullptr;
+        }
+
+        if (!correct || record.method >= number_of_methods)
+        {
+            logger->warn("_check_xrefs(): incorrect xref in method {} offset {} (opcode {}, target {})",
+                         record.method, record.offset, record.opcode, record.target);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Analysis::_apply_xrefs(Parser *parser, const std::vector<xref_record_t> &records)
+{
+    /// classes and methods of the parser in the same order
+    /// used when the records were collected
+    std::vector<std::pair<ClassAnalysis *, MethodAnalysis *>> methods_by_position;
+
+    for (auto &class_def_item : parser->get_classes().get_classdefs())
+    {
+        auto class_analysis = classes[class_def_item->get_class_idx()->get_name()].get();
+
+        for (auto method : class_def_item->get_class_data_item().get_methods())
+            methods_by_position.push_back({class_analysis, methods[method->getMethodID()->pretty_method()].get()});
+    }
+
+    for (const auto &record : records)
+    {
+        if (record.method >= methods_by_position.size())
+            throw exceptions::AnalysisException("_apply_xrefs(): method of the xref out of bound");
+
+        auto [class_analysis_working_on, current_method_analysis] = methods_by_position[record.method];
+        auto off = record.offset;
+        auto op_value = record.opcode;
+
+        if (op_value == TYPES::opcodes::OP_CONST_CLASS ||
+            op_value == TYPES::opcodes::OP_NEW_INSTANCE)
+        {
+            auto &cls_name = reinterpret_cast<DVMClass *>(parser->get_types().get_type_from_order(record.target))->get_name();
+
+            // if the name of the class is not already in the classes,
+            // probably we are treating with an external class
+            if (classes.find(cls_name) == classes.end())
+            {
+                external_classes[cls_name] = std::make_unique<ExternalClass>(cls_name);
+                classes[cls_name] = std::make_unique<ClassAnalysis>(external_classes[cls_name].get());
+            }
+
+            auto oth_cls = classes[cls_name].get();
+
+            /// add the cross references
+            class_analysis_working_on->add_xref_to(static_cast<TYPES::REF_TYPE>(op_value),
+                                                   oth_cls, current_method_analysis, off);
+            oth_cls->add_xref_from(static_cast<TYPES::REF_TYPE>(op_value),
+                                   class_analysis_working_on, current_method_analysis, off);
+
+            /// check if is a const-class
+            if (op_value == TYPES::opcodes::OP_CONST_CLASS)
+            {
+                current_method_analysis->add_xrefconstclass(oth_cls, off);
+                oth_cls->add_xref_const_class(current_method_analysis, off);
+            }
+            /// check if it is a new instance
+            else if (op_value == TYPES::opcodes::OP_NEW_INSTANCE)
+            {
+                current_method_analysis->add_xrefnewinstance(oth_cls, off);
+                oth_cls->add_xref_new_instance(current_method_analysis, off);
+            }
+        }
+        /// invoke-* and invoke-xxx/range
+        else if ((TYPES::opcodes::OP_INVOKE_VIRTUAL <= op_value &&
+                  op_value <= TYPES::opcodes::OP_INVOKE_INTERFACE) ||
+                 (TYPES::opcodes::OP_INVOKE_VIRTUAL_RANGE <= op_value &&
+                  op_value <= TYPES::opcodes::OP_INVOKE_INTERFACE_RANGE))
+        {
+            auto method_called = parser->get_methods().get_method(record.target);
+
+            auto &cls_name = reinterpret_cast<DVMClass *>(method_called->get_class())->get_name();
+            auto &method_name = method_called->get_name();
+            auto &proto = method_called->get_proto()->get_shorty_idx();
+
+            /// information of method and class called
+            auto oth_meth = _resolve_method(cls_name, method_name, proto);
+            auto oth_cls = classes[cls_name].get();
+
+            class_analysis_working_on->add_method_xref_to(current_method_analysis, oth_cls, oth_meth, off);
+            oth_cls->add_method_xref_from(oth_meth, class_analysis_working_on, current_method_analysis, off);
+
+            class_analysis_working_on->add_xref_to(static_cast<TYPES::REF_TYPE>(op_value), oth_cls, oth_meth, off);
+            oth_cls->add_xref_from(static_cast<TYPES::REF_TYPE>(op_value), class_analysis_working_on, current_method_analysis, off);
+        }
+        // now check for string usage: const-string
+        else if (op_value == TYPES::opcodes::OP_CONST_STRING)
+        {
+            auto &string_value = parser->get_strings().get_string_by_id(record.target);
+
+            if (strings.find(string_value) == strings.end())
+                strings[string_value] = std::make_unique<StringAnalysis>(string_value);
+
+            strings[string_value]->add_xreffrom(class_analysis_working_on, current_method_analysis, off);
+        }
+        /// field usage from OP_IGET to OP_IPUT_SHORT
+        /// and from OP_SGET to OP_SPUT_SHORT
+        else if ((TYPES::opcodes::OP_IGET <= op_value &&
+                  op_value <= TYPES::opcodes::OP_IPUT_SHORT) ||
+                 (TYPES::opcodes::OP_SGET <= op_value &&
+                  op_value <= TYPES::opcodes::OP_SPUT_SHORT))
+        {
+            // retrieve the encoded field from the FieldID
+            auto field_item = parser->get_fields().get_field(record.target)->get_encoded_field();
+
+            auto operation = DalvikOpcodes::get_instruction_operation(op_value);
+
+            /// is a read operation?
+            if (operation == TYPES::Operation::FIELD_READ_DVM_OPCODE)
+            {
+                class_analysis_working_on->add_field_xref_read(
+                    current_method_analysis, class_analysis_working_on, field_item, off);
+
+                // necessary to give a field analysis to the add_xref_read method
+                // we can get the created by the add_field_xref_read.
+                auto field_analysis = class_analysis_working_on->get_field_analysis(field_item);
+                current_method_analysis->add_xrefread(class_analysis_working_on, field_analysis, off);
+            }
+            /// is a write operation?
+            else if (operation == TYPES::Operation::FIELD_WRITE_DVM_OPCODE)
+            {
+                class_analysis_working_on->add_field_xref_write(
+                    current_method_analysis, class_analysis_working_on, field_item, off);
+
+                // same as before
+                auto field_analysis = class_analysis_working_on->get_field_analysis(field_item);
+                current_method_analysis->add_xrefwrite(class_analysis_working_on, field_analysis, off);
             }
         }
     }
@@ -96,6 +96,15 @@ const std::string &MethodAnalysis::get_full_name() const
     return full_name;
 }
 
+void MethodAnalysis::analyze_method()
+{
+    if (dex_disassembler != nullptr)
+        method_instructions = &dex_disassembler->disassemble_method(std::get<EncodedMethod *>(method_encoded));
+
+    if (method_instructions->size() > 0)
+        create_basic_blocks();
+}
+
 void MethodAnalysis::create_basic_blocks()
 {
     /// utilities to create the basic blocks
@@ -123,7 +132,7 @@ void MethodAnalysis::create_basic_blocks()
     basic_blocks.add_edge(start, current);
 
     // detect the targets of the jumps and switches
-    for (const auto &instruction : instructions)
+    for (const auto &instruction : *method_instructions)
     {
         auto operation = DalvikOpcodes::get_instruction_operation(instruction->get_instruction_opcode());
 
@@ -154,7 +163,7 @@ void MethodAnalysis::create_basic_blocks()
         }
     }
 
-    for (const auto &instruction : instructions)
+    for (const auto &instruction : *method_instructions)
     {
         auto idx = instruction->get_address();
         auto ins = instruction.get();
@@ -0,0 +1,134 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file snapshot.cpp
+
+#include "Kunai/DEX/analysis/snapshot.hpp"
+#include "Kunai/Exceptions/stream_exception.hpp"
+#include "Kunai/Utils/logger.hpp"
+#include "Kunai/Utils/mapped_file.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace KUNAI::DEX;
+
+namespace
+{
+    const std::uint8_t snapshot_magic[8] = {'K', 'U', 'N', 'A', 'I', 'S', 'N', 'P'};
+} // namespace
+
+std::string Snapshot::get_snapshot_path(const std::string &snapshot_directory,
+                                        const utils::Sha1::digest_t &dex_digest,
+                                        DexDisassembler::disassembly_algorithm algorithm)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    std::string path = snapshot_directory + "/";
+
+    for (auto byte : dex_digest)
+    {
+        path += hex_digits[byte >> 4];
+        path += hex_digits[byte & 0xf];
+    }
+
+    if (algorithm == DexDisassembler::disassembly_algorithm::RECURSIVE_TRAVERSAL_ALGORITHM)
+        return path + "-recursive.ksnp";
+
+    return path + "-linear.ksnp";
+}
+
+bool Snapshot::load_xrefs(const std::string &snapshot_path,
+                          const utils::Sha1::digest_t &dex_digest,
+                          DexDisassembler::disassembly_algorithm algorithm,
+                          std::vector<xref_record_t> &records)
+{
+    auto logger = LOGGER::logger();
+    std::unique_ptr<stream::MappedFile> mapped_file;
+    snapshot_header_t header;
+
+    try
+    {
+        mapped_file = std::make_unique<stream::MappedFile>(snapshot_path);
+    }
+    catch (const exceptions::StreamException &e)
+    {
+        logger->debug("snapshot.cpp: no snapshot in {}", snapshot_path);
+        return false;
+    }
+
+    auto buffer = mapped_file->get_span();
+
+    if (buffer.size() < sizeof(snapshot_header_t))
+        return false;
+
+    std::memcpy(&header, buffer.data(), sizeof(snapshot_header_t));
+
+    if (memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) ||
+        header.version != snapshot_version ||
+        header.record_size != sizeof(xref_record_t) ||
+        header.dex_digest != dex_digest ||
+        header.algorithm != static_cast<std::uint32_t>(algorithm))
+    {
+        logger->warn("snapshot.cpp: snapshot {} is not valid for the dex file", snapshot_path);
+        return false;
+    }
+
+    if (header.number_of_records > (buffer.size() - sizeof(snapshot_header_t)) / sizeof(xref_record_t))
+    {
+        logger->warn("snapshot.cpp: snapshot {} is truncated", snapshot_path);
+        return false;
+    }
+
+    records.resize(header.number_of_records);
+
+    if (!records.empty())
+        std::memcpy(records.data(), buffer.data() + sizeof(snapshot_header_t),
+                    records.size() * sizeof(xref_record_t));
+
+    logger->debug("snapshot.cpp: loaded {} xrefs from {}", records.size(), snapshot_path);
+
+    return true;
+}
+
+bool Snapshot::save_xrefs(const std::string &snapshot_path,
+                          const utils::Sha1::digest_t &dex_digest,
+                          DexDisassembler::disassembly_algorithm algorithm,
+                          const std::vector<xref_record_t> &records)
+{
+    auto logger = LOGGER::logger();
+    snapshot_header_t header = {};
+
+    std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+    header.version = snapshot_version;
+    header.record_size = sizeof(xref_record_t);
+    header.dex_digest = dex_digest;
+    header.algorithm = static_cast<std::uint32_t>(algorithm);
+    header.number_of_records = records.size();
+
+    // write first in a temporary file, so a snapshot
+    // that is being written is never loaded
+    std::string temporal_path = snapshot_path + ".tmp";
+    std::ofstream snapshot(temporal_path, std::ofstream::binary | std::ofstream::trunc);
+
+    if (!snapshot.is_open())
+    {
+        logger->warn("snapshot.cpp: cannot create snapshot {}", snapshot_path);
+        return false;
+    }
+
+    snapshot.write(reinterpret_cast<const char *>(&header), sizeof(snapshot_header_t));
+    snapshot.write(reinterpret_cast<const char *>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(xref_record_t)));
+    snapshot.close();
+
+    if (!snapshot || std::rename(temporal_path.c_str(), snapshot_path.c_str()) != 0)
+    {
+        logger->warn("snapshot.cpp: error writing snapshot {}", snapshot_path);
+        std::remove(temporal_path.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -12,55 +12,120 @@ void Dex::initialization(std::string& dex_file_path)
 {
     auto logger = LOGGER::logger();
 
-    dex_file.open(dex_file_path, std::ifstream::binary);
-    
-    kunai_stream = std::make_unique<stream::KunaiStream>(dex_file);
-    parser = std::make_unique<Parser>(kunai_stream.get());
-
     try
     {
-        parser->parse_file();
-        parsing_correct = true;
-        dex_disassembler = std::make_unique<DexDisassembler>(parser.get());
+        // read the file directly from memory when possible
+        mapped_file = std::make_unique<stream::MappedFile>(dex_file_path);
+        kunai_stream = std::make_unique<stream::KunaiStream>(mapped_file->get_span());
     }
-    catch(const std::exception& e)
+    catch (const exceptions::StreamException& e)
     {
-        logger->error("dex.cpp: {}", e.what());
-        parsing_correct = false;
+        logger->debug("dex.cpp: file cannot be mapped ({}), using ifstream", e.what());
+        mapped_file.reset();
+        dex_file.open(dex_file_path, std::ifstream::binary);
+        kunai_stream = std::make_unique<stream::KunaiStream>(dex_file);
     }
+
+    parse();
+}
+
+void Dex::initialization(std::span<const std::uint8_t> buffer)
+{
+    kunai_stream = std::make_unique<stream::KunaiStream>(buffer);
+
+    parse();
+}
+
+void Dex::parse()
+{
+    auto logger = LOGGER::logger();
+
+    parser = std::make_unique<Parser>(kunai_stream.get(), parser_options);
+
+    auto &diagnostic = parser->try_parse_file();
+
+    parsing_correct = diagnostic.is_correct();
+
+    // without the classes there is nothing to disassemble
+    if (parsing_correct && parser_options.parse_level >= parse_level_e::CLASS_DEFS)
+        dex_disassembler = std::make_unique<DexDisassembler>(parser.get());
+    else if (!parsing_correct)
+        logger->error("dex.cpp: {}", diagnostic.message);
 }
 
 Analysis * Dex::get_analysis(bool create_xrefs)
 {
-    if (!parsing_correct)
+    if (!parsing_correct || dex_disassembler == nullptr)
         return nullptr;
-    /// disassembly the dex file
-    dex_disassembler->disassembly_dex();
-    /// check if disassembly was correct
-    if (!dex_disassembler->correct_disassembly())
-        return nullptr;
-    
+
+    /// the methods are disassembled on demand, the xrefs
+    /// decode the bytecode of the methods by themselves
     analysis = std::make_unique<Analysis>(parser.get(), dex_disassembler.get(), create_xrefs);
 
     return analysis.get();
 }
 
+Analysis * Dex::get_analysis(bool create_xrefs, const std::string& snapshot_directory)
+{
+    auto logger = LOGGER::logger();
 
-std::unique_ptr<Dex> Dex::parse_dex_file(std::string& dex_file_path)
+    if (get_analysis(create_xrefs) == nullptr)
+        return nullptr;
+
+    if (!create_xrefs)
+        return analysis.get();
+
+    // the snapshots are named by the SHA-1 of the DEX file and the
+    // algorithm, the recursive traversal gives no xrefs of dead code
+    auto dex_digest = parser->get_header_const().compute_signature(kunai_stream.get());
+    auto algorithm = dex_disassembler->get_disassembly_algorithm();
+    auto snapshot_path = Snapshot::get_snapshot_path(snapshot_directory, dex_digest, algorithm);
+    std::vector<xref_record_t> records;
+
+    bool loaded = Snapshot::load_xrefs(snapshot_path, dex_digest, algorithm, records);
+
+    // with the xrefs of the snapshot the instructions
+    // of the methods are not decoded for the xrefs
+    if (loaded && !analysis->set_xrefs(parser.get(), std::move(records)))
+    {
+        logger->warn("dex.cpp: snapshot {} does not match the dex file, creating the xrefs again", snapshot_path);
+        loaded = false;
+    }
+
+    analysis->create_xrefs();
+
+    if (!loaded && !Snapshot::save_xrefs(snapshot_path, dex_digest, algorithm, analysis->get_xrefs(parser.get())))
+        logger->warn("dex.cpp: snapshot of the analysis not saved");
+
+    return analysis.get();
+}
+
+
+std::unique_ptr<Dex> Dex::parse_dex_file(std::string& dex_file_path, const parser_options_t& options)
 {
-    return std::make_unique<Dex>(dex_file_path);
+    return std::make_unique<Dex>(dex_file_path, options);
 }
 
-std::unique_ptr<Dex> Dex::parse_dex_file(char * dex_file_path)
+std::unique_ptr<Dex> Dex::parse_dex_file(char * dex_file_path, const parser_options_t& options)
 {
     std::string dex_path(dex_file_path);
 
-    return std::make_unique<Dex>(dex_path);
+    return std::make_unique<Dex>(dex_path, options);
 }
 
-std::unique_ptr<Dex> Dex::parse_dex_file(const char * dex_file_path)
+std::unique_ptr<Dex> Dex::parse_dex_file(const char * dex_file_path, const parser_options_t& options)
 {
     std::string dex_path(dex_file_path);
 
-    return std::make_unique<Dex>(dex_path);
-}
\ No newline at end of file
+    return std::make_unique<Dex>(dex_path, options);
+}
+
+std::unique_ptr<Dex> Dex::parse_dex_buffer(std::span<const std::uint8_t> buffer, const parser_options_t& options)
+{
+    return std::make_unique<Dex>(buffer, options);
+}
+
+std::unique_ptr<Dex> Dex::parse_dex_buffer(std::vector<std::uint8_t>&& buffer, const parser_options_t& options)
+{
+    return std::make_unique<Dex>(std::move(buffer), options);
+}
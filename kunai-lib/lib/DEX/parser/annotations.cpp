@@ -8,8 +8,31 @@
 #include "Kunai/DEX/parser/annotations.hpp"
 #include "Kunai/Exceptions/incorrectid_exception.hpp"
 
+#include <algorithm>
+#include <tuple>
+
 using namespace KUNAI::DEX;
 
+namespace
+{
+    /// @brief Find an annotation by its idx in a vector sorted by idx
+    /// @param annotations vector of annotations
+    /// @param idx idx of the field or method
+    /// @param get_idx function to obtain the idx of an annotation
+    /// @return pointer to the annotation or nullptr
+    template <typename T, typename F>
+    T *find_annotation(std::vector<std::unique_ptr<T>> &annotations, std::uint32_t idx, F get_idx)
+    {
+        auto it = std::lower_bound(annotations.begin(), annotations.end(), idx,
+                                   [&](const std::unique_ptr<T> &annotation, std::uint32_t value)
+                                   { return get_idx(annotation.get()) < value; });
+
+        if (it == annotations.end() || get_idx(it->get()) != idx)
+            return nullptr;
+        return it->get();
+    }
+} // namespace
+
 void AnnotationDirectoryItem::parse_annotation_directory_item(stream::KunaiStream* stream)
 {
     auto current_offset = stream->tellg();
@@ -40,7 +63,6 @@ void AnnotationDirectoryItem::parse_annotation_directory_item(stream::KunaiStrea
         stream->read_data<std::uint32_t>(annotations_off, sizeof(std::uint32_t));
         fieldannotation = std::make_unique<FieldAnnotation>(idx, annotations_off);
         field_annotations.push_back(std::move(fieldannotation));
-        field_annotations_by_id[idx] = field_annotations.back().get();
     }
 
     for (I = 0; I < annotated_methods_size; ++I)
@@ -49,7 +71,6 @@ void AnnotationDirectoryItem::parse_annotation_directory_item(stream::KunaiStrea
         stream->read_data<std::uint32_t>(annotations_off, sizeof(std::uint32_t));
         methodannotation = std::make_unique<MethodAnnotation>(idx, annotations_off);
         method_annotations.push_back(std::move(methodannotation));
-        method_annotations_by_id[idx] = method_annotations.back().get();
     }
 
     for (I = 0; I < annotated_parameters_size; ++I)
@@ -60,35 +81,157 @@ void AnnotationDirectoryItem::parse_annotation_directory_item(stream::KunaiStrea
         parameter_annotations.push_back(std::move(parameterannotation));
     }
 
+    // the lists must be sorted by idx, but sort them in case
+    // the DEX file does not follow it, the lookups use binary search
+    std::stable_sort(field_annotations.begin(), field_annotations.end(),
+                     [](const fieldannotation_t &a, const fieldannotation_t &b)
+                     { return a->get_field_idx() < b->get_field_idx(); });
+    std::stable_sort(method_annotations.begin(), method_annotations.end(),
+                     [](const methodannotation_t &a, const methodannotation_t &b)
+                     { return a->get_method_idx() < b->get_method_idx(); });
+    std::stable_sort(parameter_annotations.begin(), parameter_annotations.end(),
+                     [](const parameterannotation_t &a, const parameterannotation_t &b)
+                     { return a->get_method_idx() < b->get_method_idx(); });
+
     stream->seekg(current_offset, std::ios_base::beg);
 }
 
 FieldAnnotation* AnnotationDirectoryItem::get_field_annotation_by_id(std::uint32_t idx)
 {
-    auto it = field_annotations_by_id.find(idx);
+    auto annotation = find_annotation(field_annotations, idx, [](FieldAnnotation *a)
+                                      { return a->get_field_idx(); });
 
-    if (it == field_annotations_by_id.end())
+    if (annotation == nullptr)
         throw exceptions::IncorrectIDException("get_field_annotation_by_id(): idx provided incorrect");
-    
-    return it->second;
+
+    return annotation;
 }
 
 MethodAnnotation* AnnotationDirectoryItem::get_method_annotation_by_id(std::uint32_t idx)
 {
-    auto it = method_annotations_by_id.find(idx);
-    
-    if (it == method_annotations_by_id.end())
+    auto annotation = find_annotation(method_annotations, idx, [](MethodAnnotation *a)
+                                      { return a->get_method_idx(); });
+
+    if (annotation == nullptr)
         throw exceptions::IncorrectIDException("get_method_annotation_by_id(): idx provided incorrect");
-    
-    return it->second;
+
+    return annotation;
 }
 
 ParameterAnnotation* AnnotationDirectoryItem::get_parameter_annotation_by_id(std::uint32_t idx)
 {
-    auto it = parameter_annotations_by_id.find(idx);
+    auto annotation = find_annotation(parameter_annotations, idx, [](ParameterAnnotation *a)
+                                      { return a->get_method_idx(); });
 
-    if (it == parameter_annotations_by_id.end())
+    if (annotation == nullptr)
         throw exceptions::IncorrectIDException("get_parameter_annotation_by_id(): idx provided incorrect");
-    
-    return it->second;
-}
\ No newline at end of file
+
+    return annotation;
+}
+
+void AnnotationIndex::add_annotation_set(stream::KunaiStream* stream,
+                                         Types* types,
+                                         std::uint32_t annotations_off,
+                                         annotation_target_e target,
+                                         std::uint32_t class_def,
+                                         std::uint32_t idx)
+{
+    std::uint32_t size;
+    std::uint32_t annotation_off;
+
+    if (annotations_off == 0)
+        return;
+
+    stream->seekg(annotations_off, std::ios_base::beg);
+    stream->read_data<std::uint32_t>(size, sizeof(std::uint32_t));
+
+    for (std::uint32_t I = 0; I < size; ++I)
+    {
+        stream->seekg(annotations_off + 4 + static_cast<std::uint64_t>(I) * 4, std::ios_base::beg);
+        stream->read_data<std::uint32_t>(annotation_off, sizeof(std::uint32_t));
+
+        // annotation_item: visibility byte followed by the encoded_annotation,
+        // only the type of the encoded_annotation is read
+        stream->seekg(static_cast<std::uint64_t>(annotation_off) + 1, std::ios_base::beg);
+        auto type_idx = static_cast<std::uint32_t>(stream->read_uleb128());
+
+        items.push_back({types->get_type_from_order(type_idx), target, class_def, idx});
+    }
+}
+
+void AnnotationIndex::add_annotation_directory(stream::KunaiStream* stream,
+                                               Types* types,
+                                               const AnnotationDirectoryItem& annotation_directory,
+                                               std::uint32_t class_def,
+                                               std::uint32_t class_idx)
+{
+    auto current_offset = stream->tellg();
+    std::uint32_t size;
+    std::uint32_t annotations_off;
+
+    add_annotation_set(stream, types, annotation_directory.get_class_annotations_off(),
+                       CLASS_ANNOTATION, class_def, class_idx);
+
+    for (const auto &field_annotation : annotation_directory.get_field_annotations())
+        add_annotation_set(stream, types, field_annotation->get_annotations_off(),
+                           FIELD_ANNOTATION, class_def, field_annotation->get_field_idx());
+
+    for (const auto &method_annotation : annotation_directory.get_method_annotations())
+        add_annotation_set(stream, types, method_annotation->get_annotations_off(),
+                           METHOD_ANNOTATION, class_def, method_annotation->get_method_idx());
+
+    // the annotations of the parameters point to an annotation_set_ref_list
+    // with one annotation_set_item for each parameter
+    for (const auto &parameter_annotation : annotation_directory.get_parameter_annotations())
+    {
+        auto list_off = parameter_annotation->get_annotations_off();
+
+        if (list_off == 0)
+            continue;
+
+        stream->seekg(list_off, std::ios_base::beg);
+        stream->read_data<std::uint32_t>(size, sizeof(std::uint32_t));
+
+        for (std::uint32_t I = 0; I < size; ++I)
+        {
+            stream->seekg(list_off + 4 + static_cast<std::uint64_t>(I) * 4, std::ios_base::beg);
+            stream->read_data<std::uint32_t>(annotations_off, sizeof(std::uint32_t));
+
+            add_annotation_set(stream, types, annotations_off,
+                               PARAMETER_ANNOTATION, class_def, parameter_annotation->get_method_idx());
+        }
+    }
+
+    stream->seekg(current_offset, std::ios_base::beg);
+}
+
+void AnnotationIndex::sort()
+{
+    std::stable_sort(items.begin(), items.end(),
+                     [](const annotated_item_t &a, const annotated_item_t &b)
+                     { return std::tie(a.annotation_type, a.target) < std::tie(b.annotation_type, b.target); });
+}
+
+std::span<const annotated_item_t> AnnotationIndex::get_annotated_items(DVMType* annotation_type) const
+{
+    auto first = std::lower_bound(items.begin(), items.end(), annotation_type,
+                                  [](const annotated_item_t &a, DVMType *type)
+                                  { return a.annotation_type < type; });
+    auto last = std::upper_bound(first, items.end(), annotation_type,
+                                 [](DVMType *type, const annotated_item_t &a)
+                                 { return type < a.annotation_type; });
+
+    return {first, last};
+}
+
+std::span<const annotated_item_t> AnnotationIndex::get_annotated_items(DVMType* annotation_type,
+                                                                       annotation_target_e target) const
+{
+    annotated_item_t key = {annotation_type, target, 0, 0};
+
+    auto range = std::equal_range(items.begin(), items.end(), key,
+                                  [](const annotated_item_t &a, const annotated_item_t &b)
+                                  { return std::tie(a.annotation_type, a.target) < std::tie(b.annotation_type, b.target); });
+
+    return {range.first, range.second};
+}
@@ -10,14 +10,36 @@
 #include "Kunai/DEX/DVM/dalvik_opcodes.hpp"
 #include "Kunai/Exceptions/incorrectid_exception.hpp"
 
+#include <algorithm>
+
 using namespace KUNAI::DEX;
 
+namespace
+{
+    /// @brief Find the position of an id in the sorted ids of a class data item
+    /// @param ids sorted ids
+    /// @param id id to find
+    /// @return position of the id, or the size of ids if it is not found
+    std::size_t find_id(const std::vector<std::uint64_t> &ids, std::uint64_t id)
+    {
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+
+        if (it == ids.end() || *it != id)
+            return ids.size();
+
+        return static_cast<std::size_t>(it - ids.begin());
+    }
+} // namespace
+
 void ClassDataItem::parse_class_data_item(
     stream::KunaiStream *stream,
     Fields *fields,
     Methods *methods,
-    Types *types)
+    Types *types,
+    utils::Arena *arena,
+    const resource_limits_t &limits)
 {
+    auto logger = LOGGER::logger();
     auto current_offset = stream->tellg();
     std::uint64_t I;
     // IDs for the different variables
@@ -34,6 +56,22 @@ void ClassDataItem::parse_class_data_item(
     std::uint64_t const direct_methods_size = stream->read_uleb128();
     std::uint64_t const virtual_methods_size = stream->read_uleb128();
 
+    // each field takes at least 2 bytes and each method 3 bytes, so
+    // the sizes are also checked with the rest of the file
+    std::uint64_t const remaining = stream->get_size() - static_cast<std::uint64_t>(stream->tellg());
+    std::uint64_t const fields_size = static_fields_size + instance_fields_size;
+    std::uint64_t const methods_size = direct_methods_size + virtual_methods_size;
+
+    if (fields_size < static_fields_size || methods_size < direct_methods_size ||
+        fields_size > limits.max_fields || methods_size > limits.max_methods ||
+        fields_size * 2 + methods_size * 3 > remaining)
+    {
+        logger->warn("classes.cpp: class data with {} fields and {} methods is over the limits, the data is not parsed",
+                     fields_size, methods_size);
+        stream->seekg(current_offset, std::ios_base::beg);
+        return;
+    }
+
     for (I = 0; I < static_fields_size; ++I)
     {
         //! this value needs to be incremented
@@ -46,9 +84,9 @@ void ClassDataItem::parse_class_data_item(
 
         // create the static field and the entry of the map
         static_fields.push_back(
-            std::make_unique<EncodedField>(fields->get_field(static_field),
-                                           static_cast<TYPES::access_flags>(access_flags)));
-        static_fields_by_id[static_field] = static_fields.back().get();
+            arena->make<EncodedField>(fields->get_field(static_field),
+                                      static_cast<TYPES::access_flags>(access_flags)));
+        static_fields_ids.push_back(static_field);
     }
 
     for (I = 0; I < instance_fields_size; ++I)
@@ -58,9 +96,9 @@ void ClassDataItem::parse_class_data_item(
         access_flags = stream->read_uleb128();
 
         instance_fields.push_back(
-            std::make_unique<EncodedField>(fields->get_field(instance_field),
-                                           static_cast<TYPES::access_flags>(access_flags)));
-        instance_fields_by_id[instance_field] = instance_fields.back().get();
+            arena->make<EncodedField>(fields->get_field(instance_field),
+                                      static_cast<TYPES::access_flags>(access_flags)));
+        instance_fields_ids.push_back(instance_field);
     }
 
     for (I = 0; I < direct_methods_size; ++I)
@@ -73,10 +111,10 @@ void ClassDataItem::parse_class_data_item(
         code_offset = stream->read_uleb128();
 
         direct_methods.push_back(
-            std::make_unique<EncodedMethod>(methods->get_method(direct_method),
-                                            static_cast<TYPES::access_flags>(access_flags)));
-        direct_methods_by_id[direct_method] = direct_methods.back().get();
-        direct_methods.back()->parse_encoded_method(stream, code_offset, types);
+            arena->make<EncodedMethod>(methods->get_method(direct_method),
+                                       static_cast<TYPES::access_flags>(access_flags)));
+        direct_methods_ids.push_back(direct_method);
+        direct_methods.back()->parse_encoded_method(stream, code_offset, types, arena, limits);
     }
 
     for (I = 0; I < virtual_methods_size; ++I)
@@ -88,10 +126,10 @@ void ClassDataItem::parse_class_data_item(
         code_offset = stream->read_uleb128();
 
         virtual_methods.push_back(
-            std::make_unique<EncodedMethod>(methods->get_method(virtual_method),
-                                            static_cast<TYPES::access_flags>(access_flags)));
-        virtual_methods_by_id[virtual_method] = virtual_methods.back().get();
-        virtual_methods.back()->parse_encoded_method(stream, code_offset, types);
+            arena->make<EncodedMethod>(methods->get_method(virtual_method),
+                                       static_cast<TYPES::access_flags>(access_flags)));
+        virtual_methods_ids.push_back(virtual_method);
+        virtual_methods.back()->parse_encoded_method(stream, code_offset, types, arena, limits);
     }
 
     stream->seekg(current_offset, std::ios_base::beg);
@@ -106,11 +144,11 @@ EncodedField *ClassDataItem::get_static_field_by_order(std::uint32_t ord)
 
 EncodedField *ClassDataItem::get_static_field_by_id(std::uint32_t id)
 {
-    auto it = static_fields_by_id.find(id);
+    auto pos = find_id(static_fields_ids, id);
 
-    if (it == static_fields_by_id.end())
+    if (pos == static_fields_ids.size())
         throw exceptions::IncorrectIDException("get_static_field_by_id(): id value given incorrect");
-    return it->second;
+    return static_fields[pos].get();
 }
 
 EncodedField *ClassDataItem::get_instance_field_by_order(std::uint32_t ord)
@@ -122,11 +160,11 @@ EncodedField *ClassDataItem::get_instance_field_by_order(std::uint32_t ord)
 
 EncodedField *ClassDataItem::get_instance_field_by_id(std::uint32_t id)
 {
-    auto it = instance_fields_by_id.find(id);
+    auto pos = find_id(instance_fields_ids, id);
 
-    if (it == instance_fields_by_id.end())
+    if (pos == instance_fields_ids.size())
         throw exceptions::IncorrectIDException("get_instance_field_by_id(): id value given incorrect");
-    return it->second;
+    return instance_fields[pos].get();
 }
 
 EncodedMethod *ClassDataItem::get_direct_method_by_order(std::uint32_t ord)
@@ -138,11 +176,11 @@ EncodedMethod *ClassDataItem::get_direct_method_by_order(std::uint32_t ord)
 
 EncodedMethod *ClassDataItem::get_direct_method_by_id(std::uint32_t id)
 {
-    auto it = direct_methods_by_id.find(id);
+    auto pos = find_id(direct_methods_ids, id);
 
-    if (it == direct_methods_by_id.end())
+    if (pos == direct_methods_ids.size())
         throw exceptions::IncorrectIDException("get_direct_method_by_id(): id value given incorrect");
-    return it->second;
+    return direct_methods[pos].get();
 }
 
 EncodedMethod *ClassDataItem::get_virtual_method_by_order(std::uint32_t ord)
@@ -154,11 +192,11 @@ EncodedMethod *ClassDataItem::get_virtual_method_by_order(std::uint32_t ord)
 
 EncodedMethod *ClassDataItem::get_virtual_method_by_id(std::uint32_t id)
 {
-    auto it = virtual_methods_by_id.find(id);
+    auto pos = find_id(virtual_methods_ids, id);
 
-    if (it == virtual_methods_by_id.end())
+    if (pos == virtual_methods_ids.size())
         throw exceptions::IncorrectIDException("get_virtual_method_by_id(): id value given incorrect");
-    return it->second;
+    return virtual_methods[pos].get();
 }
 
 std::vector<EncodedField *> &ClassDataItem::get_fields()
@@ -191,18 +229,18 @@ void ClassDef::parse_class_def(stream::KunaiStream *stream,
                                Strings *strings,
                                Types *types,
                                Fields *fields,
-                               Methods *methods)
+                               Methods *methods,
+                               utils::Arena *arena,
+                               const resource_limits_t *limits,
+                               bool lazy)
 {
     auto current_offset = stream->tellg();
 
-    size_t I;
-    std::uint32_t size;
-    std::uint16_t idx;
-
-    
     // first of all read the classdefstruct_t
     stream->read_data<classdefstruct_t>(classdefstruct, sizeof(classdefstruct_t));
 
+    stream->seekg(current_offset, std::ios_base::beg);
+
     // assign the class idx
     class_idx = reinterpret_cast<DVMClass *>(types->get_type_from_order(classdefstruct.class_idx));
 
@@ -214,6 +252,45 @@ void ClassDef::parse_class_def(stream::KunaiStream *stream,
     if (classdefstruct.source_file_idx != DEX::NO_INDEX)
         source_file = strings->get_string_by_id(classdefstruct.source_file_idx);
 
+    // in memory keep the file, the stream given can be
+    // a temporary cursor
+    if (stream->is_memory_backed())
+        this->buffer = stream->get_buffer();
+    else
+        this->stream = stream;
+    this->strings = strings;
+    this->types = types;
+    this->fields = fields;
+    this->methods = methods;
+    this->arena = arena;
+    this->limits = limits;
+
+    if (!lazy)
+        load_class_data();
+}
+
+KUNAI::stream::KunaiStream *ClassDef::get_data_stream(std::unique_ptr<stream::KunaiStream> &memory_stream)
+{
+    // when the stream is in memory use a cursor of our own,
+    // so the data can be parsed at any moment
+    if (stream != nullptr)
+        return stream;
+
+    memory_stream = std::make_unique<stream::KunaiStream>(buffer);
+    return memory_stream.get();
+}
+
+void ClassDef::parse_class_data()
+{
+    std::unique_ptr<stream::KunaiStream> memory_stream;
+    auto stream = get_data_stream(memory_stream);
+
+    auto current_offset = stream->tellg();
+
+    size_t I;
+    std::uint32_t size;
+    std::uint16_t idx;
+
     // we can start now the parsing of the rest of the file!
     if (classdefstruct.interfaces_off)
     {
@@ -230,41 +307,60 @@ void ClassDef::parse_class_def(stream::KunaiStream *stream,
         }
     }
 
-    if (classdefstruct.annotations_off)
-    {
-        stream->seekg(classdefstruct.annotations_off, std::ios_base::beg);
-
-        annotation_directory.parse_annotation_directory_item(stream);
-    }
-
     if (classdefstruct.class_data_off)
     {
         stream->seekg(classdefstruct.class_data_off, std::ios_base::beg);
 
-        class_data_item.parse_class_data_item(stream, fields, methods, types);
+        class_data_item.parse_class_data_item(stream, fields, methods, types, arena, *limits);
     }
 
     if (classdefstruct.static_values_off)
     {
         stream->seekg(classdefstruct.static_values_off, std::ios_base::beg);
 
-        // the number of static values, is the number of static
-        // fields of the class
-        size = class_data_item.get_number_of_static_fields();
+        // one encoded_array_item with the initial values of the
+        // first static fields, the rest are 0 or null
+        static_values.parse_encoded_array(stream, types, strings, arena);
 
-        encodedarray_t encodedarray;
+        auto &values = static_values.get_values();
+        auto number_of_values = std::min<std::size_t>(values.size(), class_data_item.get_number_of_static_fields());
 
-        for (I = 0; I < size; ++I)
-        {
-            encodedarray = std::make_unique<EncodedArray>();
-            encodedarray->parse_encoded_array(stream, types, strings);
-            static_values.push_back(std::move(encodedarray));
-        }
+        for (I = 0; I < number_of_values; ++I)
+            class_data_item.get_static_field_by_order(static_cast<std::uint32_t>(I))->set_initial_value(&values[I]);
     }
 
     stream->seekg(current_offset, std::ios_base::beg);
 }
 
+void ClassDef::parse_annotations()
+{
+    if (!classdefstruct.annotations_off)
+        return;
+
+    std::unique_ptr<stream::KunaiStream> memory_stream;
+    auto stream = get_data_stream(memory_stream);
+
+    auto current_offset = stream->tellg();
+
+    stream->seekg(classdefstruct.annotations_off, std::ios_base::beg);
+
+    annotation_directory.parse_annotation_directory_item(stream);
+
+    stream->seekg(current_offset, std::ios_base::beg);
+}
+
+void ClassDef::add_to_annotation_index(AnnotationIndex &annotation_index, std::uint32_t class_def)
+{
+    if (!classdefstruct.annotations_off)
+        return;
+
+    std::unique_ptr<stream::KunaiStream> memory_stream;
+    auto stream = get_data_stream(memory_stream);
+
+    annotation_index.add_annotation_directory(stream, types, get_annotation_directory(),
+                                              class_def, classdefstruct.class_idx);
+}
+
 void Classes::parse_classes(
     stream::KunaiStream *stream,
     std::uint32_t number_of_classes,
@@ -272,24 +368,70 @@ void Classes::parse_classes(
     Strings *strings,
     Types *types,
     Fields *fields,
-    Methods *methods)
+    Methods *methods,
+    utils::Arena *arena,
+    const resource_limits_t *limits,
+    bool lazy,
+    utils::ThreadPool *pool)
 {
     auto logger = LOGGER::logger();
     auto current_offset = stream->tellg();
     this->number_of_classes = number_of_classes;
+    this->types = types;
+    this->fields = fields;
+    this->methods = methods;
 
     classdef_t classdef;
     size_t I;
 
     logger->debug("classes.cpp: started parsing classes");
 
+    if (pool != nullptr && stream->is_memory_backed() && number_of_classes > 0)
+    {
+        // split the class_defs in some chunks for each thread, the
+        // classes have different sizes so this balances the work
+        std::uint32_t number_of_chunks = static_cast<std::uint32_t>(pool->get_number_of_threads()) * 4;
+        std::uint32_t chunk_size = (number_of_classes + number_of_chunks - 1) / number_of_chunks;
+        std::vector<std::future<void>> futures;
+        auto buffer = stream->get_buffer();
+
+        class_defs.resize(number_of_classes);
+
+        for (std::uint32_t first = 0; first < number_of_classes; first += chunk_size)
+        {
+            std::uint32_t last = std::min(first + chunk_size, number_of_classes);
+
+            futures.push_back(pool->submit([=, this]()
+            {
+                // each chunk reads with its own cursor
+                stream::KunaiStream chunk_stream(buffer);
+
+                chunk_stream.seekg(offset + first * sizeof(ClassDef::classdefstruct_t), std::ios_base::beg);
+
+                for (std::uint32_t J = first; J < last; ++J)
+                {
+                    auto chunk_classdef = std::make_unique<ClassDef>();
+                    chunk_classdef->parse_class_def(&chunk_stream, strings, types, fields, methods, arena, limits, lazy);
+                    class_defs[J] = std::move(chunk_classdef);
+                    chunk_stream.seekg(sizeof(ClassDef::classdefstruct_t), std::ios_base::cur);
+                }
+            }));
+        }
+
+        utils::ThreadPool::wait_all(futures);
+
+        logger->debug("classes.cpp: finished parsing classes");
+
+        return;
+    }
+
     // move to the offset
     stream->seekg(offset, std::ios_base::beg);
 
     for (I = 0; I < number_of_classes; ++I)
     {
         classdef = std::make_unique<ClassDef>();
-        classdef->parse_class_def(stream, strings, types, fields, methods);
+        classdef->parse_class_def(stream, strings, types, fields, methods, arena, limits, lazy);
         class_defs.push_back(std::move(classdef));
         // since classdef restore the pointer it found, move it to next
         // structure
@@ -301,6 +443,74 @@ void Classes::parse_classes(
     stream->seekg(current_offset, std::ios_base::beg);
 }
 
+ClassDef *Classes::get_classdef_by_name(std::string_view name)
+{
+    for (auto &class_def : class_defs)
+    {
+        if (class_def->get_class_idx()->get_raw_view() == name)
+            return class_def.get();
+    }
+
+    return nullptr;
+}
+
+void Classes::build_annotation_index()
+{
+    auto logger = LOGGER::logger();
+
+    logger->debug("classes.cpp: started building index of annotations");
+
+    for (std::uint32_t I = 0; I < class_defs.size(); ++I)
+        class_defs[I]->add_to_annotation_index(annotation_index, I);
+
+    annotation_index.sort();
+
+    logger->debug("classes.cpp: finished building index of annotations, {} annotations",
+                  annotation_index.get_items().size());
+}
+
+std::vector<ClassDef *> Classes::get_annotated_classes(std::string_view annotation_type)
+{
+    std::vector<ClassDef *> annotated_classes;
+    auto type = types->get_type_by_name(annotation_type);
+
+    if (type == nullptr)
+        return annotated_classes;
+
+    for (const auto &item : get_annotation_index().get_annotated_items(type, CLASS_ANNOTATION))
+        annotated_classes.push_back(class_defs[item.class_def].get());
+
+    return annotated_classes;
+}
+
+std::vector<FieldID *> Classes::get_annotated_fields(std::string_view annotation_type)
+{
+    std::vector<FieldID *> annotated_fields;
+    auto type = types->get_type_by_name(annotation_type);
+
+    if (type == nullptr)
+        return annotated_fields;
+
+    for (const auto &item : get_annotation_index().get_annotated_items(type, FIELD_ANNOTATION))
+        annotated_fields.push_back(fields->get_field(item.idx));
+
+    return annotated_fields;
+}
+
+std::vector<MethodID *> Classes::get_annotated_methods(std::string_view annotation_type)
+{
+    std::vector<MethodID *> annotated_methods;
+    auto type = types->get_type_by_name(annotation_type);
+
+    if (type == nullptr)
+        return annotated_methods;
+
+    for (const auto &item : get_annotation_index().get_annotated_items(type, METHOD_ANNOTATION))
+        annotated_methods.push_back(methods->get_method(item.idx));
+
+    return annotated_methods;
+}
+
 namespace KUNAI
 {
 namespace DEX
@@ -0,0 +1,247 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file dex_visitor.cpp
+
+#include "Kunai/DEX/parser/dex_visitor.hpp"
+#include "Kunai/DEX/DVM/dalvik_opcodes.hpp"
+#include "Kunai/DEX/DVM/dvm_types.hpp"
+#include "Kunai/Exceptions/incorrectdexfile_exception.hpp"
+#include "Kunai/Exceptions/incorrectid_exception.hpp"
+#include "Kunai/Exceptions/parser_exception.hpp"
+#include "Kunai/Utils/logger.hpp"
+
+#include <cstring>
+
+using namespace KUNAI::DEX;
+
+namespace
+{
+    template <typename T>
+    T read_bytecode(std::span<const std::uint8_t> bytecode, std::size_t index)
+    {
+        T value = 0;
+        if (index + sizeof(T) <= bytecode.size())
+            std::memcpy(&value, bytecode.data() + index, sizeof(T));
+        return value;
+    }
+
+    /// @brief Get the length in bytes of the instruction in the given
+    /// index, the payloads of the switch and fill-array-data are
+    /// counted with all their data
+    /// @param bytecode bytecode of the method
+    /// @param index index of the instruction
+    /// @return length of the instruction
+    std::uint64_t instruction_length(std::span<const std::uint8_t> bytecode, std::size_t index)
+    {
+        std::uint8_t opcode = bytecode[index];
+
+        if (opcode == KUNAI::DEX::TYPES::opcodes::OP_NOP && index + 1 < bytecode.size())
+        {
+            switch (bytecode[index + 1])
+            {
+            case 0x01: // packed-switch-data
+                return 8 + static_cast<std::uint64_t>(read_bytecode<std::uint16_t>(bytecode, index + 2)) * 4;
+            case 0x02: // sparse-switch-data
+                return 4 + static_cast<std::uint64_t>(read_bytecode<std::uint16_t>(bytecode, index + 2)) * 8;
+            case 0x03: // fill-array-data
+            {
+                std::uint64_t data_size = static_cast<std::uint64_t>(read_bytecode<std::uint16_t>(bytecode, index + 2)) *
+                                          read_bytecode<std::uint32_t>(bytecode, index + 4);
+                return 8 + data_size + (data_size % 2);
+            }
+            default:
+                break;
+            }
+        }
+
+        return DalvikOpcodes::get_instruction_length(opcode) * 2;
+    }
+} // namespace
+
+void DexWalker::walk(DexVisitor &visitor)
+{
+    std::uint8_t magic[4];
+    auto logger = LOGGER::logger();
+
+    logger->debug("dex_visitor.cpp: started walking dex file");
+
+    if (stream->get_size() < sizeof(Header::dexheader_t))
+        throw exceptions::ParserException("dex_visitor.cpp: file has incorrect size");
+
+    stream->seekg(0, std::ios_base::beg);
+    stream->read_data<std::uint8_t[4]>(magic, sizeof(std::uint8_t[4]));
+
+    if (memcmp(magic, KUNAI::DEX::dex_magic, 4))
+        throw exceptions::IncorrectDexFileException("dex_visitor.cpp: file is not a dex file");
+
+    stream->seekg(0, std::ios_base::beg);
+    header.parse_headers(stream);
+
+    auto &dex_header = header.get_dex_header_const();
+
+    visitor.visit_header(dex_header);
+
+    if (options.visit_strings)
+    {
+        for (std::uint32_t I = 0; I < dex_header.string_ids_size; ++I)
+            visitor.visit_string(I, read_string(I));
+    }
+
+    for (std::uint32_t I = 0; I < dex_header.class_defs_size; ++I)
+    {
+        auto class_def = read_at<ClassDef::classdefstruct_t>(
+            dex_header.class_defs_off + static_cast<std::uint64_t>(I) * sizeof(ClassDef::classdefstruct_t));
+
+        visitor.visit_class_def(class_def);
+
+        if (options.visit_class_data && class_def.class_data_off != 0)
+            walk_class_data(visitor, class_def.class_data_off);
+    }
+
+    visitor.visit_end();
+
+    logger->debug("dex_visitor.cpp: finished walking dex file");
+}
+
+void DexWalker::walk_class_data(DexVisitor &visitor, std::uint32_t class_data_off)
+{
+    std::uint64_t static_fields_size, instance_fields_size,
+        direct_methods_size, virtual_methods_size;
+    std::uint64_t idx;
+
+    stream->seekg(class_data_off, std::ios_base::beg);
+
+    static_fields_size = stream->read_uleb128();
+    instance_fields_size = stream->read_uleb128();
+    direct_methods_size = stream->read_uleb128();
+    virtual_methods_size = stream->read_uleb128();
+
+    // the ids are written as the difference with the previous one,
+    // starting again in each list
+    idx = 0;
+    for (std::uint64_t I = 0; I < static_fields_size + instance_fields_size; ++I)
+    {
+        if (I == static_fields_size)
+            idx = 0;
+
+        visited_field_t field;
+
+        idx += stream->read_uleb128();
+        field.field_idx = static_cast<std::uint32_t>(idx);
+        field.access_flags = static_cast<std::uint32_t>(stream->read_uleb128());
+        field.is_static = I < static_fields_size;
+
+        visitor.visit_field(field);
+    }
+
+    idx = 0;
+    for (std::uint64_t I = 0; I < direct_methods_size + virtual_methods_size; ++I)
+    {
+        if (I == direct_methods_size)
+            idx = 0;
+
+        visited_method_t method;
+
+        idx += stream->read_uleb128();
+        method.method_idx = static_cast<std::uint32_t>(idx);
+        method.access_flags = static_cast<std::uint32_t>(stream->read_uleb128());
+        method.code_off = static_cast<std::uint32_t>(stream->read_uleb128());
+        method.is_virtual = I >= direct_methods_size;
+
+        visitor.visit_method(method);
+
+        if (options.visit_code && method.code_off != 0)
+        {
+            // the code item is in other part of the file, come back
+            // to the next method once it is visited
+            auto next_method = stream->tellg();
+
+            walk_code_item(visitor, method.method_idx, method.code_off);
+
+            stream->seekg(next_method, std::ios_base::beg);
+        }
+    }
+}
+
+void DexWalker::walk_code_item(DexVisitor &visitor, std::uint32_t method_idx, std::uint32_t code_off)
+{
+    visited_code_item_t code_item;
+    std::uint32_t insns_size;
+
+    code_item.method_idx = method_idx;
+
+    stream->seekg(code_off, std::ios_base::beg);
+    stream->read_data<std::uint16_t>(code_item.registers_size, sizeof(std::uint16_t));
+    stream->read_data<std::uint16_t>(code_item.ins_size, sizeof(std::uint16_t));
+    stream->read_data<std::uint16_t>(code_item.outs_size, sizeof(std::uint16_t));
+    stream->read_data<std::uint16_t>(code_item.tries_size, sizeof(std::uint16_t));
+    stream->read_data<std::uint32_t>(code_item.debug_info_off, sizeof(std::uint32_t));
+    stream->read_data<std::uint32_t>(insns_size, sizeof(std::uint32_t));
+
+    // size of the bytecode in bytes
+    std::uint64_t bytecode_size = static_cast<std::uint64_t>(insns_size) * 2;
+    std::uint64_t bytecode_off = static_cast<std::uint64_t>(code_off) + 16;
+
+    if (bytecode_off + bytecode_size > stream->get_size())
+        throw exceptions::ParserException("dex_visitor.cpp: bytecode out of the file");
+
+    if (stream->is_memory_backed())
+        code_item.insns = stream->get_buffer().subspan(bytecode_off, bytecode_size);
+    else
+    {
+        code_buffer.resize(bytecode_size);
+        if (bytecode_size > 0)
+            stream->read_data<std::uint8_t>(code_buffer[0], static_cast<std::int32_t>(bytecode_size));
+        code_item.insns = code_buffer;
+    }
+
+    visitor.visit_code_item(code_item);
+
+    if (!options.visit_instructions)
+        return;
+
+    visited_instruction_t instruction;
+    std::size_t index = 0;
+
+    instruction.method_idx = method_idx;
+
+    while (index < code_item.insns.size())
+    {
+        // an instruction that goes out of the bytecode is given
+        // with the bytes that remain
+        auto length = std::min<std::uint64_t>(instruction_length(code_item.insns, index),
+                                              code_item.insns.size() - index);
+
+        instruction.address = static_cast<std::uint32_t>(index);
+        instruction.opcode = code_item.insns[index];
+        instruction.bytes = code_item.insns.subspan(index, length);
+
+        visitor.visit_instruction(instruction);
+
+        index += length;
+    }
+}
+
+std::string DexWalker::read_string(std::uint32_t id)
+{
+    auto &dex_header = header.get_dex_header_const();
+
+    if (id >= dex_header.string_ids_size)
+        throw exceptions::IncorrectIDException("dex_visitor.cpp: string id out of bound");
+
+    auto offset = read_at<std::uint32_t>(dex_header.string_ids_off + static_cast<std::uint64_t>(id) * 4);
+
+    return stream->read_dex_string(offset);
+}
+
+std::string DexWalker::read_type(std::uint32_t id)
+{
+    auto &dex_header = header.get_dex_header_const();
+
+    if (id >= dex_header.type_ids_size)
+        throw exceptions::IncorrectIDException("dex_visitor.cpp: type id out of bound");
+
+    return read_string(read_at<std::uint32_t>(dex_header.type_ids_off + static_cast<std::uint64_t>(id) * 4));
+}
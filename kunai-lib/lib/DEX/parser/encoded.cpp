@@ -7,49 +7,99 @@
 
 #include "Kunai/DEX/parser/encoded.hpp"
 #include "Kunai/Exceptions/incorrectid_exception.hpp"
+#include "Kunai/Exceptions/outofbound_exception.hpp"
+#include "Kunai/Utils/logger.hpp"
+
+#include <algorithm>
+#include <cstring>
 
 using namespace KUNAI::DEX;
 
+namespace
+{
+    /// @brief Read the bytes of an encoded value in little endian
+    /// @param stream stream where to read data
+    /// @param size number of bytes of the value
+    /// @return bytes of the value in the lowest bytes
+    std::uint64_t read_value_bytes(KUNAI::stream::KunaiStream *stream, std::uint32_t size)
+    {
+        std::uint64_t result = 0;
+        std::uint8_t aux;
+
+        for (std::uint32_t I = 0; I < size; ++I)
+        {
+            stream->read_data<std::uint8_t>(aux, sizeof(std::uint8_t));
+            result |= static_cast<std::uint64_t>(aux) << (I * 8);
+        }
+
+        return result;
+    }
+} // namespace
+
 void EncodedValue::parse_encoded_value(
     stream::KunaiStream *stream,
     Types *types,
-    Strings *strings)
+    Strings *strings,
+    utils::Arena *arena)
 {
-    std::uint8_t value;
+    std::uint8_t header;
 
-    stream->read_data<std::uint8_t>(value, sizeof(std::uint8_t));
+    stream->read_data<std::uint8_t>(header, sizeof(std::uint8_t));
 
-    value_type = static_cast<TYPES::value_format>(value & 0x1f);
-    value_args = ((value & 0xe0) >> 5);
+    value_type = static_cast<TYPES::value_format>(header & 0x1f);
+    value_args = ((header & 0xe0) >> 5);
+
+    // the values stored in bytes use value_args + 1 bytes
+    std::uint32_t size = value_args + 1;
 
     switch (value_type)
     {
     case TYPES::value_format::VALUE_BYTE:
     case TYPES::value_format::VALUE_SHORT:
-    case TYPES::value_format::VALUE_CHAR:
     case TYPES::value_format::VALUE_INT:
     case TYPES::value_format::VALUE_LONG:
+    {
+        // sign extended
+        auto raw = read_value_bytes(stream, size);
+        auto shift = 64 - size * 8;
+        value.int_value = static_cast<std::int64_t>(raw << shift) >> shift;
+        break;
+    }
+    case TYPES::value_format::VALUE_CHAR:
+        value.int_value = static_cast<std::int64_t>(read_value_bytes(stream, size));
+        break;
     case TYPES::value_format::VALUE_FLOAT:
+    {
+        // zero extended to the right
+        auto raw = static_cast<std::uint32_t>(read_value_bytes(stream, size) << ((4 - std::min(size, 4u)) * 8));
+        std::memcpy(&value.float_value, &raw, sizeof(float));
+        break;
+    }
     case TYPES::value_format::VALUE_DOUBLE:
+    {
+        auto raw = read_value_bytes(stream, size) << ((8 - size) * 8);
+        std::memcpy(&value.double_value, &raw, sizeof(double));
+        break;
+    }
+    case TYPES::value_format::VALUE_METHOD_TYPE:
+    case TYPES::value_format::VALUE_METHOD_HANDLE:
     case TYPES::value_format::VALUE_STRING:
     case TYPES::value_format::VALUE_TYPE:
     case TYPES::value_format::VALUE_FIELD:
     case TYPES::value_format::VALUE_METHOD:
     case TYPES::value_format::VALUE_ENUM:
-    {
-        std::uint8_t aux;
-        for (size_t I = 0; I < value_args; ++I)
-        {
-            stream->read_data<std::uint8_t>(aux, sizeof(std::uint8_t));
-            values.push_back(aux);
-        }
+        value.index = static_cast<std::uint32_t>(read_value_bytes(stream, size));
         break;
-    }
     case TYPES::value_format::VALUE_ARRAY:
-        array_data.parse_encoded_array(stream, types, strings);
+        array_data = arena->make<EncodedArray>();
+        array_data->parse_encoded_array(stream, types, strings, arena);
         break;
     case TYPES::value_format::VALUE_ANNOTATION:
-        annotation.parse_encoded_annotation(stream, types, strings);
+        annotation = arena->make<EncodedAnnotation>();
+        annotation->parse_encoded_annotation(stream, types, strings, arena);
+        break;
+    case TYPES::value_format::VALUE_BOOLEAN:
+        value.boolean_value = value_args != 0;
         break;
     default:
         break;
@@ -59,26 +109,27 @@ void EncodedValue::parse_encoded_value(
 void EncodedArray::parse_encoded_array(
     stream::KunaiStream *stream,
     Types *types,
-    Strings *strings)
+    Strings *strings,
+    utils::Arena *arena)
 {
     array_size = stream->read_uleb128();
-    encodedvalue_t encoded_value;
+
+    // each value takes at least one byte, do not trust
+    // the size to allocate memory
+    auto remaining = stream->get_size() - static_cast<std::size_t>(stream->tellg());
+    values.reserve(std::min<std::uint64_t>(array_size, remaining));
 
     for (size_t I = 0; I < array_size; ++I)
-    {
-        encoded_value = std::make_unique<EncodedValue>();
-        encoded_value->parse_encoded_value(stream, types, strings);
-        values.push_back(std::move(encoded_value));
-    }
+        values.emplace_back().parse_encoded_value(stream, types, strings, arena);
 }
 
 void EncodedAnnotation::parse_encoded_annotation(
     stream::KunaiStream *stream,
     Types *types,
-    Strings *strings)
+    Strings *strings,
+    utils::Arena *arena)
 {
     annotationelement_t annotation_element;
-    encodedvalue_t encoded_value;
     std::uint64_t name_idx;
     auto type_idx = stream->read_uleb128();
     size = stream->read_uleb128();
@@ -90,11 +141,11 @@ void EncodedAnnotation::parse_encoded_annotation(
         // read first the name_idx, then the EncodedValue
         name_idx = stream->read_uleb128();
         // read the EncodedValue
-        encoded_value = std::make_unique<EncodedValue>();
-        encoded_value->parse_encoded_value(stream, types, strings);
+        EncodedValue encoded_value;
+        encoded_value.parse_encoded_value(stream, types, strings, arena);
 
         // create the AnnotationElement
-        annotation_element = std::make_unique<AnnotationElement>(
+        annotation_element = arena->make<AnnotationElement>(
             strings->get_string_by_id(name_idx),
             std::move(encoded_value));
 
@@ -112,7 +163,8 @@ AnnotationElement *EncodedAnnotation::get_annotation_by_pos(std::uint32_t pos)
 
 void EncodedCatchHandler::parse_encoded_catch_handler(
     stream::KunaiStream *stream,
-    Types *types)
+    Types *types,
+    utils::Arena *arena)
 {
     std::uint64_t type_idx, addr;
     encodedtypepair_t encoded_type_pair;
@@ -126,7 +178,7 @@ void EncodedCatchHandler::parse_encoded_catch_handler(
         type_idx = stream->read_uleb128();
         addr = stream->read_uleb128();
 
-        encoded_type_pair = std::make_unique<EncodedTypePair>(
+        encoded_type_pair = arena->make<EncodedTypePair>(
             types->get_type_from_order(type_idx),
             addr);
         handlers.push_back(std::move(encoded_type_pair));
@@ -152,10 +204,10 @@ void TryItem::parse_try_item(stream::KunaiStream *stream)
 
 void CodeItemStruct::parse_code_item_struct(
     stream::KunaiStream *stream,
-    Types *types)
+    Types *types,
+    utils::Arena *arena,
+    const resource_limits_t &limits)
 {
-    // the instructions are read in chunks of 16 bits
-    std::uint8_t instruction[2];
     size_t I;
     tryitem_t try_item;
     encodedcatchhandler_t encoded_catch_handler;
@@ -165,16 +217,37 @@ void CodeItemStruct::parse_code_item_struct(
 
     // now we can work with the values
 
-    // first read the instructions for the CodeItem
-    instructions_raw.reserve(code_item.insns_size*2);
-    
-    for (I = 0; I < code_item.insns_size; ++I)
+    // the instructions are 16 bits units
+    std::uint64_t const instructions_size = static_cast<std::uint64_t>(code_item.insns_size) * 2;
+    auto const instructions_offset = static_cast<std::uint64_t>(stream->tellg());
+
+    if (instructions_size > stream->get_size() - instructions_offset)
+        throw exceptions::OutOfBoundException("encoded.cpp: instructions of code item out of bound");
+
+    if (code_item.insns_size > limits.max_instructions)
     {
-        // read the instruction
-        stream->read_data<std::uint8_t[2]>(instruction, sizeof(std::uint8_t[2]));
+        auto logger = LOGGER::logger();
+        logger->warn("encoded.cpp: code item with {} code units is over the limit, the code is not parsed",
+                     code_item.insns_size);
+        // keep the method without code
+        code_item.insns_size = 0;
+        code_item.tries_size = 0;
+        return;
+    }
 
-        instructions_raw.push_back(instruction[0]);
-        instructions_raw.push_back(instruction[1]);
+    if (stream->is_memory_backed())
+    {
+        // reference the instructions directly in the file
+        bytecode = stream->get_buffer().subspan(instructions_offset, instructions_size);
+        stream->seekg(instructions_size, std::ios_base::cur);
+    }
+    else
+    {
+        // read all the instructions at once
+        instructions_raw.resize(instructions_size);
+        if (instructions_size > 0)
+            stream->read_data<std::uint8_t>(*instructions_raw.data(), static_cast<std::int32_t>(instructions_size));
+        bytecode = instructions_raw;
     }
 
     if ((code_item.tries_size > 0) && // padding present in case tries_size > 0
@@ -189,7 +262,7 @@ void CodeItemStruct::parse_code_item_struct(
     {
         for (I = 0; I < code_item.tries_size; ++I)
         {
-            try_item = std::make_unique<TryItem>();
+            try_item = arena->make<TryItem>();
             try_item->parse_try_item(stream);
             try_items.push_back(std::move(try_item));
         }
@@ -202,8 +275,8 @@ void CodeItemStruct::parse_code_item_struct(
 
         for (I = 0; I < encoded_catch_handler_size; ++I)
         {
-            encoded_catch_handler = std::make_unique<EncodedCatchHandler>();
-            encoded_catch_handler->parse_encoded_catch_handler(stream, types);
+            encoded_catch_handler = arena->make<EncodedCatchHandler>();
+            encoded_catch_handler->parse_encoded_catch_handler(stream, types, arena);
             encoded_catch_handlers.push_back(std::move(encoded_catch_handler));
         }
     }
@@ -211,7 +284,9 @@ void CodeItemStruct::parse_code_item_struct(
 
 void EncodedMethod::parse_encoded_method(stream::KunaiStream *stream,
                                          std::uint64_t code_off,
-                                         Types *types)
+                                         Types *types,
+                                         utils::Arena *arena,
+                                         const resource_limits_t &limits)
 {
     auto current_offset = stream->tellg();
 
@@ -219,7 +294,7 @@ void EncodedMethod::parse_encoded_method(stream::KunaiStream *stream,
     {
         stream->seekg(code_off, std::ios_base::beg);
         // parse the code item
-        code_item.parse_code_item_struct(stream, types);
+        code_item.parse_code_item_struct(stream, types, arena, limits);
     }
 
     // return to current offset
@@ -12,10 +12,8 @@ using namespace KUNAI::DEX;
 
 std::string& FieldID::pretty_field()
 {
-    if (!pretty_name.empty())
-        return pretty_name;
-
-    pretty_name = class_->get_raw() + "->" + name_ + " " + type_->get_raw();
+    std::call_once(pretty_name_created, [this]()
+                   { pretty_name = class_->get_raw() + "->" + name_ + " " + type_->get_raw(); });
     return pretty_name;
 }
 
@@ -24,7 +22,9 @@ void Fields::parse_fields(
     Types *types,
     Strings *strings,
     std::uint32_t fields_offset,
-    std::uint32_t fields_size)
+    std::uint32_t fields_size,
+    utils::Arena *arena,
+    bool trusted)
 {
     auto current_offset = stream->tellg();
     this->fields_size = fields_size;
@@ -35,20 +35,43 @@ void Fields::parse_fields(
     // move to the offset where ids are
     stream->seekg(fields_offset, std::ios_base::beg);
 
-    for (size_t I = 0; I < fields_size; ++I)
+    if (trusted)
+    {
+        // the table and its ids were validated, the size of the
+        // table is also correct to reserve the memory
+        fields.reserve(fields_size);
+
+        for (size_t I = 0; I < fields_size; ++I)
+        {
+            auto entry = fields_offset + I * 8;
+
+            class_idx = stream->read_unchecked<std::uint16_t>(entry);
+            type_idx = stream->read_unchecked<std::uint16_t>(entry + 2);
+            name_idx = stream->read_unchecked<std::uint32_t>(entry + 4);
+
+            fields.push_back(arena->make<FieldID>(
+                types->get_type_from_order_unchecked(class_idx),
+                types->get_type_from_order_unchecked(type_idx),
+                strings->get_string_by_id_unchecked(name_idx)));
+        }
+    }
+    else
     {
-        stream->read_data<std::uint16_t>(class_idx, sizeof(std::uint16_t));
-
-        stream->read_data<std::uint16_t>(type_idx, sizeof(std::uint16_t));
-
-        stream->read_data<std::uint32_t>(name_idx, sizeof(std::uint32_t));
-        // create the object with the information
-        fieldid = std::make_unique<FieldID>(
-            types->get_type_from_order(class_idx),
-            types->get_type_from_order(type_idx),
-            strings->get_string_by_id(name_idx));
-        // move the ownership to the vector
-        fields.push_back(std::move(fieldid));
+        for (size_t I = 0; I < fields_size; ++I)
+        {
+            stream->read_data<std::uint16_t>(class_idx, sizeof(std::uint16_t));
+
+            stream->read_data<std::uint16_t>(type_idx, sizeof(std::uint16_t));
+
+            stream->read_data<std::uint32_t>(name_idx, sizeof(std::uint32_t));
+            // create the object with the information
+            fieldid = arena->make<FieldID>(
+                types->get_type_from_order(class_idx),
+                types->get_type_from_order(type_idx),
+                strings->get_string_by_id(name_idx));
+            // move the ownership to the vector
+            fields.push_back(std::move(fieldid));
+        }
     }
 
     // return to the previous offset
@@ -5,9 +5,48 @@
 //
 // @file header.cpp
 #include "Kunai/DEX/parser/header.hpp"
+#include "Kunai/Exceptions/incorrectdexfile_exception.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
 
 using namespace KUNAI::DEX;
 
+namespace
+{
+    /// @brief Give to the function the content of the file from the
+    /// offset to the end, in memory the buffer is given at once,
+    /// in other case it is read in chunks
+    template <typename Func>
+    void read_file_from(KUNAI::stream::KunaiStream *stream, std::uint64_t offset, Func func)
+    {
+        if (stream->is_memory_backed())
+        {
+            func(stream->get_buffer().subspan(offset));
+            return;
+        }
+
+        const std::int32_t chunk_size = 64 * 1024;
+        std::vector<std::uint8_t> chunk(chunk_size);
+        auto current_offset = stream->tellg();
+        auto remaining = stream->get_size() - offset;
+
+        stream->seekg(offset, std::ios_base::beg);
+
+        while (remaining > 0)
+        {
+            auto size = static_cast<std::int32_t>(std::min<std::uint64_t>(remaining, chunk_size));
+            stream->read_data<std::uint8_t>(*chunk.data(), size);
+            func(std::span<const std::uint8_t>{chunk.data(), static_cast<std::size_t>(size)});
+            remaining -= size;
+        }
+
+        stream->seekg(current_offset, std::ios_base::beg);
+    }
+} // namespace
+
 void Header::parse_headers(stream::KunaiStream *stream)
 {
     auto logger = LOGGER::logger();
@@ -45,6 +84,49 @@ void Header::parse_headers(stream::KunaiStream *stream)
     logger->debug("header.cpp: dex header correctly parsed");
 }
 
+std::uint32_t Header::compute_checksum(stream::KunaiStream *stream) const
+{
+    std::uint32_t adler = 1;
+
+    read_file_from(stream, offsetof(dexheader_t, signature), [&](std::span<const std::uint8_t> data)
+                   { adler = utils::adler32(data, adler); });
+
+    return adler;
+}
+
+KUNAI::utils::Sha1::digest_t Header::compute_signature(stream::KunaiStream *stream) const
+{
+    utils::Sha1 sha1;
+
+    read_file_from(stream, offsetof(dexheader_t, file_size), [&](std::span<const std::uint8_t> data)
+                   { sha1.update(data); });
+
+    return sha1.finish();
+}
+
+void Header::verify(stream::KunaiStream *stream, bool checksum, bool signature) const
+{
+    auto logger = LOGGER::logger();
+
+    if (checksum)
+    {
+        if (compute_checksum(stream) != static_cast<std::uint32_t>(dexheader.checksum))
+            throw exceptions::IncorrectDexFileException("header.cpp: checksum of the dex file is not correct");
+
+        logger->debug("header.cpp: checksum verified");
+    }
+
+    if (signature)
+    {
+        auto digest = compute_signature(stream);
+
+        if (memcmp(digest.data(), dexheader.signature, digest.size()))
+            throw exceptions::IncorrectDexFileException("header.cpp: signature of the dex file is not correct");
+
+        logger->debug("header.cpp: signature verified");
+    }
+}
+
 void Header::to_xml(std::ofstream &fos)
 {
     size_t i;
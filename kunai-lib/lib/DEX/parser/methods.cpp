@@ -13,11 +13,8 @@
 using namespace KUNAI::DEX;
 
 
-std::string& MethodID::pretty_method()
+void MethodID::create_pretty_name()
 {
-    if (!pretty_name.empty())
-        return pretty_name;
-    
     pretty_name = proto_->get_return_type()->pretty_print();
     pretty_name += " " + class_->pretty_print() + "->";
     pretty_name += name_ + "(";
@@ -30,7 +27,11 @@ std::string& MethodID::pretty_method()
             pretty_name += ",";
     }
     pretty_name += ")";
+}
 
+std::string& MethodID::pretty_method()
+{
+    std::call_once(pretty_name_created, &MethodID::create_pretty_name, this);
     return pretty_name;
 }
 
@@ -40,7 +41,9 @@ void Methods::parse_methods(
     Protos *protos,
     Strings *strings,
     std::uint32_t methods_offset,
-    std::uint32_t methods_size)
+    std::uint32_t methods_size,
+    utils::Arena *arena,
+    bool trusted)
 {
     auto current_offset = stream->tellg();
     this->methods_size = methods_size;
@@ -53,20 +56,43 @@ void Methods::parse_methods(
     // move to the offset where ids are
     stream->seekg(methods_offset, std::ios_base::beg);
 
-    for (size_t I = 0; I < methods_size; ++I)
+    if (trusted)
     {
-        stream->read_data<std::uint16_t>(class_idx, sizeof(std::uint16_t));
-
-        stream->read_data<std::uint16_t>(proto_idx, sizeof(std::uint16_t));
-
-        stream->read_data<std::uint32_t>(name_idx, sizeof(std::uint32_t));
-        // create the object with the information
-        methodid = std::make_unique<MethodID>(
-            types->get_type_from_order(class_idx),
-            protos->get_proto_by_order(proto_idx),
-            strings->get_string_by_id(name_idx));
-        // move the ownership to the vector
-        methods.push_back(std::move(methodid));
+        // the table and its ids were validated, the size of the
+        // table is also correct to reserve the memory
+        methods.reserve(methods_size);
+
+        for (size_t I = 0; I < methods_size; ++I)
+        {
+            auto entry = methods_offset + I * 8;
+
+            class_idx = stream->read_unchecked<std::uint16_t>(entry);
+            proto_idx = stream->read_unchecked<std::uint16_t>(entry + 2);
+            name_idx = stream->read_unchecked<std::uint32_t>(entry + 4);
+
+            methods.push_back(arena->make<MethodID>(
+                types->get_type_from_order_unchecked(class_idx),
+                protos->get_proto_by_order_unchecked(proto_idx),
+                strings->get_string_by_id_unchecked(name_idx)));
+        }
+    }
+    else
+    {
+        for (size_t I = 0; I < methods_size; ++I)
+        {
+            stream->read_data<std::uint16_t>(class_idx, sizeof(std::uint16_t));
+
+            stream->read_data<std::uint16_t>(proto_idx, sizeof(std::uint16_t));
+
+            stream->read_data<std::uint32_t>(name_idx, sizeof(std::uint32_t));
+            // create the object with the information
+            methodid = arena->make<MethodID>(
+                types->get_type_from_order(class_idx),
+                protos->get_proto_by_order(proto_idx),
+                strings->get_string_by_id(name_idx));
+            // move the ownership to the vector
+            methods.push_back(std::move(methodid));
+        }
     }
 
     // return to the previous offset
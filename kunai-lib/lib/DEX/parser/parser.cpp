@@ -9,10 +9,16 @@
 #include "Kunai/DEX/DVM/dvm_types.hpp"
 #include "Kunai/Exceptions/parser_exception.hpp"
 #include "Kunai/Exceptions/incorrectdexfile_exception.hpp"
+#include "Kunai/Exceptions/incorrectid_exception.hpp"
+#include "Kunai/Exceptions/outofbound_exception.hpp"
+#include "Kunai/Exceptions/stream_exception.hpp"
+
+#include <future>
+#include <type_traits>
 
 using namespace KUNAI::DEX;
 
-void Parser::parse_file()
+bool Parser::check_and_parse_header()
 {
     std::uint8_t magic[4];
     auto logger = LOGGER::logger();
@@ -20,13 +26,19 @@ void Parser::parse_file()
     logger->debug("parser.cpp: started parsing of dex file");
 
     if (stream->get_size() < sizeof(Header::dexheader_t))
-        throw exceptions::ParserException("parser.cpp: file has incorrect size");
+    {
+        diagnostic = {parse_error_e::INCORRECT_SIZE, "parser.cpp: file has incorrect size", 0};
+        return false;
+    }
 
     // read a header to do simple check
     stream->read_data<std::uint8_t[4]>(magic, sizeof(std::uint8_t[4]));
 
     if (memcmp(magic, KUNAI::DEX::dex_magic, 4))
-        throw exceptions::IncorrectDexFileException("parser.cpp: file is not a dex file");
+    {
+        diagnostic = {parse_error_e::INCORRECT_MAGIC, "parser.cpp: file is not a dex file", 0};
+        return false;
+    }
 
     // move to the beginning
     stream->seekg(0, std::ios_base::beg);
@@ -34,15 +46,356 @@ void Parser::parse_file()
     // start now parsing
     header.parse_headers(stream);
 
+    diagnostic = check_limits();
+
+    if (!diagnostic.is_correct())
+        return false;
+
+    // the fast path reads the tables directly from memory, the
+    // tables of a file are only checked to fail fast
+    bool fast_path = options.trusted_fast_path && stream->is_memory_backed();
+
+    if (fast_path || options.fail_fast)
+    {
+        auto position = stream->tellg();
+        auto tables_diagnostic = check_tables();
+
+        stream->seekg(position, std::ios_base::beg);
+
+        tables_validated = fast_path && tables_diagnostic.is_correct();
+
+        // the incorrect tables are reported without trying to parse them
+        if (options.fail_fast && !tables_diagnostic.is_correct())
+        {
+            diagnostic = std::move(tables_diagnostic);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Parser::parse_file()
+{
+    if (!check_and_parse_header())
+    {
+        if (diagnostic.error == parse_error_e::INCORRECT_MAGIC)
+            throw exceptions::IncorrectDexFileException(diagnostic.message);
+        throw exceptions::ParserException(diagnostic.message);
+    }
+
+    if (!parse_tables())
+        throw exceptions::ParserException(diagnostic.message);
+}
+
+const parse_diagnostic_t &Parser::try_parse_file()
+{
+    try
+    {
+        if (check_and_parse_header())
+            parse_tables();
+    }
+    catch (const exceptions::IncorrectIDException &e)
+    {
+        diagnostic = {parse_error_e::INCORRECT_ID, e.what(), 0};
+    }
+    catch (const exceptions::OutOfBoundException &e)
+    {
+        diagnostic = {parse_error_e::OUT_OF_BOUND, e.what(), 0};
+    }
+    catch (const exceptions::IncorrectDexFileException &e)
+    {
+        diagnostic = {parse_error_e::INCORRECT_INTEGRITY, e.what(), 0};
+    }
+    catch (const exceptions::StreamException &e)
+    {
+        diagnostic = {parse_error_e::STREAM_ERROR, e.what(), 0};
+    }
+    catch (const std::exception &e)
+    {
+        diagnostic = {parse_error_e::PARSER_ERROR, e.what(), 0};
+    }
+
+    return diagnostic;
+}
+
+bool Parser::parse_tables()
+{
+    auto logger = LOGGER::logger();
     auto &dex_header = header.get_dex_header_const();
 
+    std::future<void> integrity;
+
+    if (options.verify_checksum || options.verify_signature)
+    {
+        // in memory the file is only read, so the verification
+        // runs while the tables are parsed
+        if (stream->is_memory_backed())
+            integrity = std::async(std::launch::async, [this]()
+                                   { header.verify(stream, options.verify_checksum, options.verify_signature); });
+        else
+            header.verify(stream, options.verify_checksum, options.verify_signature);
+    }
+
+    if (tables_validated)
+        logger->debug("parser.cpp: tables validated, using the fast path");
+
     maplist.parse_map_list(stream, dex_header.map_off);
-    strings.parse_strings(dex_header.string_ids_off, dex_header.string_ids_size, stream);
-    types.parse_types(stream, &strings, dex_header.type_ids_size, dex_header.type_ids_off);
-    protos.parse_protos(stream, dex_header.proto_ids_size, dex_header.proto_ids_off, &strings, &types);
-    fields.parse_fields(stream, &types, &strings, dex_header.field_ids_off, dex_header.field_ids_size);
-    methods.parse_methods(stream, &types, &protos, &strings, dex_header.method_ids_off, dex_header.method_ids_size);
-    classes.parse_classes(stream, dex_header.class_defs_size, dex_header.class_defs_off, &strings, &types, &fields, &methods);
+
+    if (options.parse_level >= parse_level_e::STRINGS)
+    {
+        strings.parse_strings(dex_header.string_ids_off, dex_header.string_ids_size, stream, tables_validated);
+
+        std::uint32_t incorrect_id;
+
+        // the strings are still decoded on demand, only checked here
+        if (options.validate_strings && !strings.validate_strings(incorrect_id))
+        {
+            diagnostic = {parse_error_e::INCORRECT_STRING, "parser.cpp: incorrect MUTF-8 string " + std::to_string(incorrect_id),
+                          strings.get_strings_offsets()[incorrect_id]};
+            return false;
+        }
+    }
+
+    if (options.parse_level < parse_level_e::IDS)
+        logger->debug("parser.cpp: parse level reached, ids not parsed");
+    else if (options.parallel_parsing && stream->is_memory_backed())
+        parse_tables_parallel();
+    else
+    {
+        types.parse_types(stream, &strings, dex_header.type_ids_size, dex_header.type_ids_off, tables_validated);
+        protos.parse_protos(stream, dex_header.proto_ids_size, dex_header.proto_ids_off, &strings, &types, &arena, tables_validated);
+        fields.parse_fields(stream, &types, &strings, dex_header.field_ids_off, dex_header.field_ids_size, &arena, tables_validated);
+        methods.parse_methods(stream, &types, &protos, &strings, dex_header.method_ids_off, dex_header.method_ids_size, &arena, tables_validated);
+
+        if (options.parse_level >= parse_level_e::CLASS_DEFS)
+            classes.parse_classes(stream, dex_header.class_defs_size, dex_header.class_defs_off, &strings, &types, &fields, &methods, &arena, &options.limits, get_lazy_classes());
+    }
+
+    // rethrow the errors of the verification
+    if (integrity.valid())
+        integrity.get();
 
     logger->debug("parser.cpp: dex file parsing correct");
-}
\ No newline at end of file
+
+    return true;
+}
+
+void Parser::parse_tables_parallel()
+{
+    auto logger = LOGGER::logger();
+    auto &dex_header = header.get_dex_header_const();
+    auto buffer = stream->get_buffer();
+    utils::ThreadPool pool(options.number_of_threads);
+    std::vector<std::future<void>> futures;
+
+    logger->debug("parser.cpp: parsing tables with {} threads", pool.get_number_of_threads());
+
+    // all the other tables point to the types
+    types.parse_types(stream, &strings, dex_header.type_ids_size, dex_header.type_ids_off, tables_validated);
+
+    // fields only depend on types and strings
+    futures.push_back(pool.submit([&]()
+    {
+        stream::KunaiStream fields_stream(buffer);
+        fields.parse_fields(&fields_stream, &types, &strings, dex_header.field_ids_off, dex_header.field_ids_size, &arena, tables_validated);
+    }));
+
+    // methods depend on the protos
+    futures.push_back(pool.submit([&]()
+    {
+        stream::KunaiStream ids_stream(buffer);
+        protos.parse_protos(&ids_stream, dex_header.proto_ids_size, dex_header.proto_ids_off, &strings, &types, &arena, tables_validated);
+        methods.parse_methods(&ids_stream, &types, &protos, &strings, dex_header.method_ids_off, dex_header.method_ids_size, &arena, tables_validated);
+    }));
+
+    utils::ThreadPool::wait_all(futures);
+
+    if (options.parse_level >= parse_level_e::CLASS_DEFS)
+        classes.parse_classes(stream, dex_header.class_defs_size, dex_header.class_defs_off, &strings, &types, &fields, &methods, &arena, &options.limits, get_lazy_classes(), &pool);
+}
+
+parse_diagnostic_t Parser::check_limits() const
+{
+    auto &dex_header = header.get_dex_header_const();
+    std::uint64_t file_size = stream->get_size();
+
+    struct table_t
+    {
+        const char *name;           //! name of the table
+        std::uint64_t offset;       //! offset of the table
+        std::uint64_t size;         //! number of entries
+        std::uint64_t entry_size;   //! size of each entry in the file
+        std::uint64_t memory_size;  //! memory of each entry once parsed
+    };
+
+    const table_t tables[] = {
+        {"string_ids", dex_header.string_ids_off, dex_header.string_ids_size, 4,
+         sizeof(std::uint32_t) + sizeof(std::string) + sizeof(std::atomic<bool>)},
+        {"type_ids", dex_header.type_ids_off, dex_header.type_ids_size, 4,
+         sizeof(DVMClass) + sizeof(DVMType *) + sizeof(std::pair<std::uint32_t, DVMType *>)},
+        {"proto_ids", dex_header.proto_ids_off, dex_header.proto_ids_size, 12,
+         sizeof(ProtoID) + sizeof(protoid_t)},
+        {"field_ids", dex_header.field_ids_off, dex_header.field_ids_size, 8,
+         sizeof(FieldID) + sizeof(fieldid_t)},
+        {"method_ids", dex_header.method_ids_off, dex_header.method_ids_size, 8,
+         sizeof(MethodID) + sizeof(methodid_t)},
+        {"class_defs", dex_header.class_defs_off, dex_header.class_defs_size, 32,
+         sizeof(ClassDef) + sizeof(classdef_t)},
+    };
+
+    // the sizes are 32 bits, so they cannot overflow with 64 bits
+    for (const auto &table : tables)
+    {
+        if (table.size != 0 && table.offset + table.size * table.entry_size > file_size)
+            return {parse_error_e::INCORRECT_TABLE,
+                    std::string("parser.cpp: table ") + table.name + " out of the file", table.offset};
+
+        if (table.size * table.memory_size > options.limits.max_allocation)
+            return {parse_error_e::LIMIT_EXCEEDED,
+                    std::string("parser.cpp: table ") + table.name + " over the allocation limit", table.offset};
+    }
+
+    return {};
+}
+
+parse_diagnostic_t Parser::check_tables() const
+{
+    auto &dex_header = header.get_dex_header_const();
+    std::uint64_t file_size = stream->get_size();
+
+    // the sizes are computed with 64 bits so they cannot overflow
+    auto table_in_file = [&](std::uint64_t offset, std::uint64_t size, std::uint64_t entry_size)
+    {
+        return size == 0 || offset + size * entry_size <= file_size;
+    };
+
+    // every offset is checked before it is read, so the values of a
+    // file in memory are read without checks, and those of a file on
+    // disk are read moving the cursor of the stream
+    auto read_value = [&](std::uint64_t offset, auto &value)
+    {
+        using value_t = std::remove_reference_t<decltype(value)>;
+
+        if (stream->is_memory_backed())
+        {
+            value = stream->read_unchecked<value_t>(offset);
+            return;
+        }
+
+        stream->seekg(static_cast<std::streamoff>(offset), std::ios_base::beg);
+        stream->read_data<value_t>(value, sizeof(value_t));
+    };
+
+    auto read = [&](std::uint64_t offset)
+    {
+        std::uint32_t value;
+        read_value(offset, value);
+        return value;
+    };
+
+    auto read16 = [&](std::uint64_t offset)
+    {
+        std::uint16_t value;
+        read_value(offset, value);
+        return value;
+    };
+
+    auto incorrect = [](const std::string &message, std::uint64_t offset)
+    {
+        return parse_diagnostic_t{parse_error_e::INCORRECT_TABLE, "parser.cpp: " + message, offset};
+    };
+
+    if (!table_in_file(dex_header.string_ids_off, dex_header.string_ids_size, 4) ||
+        !table_in_file(dex_header.type_ids_off, dex_header.type_ids_size, 4) ||
+        !table_in_file(dex_header.proto_ids_off, dex_header.proto_ids_size, 12) ||
+        !table_in_file(dex_header.field_ids_off, dex_header.field_ids_size, 8) ||
+        !table_in_file(dex_header.method_ids_off, dex_header.method_ids_size, 8) ||
+        !table_in_file(dex_header.class_defs_off, dex_header.class_defs_size, 32))
+        return incorrect("table of ids out of the file", 0);
+
+    // the map list must be inside of the file, and also the items it points to
+    if (!table_in_file(dex_header.map_off, 1, 4))
+        return incorrect("map list out of the file", dex_header.map_off);
+
+    auto map_size = read(dex_header.map_off);
+
+    if (!table_in_file(dex_header.map_off + 4ULL, map_size, 12))
+        return incorrect("map list out of the file", dex_header.map_off);
+
+    for (std::uint64_t I = 0; I < map_size; ++I)
+        if (read(dex_header.map_off + 4 + I * 12 + 8) >= file_size)
+            return incorrect("map item out of the file", dex_header.map_off + 4 + I * 12);
+
+    for (std::uint64_t I = 0; I < dex_header.string_ids_size; ++I)
+        if (read(dex_header.string_ids_off + I * 4) >= file_size)
+            return incorrect("string out of the file", dex_header.string_ids_off + I * 4);
+
+    for (std::uint64_t I = 0; I < dex_header.type_ids_size; ++I)
+        if (read(dex_header.type_ids_off + I * 4) >= dex_header.string_ids_size)
+            return incorrect("type with incorrect string id", dex_header.type_ids_off + I * 4);
+
+    for (std::uint64_t I = 0; I < dex_header.proto_ids_size; ++I)
+    {
+        auto entry = dex_header.proto_ids_off + I * 12;
+        auto parameters_off = read(entry + 8);
+
+        if (read(entry) >= dex_header.string_ids_size ||
+            read(entry + 4) >= dex_header.type_ids_size)
+            return incorrect("proto with incorrect ids", entry);
+
+        if (parameters_off == 0)
+            continue;
+
+        if (!table_in_file(parameters_off, 1, 4))
+            return incorrect("parameters of proto out of the file", entry);
+
+        auto n_parameters = read(parameters_off);
+
+        if (!table_in_file(parameters_off + 4ULL, n_parameters, 2))
+            return incorrect("parameters of proto out of the file", entry);
+
+        for (std::uint64_t J = 0; J < n_parameters; ++J)
+            if (read16(parameters_off + 4 + J * 2) >= dex_header.type_ids_size)
+                return incorrect("parameter of proto with incorrect type id", parameters_off + 4 + J * 2);
+    }
+
+    for (std::uint64_t I = 0; I < dex_header.field_ids_size; ++I)
+    {
+        auto entry = dex_header.field_ids_off + I * 8;
+
+        if (read16(entry) >= dex_header.type_ids_size ||
+            read16(entry + 2) >= dex_header.type_ids_size ||
+            read(entry + 4) >= dex_header.string_ids_size)
+            return incorrect("field with incorrect ids", entry);
+    }
+
+    for (std::uint64_t I = 0; I < dex_header.method_ids_size; ++I)
+    {
+        auto entry = dex_header.method_ids_off + I * 8;
+
+        if (read16(entry) >= dex_header.type_ids_size ||
+            read16(entry + 2) >= dex_header.proto_ids_size ||
+            read(entry + 4) >= dex_header.string_ids_size)
+            return incorrect("method with incorrect ids", entry);
+    }
+
+    for (std::uint64_t I = 0; I < dex_header.class_defs_size; ++I)
+    {
+        auto entry = dex_header.class_defs_off + I * 32;
+        auto superclass_idx = read(entry + 8);
+        auto source_file_idx = read(entry + 16);
+
+        if (read(entry) >= dex_header.type_ids_size ||
+            (superclass_idx != NO_INDEX && superclass_idx >= dex_header.type_ids_size) ||
+            (source_file_idx != NO_INDEX && source_file_idx >= dex_header.string_ids_size))
+            return incorrect("class_def with incorrect ids", entry);
+
+        // interfaces, annotations, class data and static values
+        for (auto field : {12, 20, 24, 28})
+            if (read(entry + field) >= file_size)
+                return incorrect("data of class_def out of the file", entry);
+    }
+
+    return {};
+}
@@ -43,7 +43,9 @@ void Protos::parse_protos(stream::KunaiStream *stream,
                           std::uint32_t number_of_protos,
                           std::uint32_t offset,
                           Strings *strings,
-                          Types *types)
+                          Types *types,
+                          utils::Arena *arena,
+                          bool trusted)
 {
     auto logger = LOGGER::logger();
     auto current_offset = stream->tellg();
@@ -58,20 +60,51 @@ void Protos::parse_protos(stream::KunaiStream *stream,
     // set to current offset
     stream->seekg(offset, std::ios_base::beg);
 
-    for (size_t I = 0; I < number_of_protos; ++I)
+    if (trusted)
     {
-        stream->read_data<std::uint32_t>(shorty_idx, sizeof(std::uint32_t));
+        // the table, its ids and the lists of parameters were validated
+        proto_ids.reserve(number_of_protos);
 
-        stream->read_data<std::uint32_t>(return_type_idx, sizeof(std::uint32_t));
+        for (size_t I = 0; I < number_of_protos; ++I)
+        {
+            auto entry = offset + I * 12;
+            std::vector<DVMType *> parameters;
+
+            shorty_idx = stream->read_unchecked<std::uint32_t>(entry);
+            return_type_idx = stream->read_unchecked<std::uint32_t>(entry + 4);
+            parameters_off = stream->read_unchecked<std::uint32_t>(entry + 8);
+
+            if (parameters_off)
+            {
+                auto n_parameters = stream->read_unchecked<std::uint32_t>(parameters_off);
+                parameters.reserve(n_parameters);
+                for (size_t J = 0; J < n_parameters; ++J)
+                    parameters.push_back(types->get_type_from_order_unchecked(
+                        stream->read_unchecked<std::uint16_t>(parameters_off + 4 + J * 2)));
+            }
+
+            proto_ids.push_back(arena->make<ProtoID>(strings->get_string_by_id_unchecked(shorty_idx),
+                                                     types->get_type_from_order_unchecked(return_type_idx),
+                                                     std::move(parameters)));
+        }
+    }
+    else
+    {
+        for (size_t I = 0; I < number_of_protos; ++I)
+        {
+            stream->read_data<std::uint32_t>(shorty_idx, sizeof(std::uint32_t));
+
+            stream->read_data<std::uint32_t>(return_type_idx, sizeof(std::uint32_t));
 
-        stream->read_data<std::uint32_t>(parameters_off, sizeof(std::uint32_t));
+            stream->read_data<std::uint32_t>(parameters_off, sizeof(std::uint32_t));
 
-        protoid = std::make_unique<ProtoID>(stream,
-                                            types,
-                                            strings->get_string_by_id(shorty_idx),
-                                            return_type_idx,
-                                            parameters_off);
-        proto_ids.push_back(std::move(protoid));
+            protoid = arena->make<ProtoID>(stream,
+                                           types,
+                                           strings->get_string_by_id(shorty_idx),
+                                           return_type_idx,
+                                           parameters_off);
+            proto_ids.push_back(std::move(protoid));
+        }
     }
 
     logger->debug("protos.cpp: finished parsing protos");
@@ -7,6 +7,7 @@
 
 #include "Kunai/DEX/parser/strings.hpp"
 #include "Kunai/Utils/logger.hpp"
+#include "Kunai/Utils/mutf8.hpp"
 #include "Kunai/Exceptions/incorrectid_exception.hpp"
 #include "Kunai/Exceptions/outofbound_exception.hpp"
 
@@ -14,35 +15,31 @@
 
 using namespace KUNAI::DEX;
 
-Strings::Strings(Strings &str)
+Strings::Strings(Strings &str) : strings_offset(str.strings_offset),
+                                 number_of_strings(str.number_of_strings),
+                                 stream(str.stream),
+                                 strings_offsets(str.strings_offsets),
+                                 strings_offsets_sorted(str.strings_offsets_sorted),
+                                 ordered_strings(str.ordered_strings),
+                                 decoded_strings(std::make_unique<std::atomic<bool>[]>(str.number_of_strings))
 {
-    std::vector<std::uint32_t> str_offsets;
-
-    for (auto val : str.offset_strings)
-    {
-        auto offset = val.first;
-        auto ptr_str = val.second;
-
-        str_offsets.push_back(offset);
-        ordered_strings.push_back(*ptr_str);
-    }
-
-    for (size_t I = 0; I < ordered_strings.size(); ++I)
-        offset_strings[str_offsets[I]] = &ordered_strings[I];
+    for (std::uint32_t I = 0; I < number_of_strings; ++I)
+        decoded_strings[I].store(str.decoded_strings[I].load());
 }
 
 void Strings::parse_strings(std::uint32_t strings_offset,
                             std::uint32_t number_of_strings,
-                            stream::KunaiStream *stream)
+                            stream::KunaiStream *stream,
+                            bool trusted)
 {
-    std::vector<std::uint32_t> str_offsets;
-
     // utilities
     size_t I;
     auto logger = LOGGER::logger();
     auto current_offset = stream->tellg();
     // store it, will be useful...
+    this->strings_offset = strings_offset;
     this->number_of_strings = number_of_strings;
+    this->stream = stream;
 
     // values
     std::uint32_t str_offset;
@@ -52,51 +49,232 @@ void Strings::parse_strings(std::uint32_t strings_offset,
 
     logger->debug("started parsing strings");
 
-    for (I = 0; I < number_of_strings; ++I)
+    strings_offsets.reserve(number_of_strings);
+
+    if (trusted)
+    {
+        // the table and the offsets were validated, so they
+        // are directly taken from the buffer
+        strings_offsets.resize(number_of_strings);
+        for (I = 0; I < number_of_strings; ++I)
+            strings_offsets[I] = stream->read_unchecked<std::uint32_t>(strings_offset + I * sizeof(std::uint32_t));
+        strings_offsets_sorted = std::is_sorted(strings_offsets.begin(), strings_offsets.end());
+    }
+    else
     {
-        stream->read_data<std::uint32_t>(str_offset, sizeof(std::uint32_t));
+        for (I = 0; I < number_of_strings; ++I)
+        {
+            stream->read_data<std::uint32_t>(str_offset, sizeof(std::uint32_t));
+
+            if (str_offset > stream->get_size())
+                throw exceptions::OutOfBoundException("strings.cpp: string offset out of bound");
 
-        if (str_offset > stream->get_size())
-            throw exceptions::OutOfBoundException("strings.cpp: string offset out of bound");
+            if (!strings_offsets.empty() && strings_offsets.back() > str_offset)
+                strings_offsets_sorted = false;
 
-        // read the strings from the offset and store it
-        str_offsets.push_back(str_offset); // keep the offset for later
-        ordered_strings.push_back(stream->read_dex_string(str_offset));
+            // only keep the offset, the string is decoded on demand
+            strings_offsets.push_back(str_offset);
+        }
     }
-    /// store the offsets and the strings
-    for (I = 0; I < ordered_strings.size(); ++I)
-        offset_strings[str_offsets[I]] = &ordered_strings[I];
+
+    // the strings are never added once parsed, so the references
+    // to the decoded strings are stable
+    ordered_strings.resize(number_of_strings);
+    decoded_strings = std::make_unique<std::atomic<bool>[]>(number_of_strings);
+    for (I = 0; I < number_of_strings; ++I)
+        decoded_strings[I].store(false, std::memory_order_relaxed);
 
     // return to the stored offset
     stream->seekg(current_offset, std::ios_base::beg);
 }
 
+bool Strings::locate_string_data(std::uint32_t id, std::size_t &pos, std::uint64_t &utf16_size)
+{
+    auto buffer = stream->get_buffer();
+    unsigned shift = 0;
+    std::uint8_t byte_read;
+
+    pos = strings_offsets[id];
+    utf16_size = 0;
+
+    do
+    {
+        if (pos >= buffer.size())
+            return false;
+        byte_read = buffer[pos++];
+        utf16_size |= static_cast<std::uint64_t>(byte_read & 0x7f) << shift;
+        shift += 7;
+    } while (byte_read & 0x80);
+
+    return true;
+}
+
+std::string *Strings::try_decode_string(std::uint32_t id)
+{
+    if (decoded_strings[id].load(std::memory_order_acquire))
+        return &ordered_strings[id];
+
+    std::string decoded;
+
+    // in memory the string is decoded without the cursor of
+    // the stream, so different threads can decode at the same time
+    if (stream->is_memory_backed())
+    {
+        std::size_t pos;
+        std::uint64_t utf16_size;
+
+        if (!locate_string_data(id, pos, utf16_size) ||
+            stream::mutf8::decode_to_utf8(stream->get_buffer().subspan(pos), utf16_size, decoded) < 0)
+            return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(decode_mutex);
+
+    if (!decoded_strings[id].load(std::memory_order_relaxed))
+    {
+        if (!stream->is_memory_backed())
+        {
+            // the stream of a file reports its errors with exceptions
+            try
+            {
+                decoded = stream->read_dex_string(strings_offsets[id]);
+            }
+            catch (const std::exception &)
+            {
+                return nullptr;
+            }
+        }
+        ordered_strings[id] = std::move(decoded);
+        decoded_strings[id].store(true, std::memory_order_release);
+    }
+
+    return &ordered_strings[id];
+}
+
+std::string &Strings::decode_string(std::uint32_t id)
+{
+    auto decoded = try_decode_string(id);
+
+    if (decoded == nullptr)
+        throw exceptions::OutOfBoundException("strings.cpp: string out of bound or incorrect MUTF-8 string");
+
+    return *decoded;
+}
+
 std::string *Strings::get_string_from_offset(std::uint32_t offset)
 {
-    auto it = offset_strings.find(offset);
+    if (strings_offsets_sorted)
+    {
+        auto it = std::lower_bound(strings_offsets.begin(), strings_offsets.end(), offset);
 
-    if (it == offset_strings.end())
-        throw exceptions::IncorrectIDException("strings.cpp: offset for string incorrect");
+        if (it != strings_offsets.end() && *it == offset)
+            return &decode_string(static_cast<std::uint32_t>(it - strings_offsets.begin()));
+    }
+    else
+    {
+        auto it = std::find(strings_offsets.begin(), strings_offsets.end(), offset);
 
-    return it->second;
+        if (it != strings_offsets.end())
+            return &decode_string(static_cast<std::uint32_t>(it - strings_offsets.begin()));
+    }
+
+    throw exceptions::IncorrectIDException("strings.cpp: offset for string incorrect");
 }
 
 std::string &Strings::get_string_by_id(std::uint32_t id)
 {
     if (id >= number_of_strings)
         throw exceptions::IncorrectIDException("strings.cpp: id for string incorrect");
-    return ordered_strings[id];
+    return decode_string(id);
+}
+
+std::string *Strings::try_get_string_by_id(std::uint32_t id)
+{
+    if (id >= number_of_strings)
+        return nullptr;
+    return try_decode_string(id);
+}
+
+std::string_view Strings::get_string_view_by_id(std::uint32_t id)
+{
+    if (id >= number_of_strings)
+        throw exceptions::IncorrectIDException("strings.cpp: id for string incorrect");
+
+    if (decoded_strings[id].load(std::memory_order_acquire) || !stream->is_memory_backed())
+        return decode_string(id);
+
+    // point directly to the data of the string in the file
+    auto buffer = stream->get_buffer();
+    std::size_t pos;
+    std::uint64_t utf16_size;
+
+    if (!locate_string_data(id, pos, utf16_size))
+        throw exceptions::OutOfBoundException("strings.cpp: string out of bound");
+
+    // ASCII strings are the same in MUTF-8 and in UTF-8, the others
+    // must be decoded
+    auto ascii_size = stream::mutf8::ascii_length(buffer.data() + pos, buffer.size() - pos);
+
+    if (ascii_size != utf16_size || pos + ascii_size >= buffer.size() || buffer[pos + ascii_size] != 0)
+        return decode_string(id);
+
+    return {reinterpret_cast<const char *>(buffer.data() + pos), ascii_size};
+}
+
+void Strings::decode_all_strings()
+{
+    for (std::uint32_t I = 0; I < number_of_strings; ++I)
+        decode_string(I);
+}
+
+bool Strings::validate_strings(std::uint32_t &incorrect_id)
+{
+    std::string decoded;
+
+    for (std::uint32_t I = 0; I < number_of_strings; ++I)
+    {
+        if (decoded_strings[I].load(std::memory_order_acquire))
+            continue;
+
+        if (stream->is_memory_backed())
+        {
+            std::size_t pos;
+            std::uint64_t utf16_size;
+
+            // the same buffer is used for all the strings
+            if (locate_string_data(I, pos, utf16_size) &&
+                stream::mutf8::decode_to_utf8(stream->get_buffer().subspan(pos), utf16_size, decoded) >= 0)
+                continue;
+        }
+        else
+        {
+            // the stream of a file reports its errors with exceptions
+            try
+            {
+                stream->read_dex_string(strings_offsets[I]);
+                continue;
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+
+        incorrect_id = I;
+        return false;
+    }
+
+    return true;
 }
 
 void Strings::to_xml(std::ofstream &fos)
 {
     fos << std::hex;
     fos << "<strings>\n";
-    for (const auto &s : offset_strings)
+    for (std::uint32_t I = 0; I < number_of_strings; ++I)
     {
         fos << "\t<string>\n";
-        fos << "\t\t<offset>" << s.first << "</offset>\n";
-        fos << "\t\t<value>" << *s.second << "</value>\n";
+        fos << "\t\t<offset>" << strings_offsets[I] << "</offset>\n";
+        fos << "\t\t<value>" << get_string_view_by_id(I) << "</value>\n";
         fos << "\t</string>\n";
     }
     fos << "</strings>\n";
@@ -106,16 +284,14 @@ namespace KUNAI
 {
 namespace DEX
 {
-    std::ostream &operator<<(std::ostream &os, const Strings &entry)
+    std::ostream &operator<<(std::ostream &os, Strings &entry)
     {
-        size_t I = 0;
-        auto &ordered_strings = entry.get_ordered_strings();
-        auto &offset_strings = entry.get_offset_strings();
+        auto &strings_offsets = entry.get_strings_offsets();
         os << std::hex;
         os << "Dex Strings\n";
-        for (const auto s : offset_strings)
-            os << std::left << std::setfill(' ') << "String (" << std::dec << I++ << "): " << s.first << "->\"" << *s.second << "\"\n";
+        for (std::uint32_t I = 0, E = entry.get_number_of_strings(); I < E; ++I)
+            os << std::left << std::setfill(' ') << "String (" << std::dec << I << "): " << std::hex << strings_offsets[I] << "->\"" << entry.get_string_view_by_id(I) << "\"\n";
         return os;
     }
 }
-}
\ No newline at end of file
+}
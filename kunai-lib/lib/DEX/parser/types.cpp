@@ -8,103 +8,171 @@
 #include "Kunai/Utils/logger.hpp"
 #include "Kunai/Exceptions/incorrectid_exception.hpp"
 
+#include <algorithm>
 #include <iomanip>
 
 using namespace KUNAI::DEX;
 
 DVMType *Types::get_type_by_id(std::uint32_t type_id)
 {
-    auto it = types_by_id.find(type_id);
+    auto type = try_get_type_by_id(type_id);
 
-    if (it == types_by_id.end())
+    if (type == nullptr)
         throw exceptions::IncorrectIDException("types.cpp: id for type not found");
 
+    return type;
+}
+
+DVMType *Types::try_get_type_by_id(std::uint32_t type_id) const
+{
+    auto it = std::lower_bound(types_by_id.begin(), types_by_id.end(), type_id,
+                               [](const std::pair<std::uint32_t, DVMType *> &entry, std::uint32_t id)
+                               { return entry.first < id; });
+
+    if (it == types_by_id.end() || it->first != type_id)
+        return nullptr;
+
     return it->second;
 }
 
 DVMType *Types::get_type_from_order(std::uint32_t pos)
 {
-    if (pos >= ordered_types.size())
+    auto type = try_get_type_from_order(pos);
+
+    if (type == nullptr)
         throw exceptions::IncorrectIDException("types.cpp: position for type incorrect");
 
-    return ordered_types[pos].get();
+    return type;
 }
 
-const std::string& DVMClass::pretty_print()
+DVMClass::DVMClass(std::string name) : DVMType(CLASS, name), name(name)
 {
-    if (!pretty_name.empty())
-        return pretty_name;
-
-    pretty_name = name.substr(1, name.size() - 2);
+    // remove the 'L' and the ';' from the name
+    if (this->name.size() >= 2)
+        pretty_name = this->name.substr(1, this->name.size() - 2);
     std::replace(std::begin(pretty_name), std::end(pretty_name), '/', '.');
-    return pretty_name;
 }
 
-const std::string& DVMArray::pretty_print()
+DVMArray::DVMArray(std::string raw, size_t depth, DVMType *array)
+    : DVMType(ARRAY, raw), depth(depth), array_type(array)
 {
-    if (!pretty_name.empty())
-        return pretty_name;
+    // the type of the array is interned before the array
     pretty_name = array_type->pretty_print();
     for (size_t I = 0; I < depth; ++I)
         pretty_name += "[]";
-    return pretty_name;
 }
 
-dvmtype_t Types::parse_type(std::string &name)
+DVMFundamental *DVMFundamental::get_fundamental(fundamental_e f_type)
 {
-    switch (name.at(0))
-    {
+    // created once, in the same order than the enum
+    static DVMFundamental fundamentals[] = {
+        {BOOLEAN, "Z"},
+        {BYTE, "B"},
+        {CHAR, "C"},
+        {DOUBLE, "D"},
+        {FLOAT, "F"},
+        {INT, "I"},
+        {LONG, "J"},
+        {SHORT, "S"},
+        {VOID, "V"}};
+
+    return &fundamentals[f_type];
+}
+
+DVMType *Types::get_type_by_name(std::string_view name) const
+{
+    auto it = interned_types.find(name);
+
+    if (it == interned_types.end())
+        return nullptr;
 
-    case 'Z':
-        return std::make_unique<DVMFundamental>(DVMFundamental::BOOLEAN, name);
-    case 'B':
-        return std::make_unique<DVMFundamental>(DVMFundamental::BYTE, name);
-    case 'C':
-        return std::make_unique<DVMFundamental>(DVMFundamental::CHAR, name);
-    case 'D':
-        return std::make_unique<DVMFundamental>(DVMFundamental::DOUBLE, name);
-    case 'F':
-        return std::make_unique<DVMFundamental>(DVMFundamental::FLOAT, name);
-    case 'I':
-        return std::make_unique<DVMFundamental>(DVMFundamental::INT, name);
-    case 'J':
-        return std::make_unique<DVMFundamental>(DVMFundamental::LONG, name);
-    case 'S':
-        return std::make_unique<DVMFundamental>(DVMFundamental::SHORT, name);
-    case 'V':
-        return std::make_unique<DVMFundamental>(DVMFundamental::VOID, name);
-    case 'L':
-        return std::make_unique<DVMClass>(name);
-    case '[':
+    return it->second;
+}
+
+DVMType *Types::parse_type(std::string_view name)
+{
+    auto it = interned_types.find(name);
+
+    if (it != interned_types.end())
+        return it->second;
+
+    DVMType *interned = nullptr;
+
+    if (name.size() == 1)
     {
-        size_t depth = 0;
-        const char *name_cpy = name.c_str();
-        while (name_cpy[0] == '[')
+        switch (name[0])
         {
-            depth++;
-            name_cpy++;
+        case 'Z':
+            interned = DVMFundamental::get_fundamental(DVMFundamental::BOOLEAN);
+            break;
+        case 'B':
+            interned = DVMFundamental::get_fundamental(DVMFundamental::BYTE);
+            break;
+        case 'C':
+            interned = DVMFundamental::get_fundamental(DVMFundamental::CHAR);
+            break;
+        case 'D':
+            interned = DVMFundamental::get_fundamental(DVMFundamental::DOUBLE);
+            break;
+        case 'F':
+            interned = DVMFundamental::get_fundamental(DVMFundamental::FLOAT);
+            break;
+        case 'I':
+            interned = DVMFundamental::get_fundamental(DVMFundamental::INT);
+            break;
+        case 'J':
+            interned = DVMFundamental::get_fundamental(DVMFundamental::LONG);
+            break;
+        case 'S':
+            interned = DVMFundamental::get_fundamental(DVMFundamental::SHORT);
+            break;
+        case 'V':
+            interned = DVMFundamental::get_fundamental(DVMFundamental::VOID);
+            break;
         }
-        std::string aux(name_cpy);
-        dvmtype_t aux_type = parse_type(aux);
-        return std::make_unique<DVMArray>(name, depth, aux_type);
     }
-    default:
-        return std::make_unique<Unknown>(name);
+
+    if (interned == nullptr)
+    {
+        dvmtype_t type;
+
+        if (!name.empty() && name[0] == 'L')
+            type = std::make_unique<DVMClass>(std::string(name));
+        else if (!name.empty() && name[0] == '[')
+        {
+            size_t depth = 0;
+            while (depth < name.size() && name[depth] == '[')
+                depth++;
+            // the elements point to the interned type
+            DVMType *aux_type = parse_type(name.substr(depth));
+            type = std::make_unique<DVMArray>(std::string(name), depth, aux_type);
+        }
+        else
+            type = std::make_unique<Unknown>(std::string(name));
+
+        interned = type.get();
+        owned_types.push_back(std::move(type));
     }
+
+    // the key points to the name stored in the type
+    interned_types[interned->get_raw_view()] = interned;
+
+    return interned;
 }
 
 void Types::parse_types(
     stream::KunaiStream *stream,
     Strings *strings,
     std::uint32_t number_of_types,
-    std::uint32_t types_offset)
+    std::uint32_t types_offset,
+    bool trusted)
 {
     auto logger = LOGGER::logger();
     auto current_offset = stream->tellg();
     this->number_of_types = number_of_types;
     this->offset = types_offset;
    
-    dvmtype_t type;
+    DVMType *type;
     std::uint32_t type_id;
 
     logger->debug("started parsing types");
@@ -112,16 +180,30 @@ void Types::parse_types(
     // move to the offset for the analysis
     stream->seekg(types_offset, std::ios_base::beg);
 
+    ordered_types.reserve(number_of_types);
+    types_by_id.reserve(number_of_types);
+
     for (size_t I = 0; I < number_of_types; ++I)
     {
-        stream->read_data<std::uint32_t>(type_id, sizeof(std::uint32_t));
-
-        type = parse_type(strings->get_string_by_id(type_id));
-
-        ordered_types.push_back(std::move(type));
-        types_by_id[type_id] = ordered_types.back().get();
+        // a validated table is read without checks
+        if (trusted)
+            type_id = stream->read_unchecked<std::uint32_t>(types_offset + I * sizeof(std::uint32_t));
+        else
+            stream->read_data<std::uint32_t>(type_id, sizeof(std::uint32_t));
+
+        // the type keeps its own copy of the name, so avoid
+        // decoding the string in the strings table
+        type = parse_type(strings->get_string_view_by_id(type_id));
+
+        ordered_types.push_back(type);
+        types_by_id.emplace_back(type_id, type);
     }
 
+    // a correct DEX file has the types sorted by the string id,
+    // sort them only if the file does not follow the format
+    if (!std::is_sorted(types_by_id.begin(), types_by_id.end()))
+        std::sort(types_by_id.begin(), types_by_id.end());
+
     // return to your position
     stream->seekg(current_offset, std::ios_base::beg);
 
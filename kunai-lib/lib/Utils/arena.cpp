@@ -0,0 +1,92 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file arena.cpp
+#include "Kunai/Utils/arena.hpp"
+
+using namespace KUNAI::utils;
+
+thread_local Arena::thread_chunk_t Arena::thread_chunk;
+
+std::atomic<std::uint64_t> Arena::next_arena_id = 0;
+
+namespace
+{
+    /// @brief bytes needed to align an address
+    std::size_t get_padding(const std::byte *pointer, std::size_t alignment)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(pointer);
+        return (alignment - (address & (alignment - 1))) & (alignment - 1);
+    }
+} // namespace
+
+void *Arena::allocate_from_blocks(std::size_t size, std::size_t alignment)
+{
+    std::size_t padding = get_padding(current, alignment);
+
+    if (current == nullptr || padding + size > remaining)
+    {
+        // big objects take a block for themselves, so the
+        // current block can still be used
+        if (size + alignment > block_size)
+        {
+            blocks.push_back(std::unique_ptr<std::byte[]>(new std::byte[size + alignment]));
+            return blocks.back().get() + get_padding(blocks.back().get(), alignment);
+        }
+
+        blocks.push_back(std::unique_ptr<std::byte[]>(new std::byte[block_size]));
+        current = blocks.back().get();
+        remaining = block_size;
+
+        padding = get_padding(current, alignment);
+    }
+
+    std::byte *memory = current + padding;
+
+    current = memory + size;
+    remaining -= padding + size;
+
+    return memory;
+}
+
+void *Arena::allocate(std::size_t size, std::size_t alignment)
+{
+    auto &chunk = thread_chunk;
+
+    allocated_size.fetch_add(size, std::memory_order_relaxed);
+
+    if (chunk.arena_id == arena_id)
+    {
+        std::size_t padding = get_padding(chunk.current, alignment);
+
+        if (padding + size <= chunk.remaining)
+        {
+            std::byte *memory = chunk.current + padding;
+
+            chunk.current = memory + size;
+            chunk.remaining -= padding + size;
+
+            return memory;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(arena_mutex);
+
+    // the objects that do not fit in a chunk are taken from the blocks
+    if (size + alignment > chunk_size)
+        return allocate_from_blocks(size, alignment);
+
+    // the rest of the previous chunk is lost, the chunks are
+    // small so little memory is wasted
+    chunk.arena_id = arena_id;
+    chunk.current = static_cast<std::byte *>(allocate_from_blocks(chunk_size, alignof(std::max_align_t)));
+    chunk.remaining = chunk_size;
+
+    std::byte *memory = chunk.current + get_padding(chunk.current, alignment);
+
+    chunk.remaining -= (memory - chunk.current) + size;
+    chunk.current = memory + size;
+
+    return memory;
+}
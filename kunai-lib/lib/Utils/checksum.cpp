@@ -0,0 +1,278 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file checksum.cpp
+#include "Kunai/Utils/checksum.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define KUNAI_CHECKSUM_X86 1
+#endif
+
+using namespace KUNAI::utils;
+
+namespace
+{
+    /// @brief modulo of Adler-32
+    constexpr std::uint32_t adler_base = 65521;
+
+    /// @brief biggest number of bytes that can be added before
+    /// the sums overflow 32 bits
+    constexpr std::size_t adler_nmax = 5552;
+
+    using adler32_func = std::uint32_t (*)(std::uint32_t, const std::uint8_t *, std::size_t);
+
+    std::uint32_t adler32_scalar(std::uint32_t adler, const std::uint8_t *data, std::size_t size)
+    {
+        std::uint32_t s1 = adler & 0xffff;
+        std::uint32_t s2 = adler >> 16;
+
+        while (size > 0)
+        {
+            std::size_t block = std::min(size, adler_nmax);
+            size -= block;
+
+            for (; block >= 8; block -= 8, data += 8)
+            {
+                s1 += data[0];
+                s2 += s1;
+                s1 += data[1];
+                s2 += s1;
+                s1 += data[2];
+                s2 += s1;
+                s1 += data[3];
+                s2 += s1;
+                s1 += data[4];
+                s2 += s1;
+                s1 += data[5];
+                s2 += s1;
+                s1 += data[6];
+                s2 += s1;
+                s1 += data[7];
+                s2 += s1;
+            }
+
+            for (; block > 0; --block, ++data)
+            {
+                s1 += *data;
+                s2 += s1;
+            }
+
+            s1 %= adler_base;
+            s2 %= adler_base;
+        }
+
+        return (s2 << 16) | s1;
+    }
+
+#ifdef KUNAI_CHECKSUM_X86
+    __attribute__((target("avx2"))) std::uint32_t hsum_avx2(__m256i value)
+    {
+        alignas(32) std::uint32_t lanes[8];
+        std::uint32_t sum = 0;
+
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), value);
+
+        for (auto lane : lanes)
+            sum += lane;
+
+        return sum;
+    }
+
+    /// @brief version with AVX2, 32 bytes are added in each step:
+    /// s1 gets the sum of the bytes and s2 gets 32 times the previous
+    /// s1 plus the bytes multiplied by their weights (32..1)
+    __attribute__((target("avx2"))) std::uint32_t adler32_avx2(std::uint32_t adler, const std::uint8_t *data, std::size_t size)
+    {
+        std::uint32_t s1 = adler & 0xffff;
+        std::uint32_t s2 = adler >> 16;
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i ones = _mm256_set1_epi16(1);
+        const __m256i weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                                                 24, 23, 22, 21, 20, 19, 18, 17,
+                                                 16, 15, 14, 13, 12, 11, 10, 9,
+                                                 8, 7, 6, 5, 4, 3, 2, 1);
+
+        while (size >= sizeof(__m256i))
+        {
+            // the block is a multiple of 32 bytes, and it is not bigger
+            // than nmax so the sums do not overflow
+            std::size_t block = std::min(size, adler_nmax) & ~(sizeof(__m256i) - 1);
+            size -= block;
+
+            __m256i vs1 = _mm256_setr_epi32(static_cast<int>(s1), 0, 0, 0, 0, 0, 0, 0);
+            __m256i vs2 = _mm256_setr_epi32(static_cast<int>(s2), 0, 0, 0, 0, 0, 0, 0);
+            __m256i vs1_sums = zero;
+
+            for (; block > 0; block -= sizeof(__m256i), data += sizeof(__m256i))
+            {
+                __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+
+                vs1_sums = _mm256_add_epi32(vs1_sums, vs1);
+                vs1 = _mm256_add_epi32(vs1, _mm256_sad_epu8(bytes, zero));
+                vs2 = _mm256_add_epi32(vs2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+            }
+
+            vs2 = _mm256_add_epi32(vs2, _mm256_slli_epi32(vs1_sums, 5));
+
+            s1 = hsum_avx2(vs1) % adler_base;
+            s2 = hsum_avx2(vs2) % adler_base;
+        }
+
+        return adler32_scalar((s2 << 16) | s1, data, size);
+    }
+#endif
+
+    /// @brief choose the fastest implementation for the running CPU
+    adler32_func select_adler32()
+    {
+#ifdef KUNAI_CHECKSUM_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return adler32_avx2;
+#endif
+        return adler32_scalar;
+    }
+
+    inline std::uint32_t rotl(std::uint32_t value, unsigned bits)
+    {
+        return (value << bits) | (value >> (32 - bits));
+    }
+} // namespace
+
+std::uint32_t KUNAI::utils::adler32(std::span<const std::uint8_t> data, std::uint32_t adler)
+{
+    static const adler32_func implementation = select_adler32();
+
+    return implementation(adler, data.data(), data.size());
+}
+
+Sha1::Sha1()
+{
+    state[0] = 0x67452301;
+    state[1] = 0xEFCDAB89;
+    state[2] = 0x98BADCFE;
+    state[3] = 0x10325476;
+    state[4] = 0xC3D2E1F0;
+}
+
+void Sha1::process_block(const std::uint8_t *data)
+{
+    std::uint32_t w[80];
+
+    for (size_t I = 0; I < 16; ++I)
+        w[I] = (static_cast<std::uint32_t>(data[I * 4]) << 24) |
+               (static_cast<std::uint32_t>(data[I * 4 + 1]) << 16) |
+               (static_cast<std::uint32_t>(data[I * 4 + 2]) << 8) |
+               static_cast<std::uint32_t>(data[I * 4 + 3]);
+
+    for (size_t I = 16; I < 80; ++I)
+        w[I] = rotl(w[I - 3] ^ w[I - 8] ^ w[I - 14] ^ w[I - 16], 1);
+
+    std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+    for (size_t I = 0; I < 80; ++I)
+    {
+        std::uint32_t f, k;
+
+        if (I < 20)
+        {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        }
+        else if (I < 40)
+        {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        }
+        else if (I < 60)
+        {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        }
+        else
+        {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+
+        std::uint32_t temp = rotl(a, 5) + f + e + k + w[I];
+        e = d;
+        d = c;
+        c = rotl(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+void Sha1::update(std::span<const std::uint8_t> data)
+{
+    const std::uint8_t *input = data.data();
+    std::size_t size = data.size();
+
+    total_size += size;
+
+    // complete the pending block
+    if (block_size > 0)
+    {
+        std::size_t needed = std::min(size, sizeof(block) - block_size);
+        std::memcpy(block + block_size, input, needed);
+        block_size += needed;
+        input += needed;
+        size -= needed;
+
+        if (block_size < sizeof(block))
+            return;
+
+        process_block(block);
+        block_size = 0;
+    }
+
+    // the complete blocks are processed from the input
+    for (; size >= sizeof(block); size -= sizeof(block), input += sizeof(block))
+        process_block(input);
+
+    if (size > 0)
+    {
+        std::memcpy(block, input, size);
+        block_size = size;
+    }
+}
+
+Sha1::digest_t Sha1::finish()
+{
+    std::uint64_t const total_bits = total_size * 8;
+    std::uint8_t padding[72] = {0x80};
+    // pad until 56 bytes of the last block, then the size
+    std::size_t const padding_size = (block_size < 56) ? (56 - block_size) : (120 - block_size);
+    std::uint8_t size_bytes[8];
+
+    for (size_t I = 0; I < 8; ++I)
+        size_bytes[I] = static_cast<std::uint8_t>(total_bits >> (56 - I * 8));
+
+    update({padding, padding_size});
+    update({size_bytes, sizeof(size_bytes)});
+
+    digest_t digest;
+
+    for (size_t I = 0; I < 5; ++I)
+    {
+        digest[I * 4] = static_cast<std::uint8_t>(state[I] >> 24);
+        digest[I * 4 + 1] = static_cast<std::uint8_t>(state[I] >> 16);
+        digest[I * 4 + 2] = static_cast<std::uint8_t>(state[I] >> 8);
+        digest[I * 4 + 3] = static_cast<std::uint8_t>(state[I]);
+    }
+
+    return digest;
+}
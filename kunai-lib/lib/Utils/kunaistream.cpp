@@ -4,21 +4,24 @@
 //
 // @file kunaistream.cpp
 #include "Kunai/Utils/kunaistream.hpp"
+#include "Kunai/Utils/mutf8.hpp"
+
+#include <vector>
 
 using namespace KUNAI::stream;
 
 void KunaiStream::initialize()
 {
     // save previous pointer
-    auto curr_pointer = input_file.tellg();
+    auto curr_pointer = input_file->tellg();
 
     // obtain the size
-    input_file.seekg(0, std::ios::beg);
-    auto fsize = input_file.tellg();
-    input_file.seekg(0, std::ios::end);
-    fsize = input_file.tellg() - fsize;
+    input_file->seekg(0, std::ios::beg);
+    auto fsize = input_file->tellg();
+    input_file->seekg(0, std::ios::end);
+    fsize = input_file->tellg() - fsize;
     // return to current pointer
-    input_file.seekg(curr_pointer, std::ios::beg);
+    input_file->seekg(curr_pointer, std::ios::beg);
 
     file_size = static_cast<std::size_t>(fsize);
 }
@@ -28,22 +31,40 @@ std::string KunaiStream::read_ansii_string(std::int64_t offset)
     std::string new_str;
     std::int8_t character = -1;
     auto int8_s = sizeof(std::int8_t);
+    std::int32_t count = 0;
+
+    if (input_file == nullptr)
+    {
+        auto pos = static_cast<std::size_t>(offset);
+
+        while (character != 0 && count < MAX_ANSII_STR_SIZE && pos < file_size)
+        {
+            character = static_cast<std::int8_t>(buffer[pos++]);
+            new_str += static_cast<char>(character);
+            count++;
+        }
+
+        if (count == MAX_ANSII_STR_SIZE)
+            return "";
+
+        return new_str;
+    }
+
     // as always save the current offset
-    auto curr_offset = input_file.tellg();
+    auto curr_offset = input_file->tellg();
 
     // set the offset
-    input_file.seekg(static_cast<std::streampos>(offset));
-    std::int32_t count = 0;
+    input_file->seekg(static_cast<std::streampos>(offset));
 
     while (character != 0 && count < MAX_ANSII_STR_SIZE)
     {
-        input_file.read(reinterpret_cast<char *>(&character), int8_s);
+        input_file->read(reinterpret_cast<char *>(&character), int8_s);
         new_str += static_cast<char>(character);
         count++;
     }
 
     // return again
-    input_file.seekg(curr_offset);
+    input_file->seekg(curr_offset);
 
     if (count == MAX_ANSII_STR_SIZE)
         return "";
@@ -54,25 +75,73 @@ std::string KunaiStream::read_ansii_string(std::int64_t offset)
 std::string KunaiStream::read_dex_string(std::int64_t offset)
 {
     std::string new_str;
-    std::int8_t character = -1;
     std::uint64_t utf16_size;
-    auto int8_s = sizeof(std::int8_t);
+    std::int64_t read_size;
+
+    if (input_file == nullptr)
+    {
+        auto curr_offset = cursor;
+
+        // the position of the caller is kept also when the
+        // string is truncated and the size cannot be read
+        try
+        {
+            cursor = static_cast<std::size_t>(offset);
+            utf16_size = read_uleb128();
+
+            // decode directly from the buffer
+            read_size = mutf8::decode_to_utf8(buffer.subspan(cursor), utf16_size, new_str);
+        }
+        catch (...)
+        {
+            cursor = curr_offset;
+            throw;
+        }
+
+        cursor = curr_offset;
+
+        if (read_size < 0)
+            throw exceptions::StreamException("read_dex_string(): incorrect MUTF-8 string");
+
+        return new_str;
+    }
+
+    std::vector<std::uint8_t> string_data;
+    std::uint8_t character;
+
     // save current offset
-    auto curr_offset = input_file.tellg();
+    auto curr_offset = input_file->tellg();
 
-    // set the offset to the given offset
-    input_file.seekg(static_cast<std::streampos>(offset));
+    try
+    {
+        // set the offset to the given offset
+        input_file->seekg(static_cast<std::streampos>(offset));
 
-    utf16_size = read_uleb128();
+        utf16_size = read_uleb128();
 
-    while (utf16_size-- > 0)
+        // read the whole string with its terminator
+        do
+        {
+            read_data<std::uint8_t>(character, sizeof(std::uint8_t));
+            string_data.push_back(character);
+        } while (character != 0);
+    }
+    catch (...)
     {
-        input_file.read(reinterpret_cast<char *>(&character), int8_s);
-        new_str += static_cast<char>(character);
+        // a failed read leaves the file in error state
+        input_file->clear();
+        input_file->seekg(curr_offset);
+        throw;
     }
 
     // return again
-    input_file.seekg(curr_offset);
+    input_file->seekg(curr_offset);
+
+    read_size = mutf8::decode_to_utf8(string_data, utf16_size, new_str);
+
+    if (read_size < 0)
+        throw exceptions::StreamException("read_dex_string(): incorrect MUTF-8 string");
+
     return new_str;
 }
 
@@ -82,6 +151,21 @@ std::uint64_t KunaiStream::read_uleb128()
     unsigned shift = 0;
     std::int8_t byte_read;
 
+    // decode directly from the buffer in memory
+    if (input_file == nullptr)
+    {
+        do
+        {
+            if (cursor >= file_size)
+                throw exceptions::StreamException("read_uleb128(): error reading input file");
+            byte_read = static_cast<std::int8_t>(buffer[cursor++]);
+            value |= static_cast<std::uint64_t>(byte_read & 0x7f) << shift;
+            shift += 7;
+        } while (byte_read & 0x80);
+
+        return value;
+    }
+
     do
     {
         read_data<std::int8_t>(byte_read, sizeof(std::int8_t));
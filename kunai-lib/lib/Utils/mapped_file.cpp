@@ -0,0 +1,81 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file mapped_file.cpp
+#include "Kunai/Utils/mapped_file.hpp"
+#include "Kunai/Exceptions/stream_exception.hpp"
+
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define KUNAI_HAS_MMAP 1
+#endif
+
+using namespace KUNAI::stream;
+
+MappedFile::MappedFile(const std::string &file_path)
+{
+#ifdef KUNAI_HAS_MMAP
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        throw exceptions::StreamException("MappedFile: error opening file " + file_path);
+
+    struct stat file_stat;
+
+    if (::fstat(fd, &file_stat) < 0)
+    {
+        ::close(fd);
+        throw exceptions::StreamException("MappedFile: error obtaining size of file " + file_path);
+    }
+
+    mapped_size = static_cast<std::size_t>(file_stat.st_size);
+
+    // mmap does not accept an empty mapping, an empty
+    // file is represented by an empty span
+    if (mapped_size != 0)
+    {
+        auto address = ::mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (address == MAP_FAILED)
+        {
+            ::close(fd);
+            throw exceptions::StreamException("MappedFile: error mapping file " + file_path);
+        }
+
+        mapped_address = address;
+        // the parser jumps through the tables of the whole
+        // file, so ask the kernel to bring all the pages
+        ::madvise(mapped_address, mapped_size, MADV_WILLNEED);
+    }
+
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+#else
+    std::ifstream input_file(file_path, std::ifstream::binary | std::ifstream::ate);
+
+    if (!input_file.is_open())
+        throw exceptions::StreamException("MappedFile: error opening file " + file_path);
+
+    mapped_size = static_cast<std::size_t>(input_file.tellg());
+    fallback_buffer.resize(mapped_size);
+    input_file.seekg(0, std::ios::beg);
+    input_file.read(reinterpret_cast<char *>(fallback_buffer.data()), mapped_size);
+
+    if (!input_file)
+        throw exceptions::StreamException("MappedFile: error reading file " + file_path);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef KUNAI_HAS_MMAP
+    if (mapped_address != nullptr)
+        ::munmap(mapped_address, mapped_size);
+#endif
+}
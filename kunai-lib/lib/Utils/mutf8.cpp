@@ -0,0 +1,276 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+//
+// @file mutf8.cpp
+#include "Kunai/Utils/mutf8.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define KUNAI_MUTF8_X86 1
+#endif
+
+using namespace KUNAI::stream;
+
+namespace
+{
+    using ascii_length_func = std::size_t (*)(const std::uint8_t *, std::size_t);
+
+    /// @brief scalar version, checks eight bytes at a time looking
+    /// for a 0 byte or a byte with the high bit set
+    std::size_t ascii_length_scalar(const std::uint8_t *data, std::size_t size)
+    {
+        const std::uint64_t ones = 0x0101010101010101ULL;
+        const std::uint64_t highs = 0x8080808080808080ULL;
+        std::size_t i = 0;
+
+        for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data + i, sizeof(std::uint64_t));
+            // a zero byte or a non-ascii byte in the word
+            if ((word & highs) || ((word - ones) & ~word & highs))
+                break;
+        }
+
+        for (; i < size; ++i)
+            if (data[i] == 0 || (data[i] & 0x80))
+                break;
+
+        return i;
+    }
+
+#ifdef KUNAI_MUTF8_X86
+    __attribute__((target("sse2"))) std::size_t ascii_length_sse2(const std::uint8_t *data, std::size_t size)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        std::size_t i = 0;
+
+        for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i))
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            int mask = _mm_movemask_epi8(chunk) | _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero));
+
+            if (mask != 0)
+                return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+
+        return i + ascii_length_scalar(data + i, size - i);
+    }
+
+    __attribute__((target("avx2"))) std::size_t ascii_length_avx2(const std::uint8_t *data, std::size_t size)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        std::size_t i = 0;
+
+        for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i))
+        {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(chunk)) |
+                            static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, zero)));
+
+            if (mask != 0)
+                return i + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+
+        return i + ascii_length_sse2(data + i, size - i);
+    }
+#endif
+
+    /// @brief choose the fastest implementation for the running CPU
+    ascii_length_func select_ascii_length()
+    {
+#ifdef KUNAI_MUTF8_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return ascii_length_avx2;
+        if (__builtin_cpu_supports("sse2"))
+            return ascii_length_sse2;
+#endif
+        return ascii_length_scalar;
+    }
+
+    /// @brief write the decoded code units as UTF-8, joining
+    /// the surrogate pairs
+    struct utf8_sink
+    {
+        std::string &output;
+        std::uint16_t pending_high = 0;
+
+        void flush()
+        {
+            if (pending_high == 0)
+                return;
+            // unpaired surrogate, keep its three bytes encoding
+            output += static_cast<char>(0xE0 | (pending_high >> 12));
+            output += static_cast<char>(0x80 | ((pending_high >> 6) & 0x3F));
+            output += static_cast<char>(0x80 | (pending_high & 0x3F));
+            pending_high = 0;
+        }
+
+        void ascii(const std::uint8_t *data, std::size_t size)
+        {
+            flush();
+            output.append(reinterpret_cast<const char *>(data), size);
+        }
+
+        void unit(std::uint16_t code_unit)
+        {
+            if (pending_high != 0 && code_unit >= 0xDC00 && code_unit <= 0xDFFF)
+            {
+                std::uint32_t code_point = 0x10000 + ((static_cast<std::uint32_t>(pending_high) - 0xD800) << 10) + (code_unit - 0xDC00);
+                output += static_cast<char>(0xF0 | (code_point >> 18));
+                output += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+                output += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                output += static_cast<char>(0x80 | (code_point & 0x3F));
+                pending_high = 0;
+                return;
+            }
+
+            flush();
+
+            if (code_unit >= 0xD800 && code_unit <= 0xDBFF)
+                pending_high = code_unit;
+            else if (code_unit < 0x80)
+                output += static_cast<char>(code_unit);
+            else if (code_unit < 0x800)
+            {
+                output += static_cast<char>(0xC0 | (code_unit >> 6));
+                output += static_cast<char>(0x80 | (code_unit & 0x3F));
+            }
+            else
+            {
+                output += static_cast<char>(0xE0 | (code_unit >> 12));
+                output += static_cast<char>(0x80 | ((code_unit >> 6) & 0x3F));
+                output += static_cast<char>(0x80 | (code_unit & 0x3F));
+            }
+        }
+    };
+
+    /// @brief write the decoded code units as UTF-16
+    struct utf16_sink
+    {
+        std::u16string &output;
+
+        void flush()
+        {
+        }
+
+        void ascii(const std::uint8_t *data, std::size_t size)
+        {
+            output.append(data, data + size);
+        }
+
+        void unit(std::uint16_t code_unit)
+        {
+            output += static_cast<char16_t>(code_unit);
+        }
+    };
+
+    /// @brief Decode and validate a MUTF-8 string, the ASCII runs
+    /// are given to the sink at once.
+    template <typename Sink>
+    std::int64_t decode(std::span<const std::uint8_t> input, std::uint64_t utf16_size, Sink &sink)
+    {
+        const std::uint8_t *data = input.data();
+        std::size_t size = input.size();
+        std::size_t pos = 0;
+        std::uint64_t code_units = 0;
+
+        while (true)
+        {
+            auto run = mutf8::ascii_length(data + pos, size - pos);
+
+            if (run != 0)
+            {
+                sink.ascii(data + pos, run);
+                pos += run;
+                code_units += run;
+            }
+
+            // string not finished in a 0 byte
+            if (pos >= size)
+                return -1;
+
+            std::uint8_t byte = data[pos];
+
+            if (byte == 0)
+                break;
+
+            if ((byte & 0xE0) == 0xC0)
+            {
+                if (pos + 1 >= size || (data[pos + 1] & 0xC0) != 0x80)
+                    return -1;
+
+                std::uint16_t code_unit = static_cast<std::uint16_t>(((byte & 0x1F) << 6) | (data[pos + 1] & 0x3F));
+
+                // overlong encoding, only allowed for the null character
+                if (code_unit != 0 && code_unit < 0x80)
+                    return -1;
+
+                sink.unit(code_unit);
+                pos += 2;
+            }
+            else if ((byte & 0xF0) == 0xE0)
+            {
+                if (pos + 2 >= size || (data[pos + 1] & 0xC0) != 0x80 || (data[pos + 2] & 0xC0) != 0x80)
+                    return -1;
+
+                std::uint16_t code_unit = static_cast<std::uint16_t>(((byte & 0x0F) << 12) | ((data[pos + 1] & 0x3F) << 6) | (data[pos + 2] & 0x3F));
+
+                if (code_unit < 0x800)
+                    return -1;
+
+                sink.unit(code_unit);
+                pos += 3;
+            }
+            else
+                // continuation byte or four bytes sequence
+                return -1;
+
+            code_units++;
+        }
+
+        sink.flush();
+
+        if (code_units != utf16_size)
+            return -1;
+
+        return static_cast<std::int64_t>(pos);
+    }
+} // namespace
+
+std::size_t mutf8::ascii_length(const std::uint8_t *data, std::size_t size)
+{
+    static const ascii_length_func implementation = select_ascii_length();
+
+    return implementation(data, size);
+}
+
+std::int64_t mutf8::decode_to_utf8(std::span<const std::uint8_t> input,
+                                   std::uint64_t utf16_size,
+                                   std::string &output)
+{
+    utf8_sink sink{output};
+
+    output.clear();
+    // the size comes from the file, do not trust it for the allocation
+    output.reserve(std::min<std::uint64_t>(utf16_size, input.size()));
+
+    return decode(input, utf16_size, sink);
+}
+
+std::int64_t mutf8::decode_to_utf16(std::span<const std::uint8_t> input,
+                                    std::uint64_t utf16_size,
+                                    std::u16string &output)
+{
+    utf16_sink sink{output};
+
+    output.clear();
+    output.reserve(std::min<std::uint64_t>(utf16_size, input.size()));
+
+    return decode(input, utf16_size, sink);
+}
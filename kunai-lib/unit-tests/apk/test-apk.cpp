@@ -0,0 +1,77 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+// @file test-apk.cpp
+// @brief Unit test script for the analysis of APK files with more than
+// one DEX file.
+
+#include "test-apk.inc"
+#include "Kunai/APK/apk.hpp"
+#include "Kunai/Utils/logger.hpp"
+#include <assert.h>
+
+int main()
+{
+    // classes.dex defines PCodeVM and classes2.dex defines VClass, that uses PCodeVM
+    std::string apk_file_path = std::string(KUNAI_TEST_FOLDER) + "/test-apk/multidex.apk";
+
+    auto logger = KUNAI::LOGGER::logger();
+
+    logger->set_level(spdlog::level::debug);
+
+    auto apk = KUNAI::APK::Apk::parse_apk_file(apk_file_path);
+
+    auto &dex_files = apk->get_dex_files();
+
+    assert(dex_files.size() == 2 && "Number of DEX files incorrect");
+
+    for (auto &dex_file : dex_files)
+        assert(dex_file.second->get_parsing_correct() && "DEX file from the APK not parsed");
+
+    auto analysis = apk->get_analysis(true);
+
+    if (analysis == nullptr)
+        return -1;
+
+    analysis->create_xrefs();
+
+    std::string vclass_name = "LVClass;";
+    std::string pcodevm_name = "LPCodeVM;";
+
+    auto vclass = analysis->get_class_analysis(vclass_name);
+    auto pcodevm = analysis->get_class_analysis(pcodevm_name);
+
+    assert(vclass != nullptr && !vclass->is_class_external() &&
+           pcodevm != nullptr && !pcodevm->is_class_external() &&
+           "Classes of the DEX files not in the analysis");
+
+    // the calls from classes2.dex must point to the methods of classes.dex
+    size_t cross_dex_xrefs = 0;
+
+    for (auto &method : vclass->get_methods())
+    {
+        for (auto &xref_to : method.second->get_xrefto())
+        {
+            if (std::get<0>(xref_to) != pcodevm)
+                continue;
+
+            assert(!std::get<1>(xref_to)->external() && "Method of other DEX file is external");
+
+            cross_dex_xrefs++;
+        }
+    }
+
+    assert(cross_dex_xrefs > 0 && "No xrefs between the DEX files");
+
+    // a DEX file over the size limit is not inflated
+    KUNAI::DEX::parser_options_t limited_options;
+    limited_options.limits.max_dex_size = 4096;
+
+    auto limited_apk = KUNAI::APK::Apk::parse_apk_file(apk_file_path, limited_options);
+
+    assert(limited_apk->get_dex_files().size() == 1 &&
+           limited_apk->get_dex_by_name("classes2.dex") != nullptr &&
+           "DEX file over the size limit inflated");
+
+    return 0;
+}
@@ -6,9 +6,11 @@
 
 #include <iostream>
 #include <assert.h>
+#include <thread>
 #include <vector>
 
 #include "Kunai/DEX/dex.hpp"
+#include "Kunai/DEX/parser/dex_visitor.hpp"
 #include "Kunai/Utils/logger.hpp"
 #include "test-disassembler.inc"
 
@@ -37,6 +39,45 @@ std::vector<std::string> expected_result = {
     "return-void"
 };
 
+/// @brief visitor that counts the instructions of each method
+class InstructionCounter : public KUNAI::DEX::DexVisitor
+{
+public:
+    std::unordered_map<std::uint32_t, std::size_t> instructions;
+
+    void visit_instruction(const KUNAI::DEX::visited_instruction_t &instruction) override
+    {
+        instructions[instruction.method_idx]++;
+    }
+};
+
+/// @brief visitor that keeps the ids of the methods, resolving
+/// a string and a type with the walker in each method
+class MethodResolver : public KUNAI::DEX::DexVisitor
+{
+    KUNAI::DEX::DexWalker *walker;
+
+public:
+    std::vector<std::uint32_t> methods;
+    std::vector<std::string> strings;
+    std::vector<std::string> types;
+
+    MethodResolver(KUNAI::DEX::DexWalker *walker = nullptr) : walker(walker)
+    {
+    }
+
+    void visit_method(const KUNAI::DEX::visited_method_t &method) override
+    {
+        methods.push_back(method.method_idx);
+
+        if (walker == nullptr)
+            return;
+
+        strings.push_back(walker->read_string(0));
+        types.push_back(walker->read_type(0));
+    }
+};
+
 int main()
 {
     std::string dex_file_path = std::string(KUNAI_TEST_FOLDER) + "/test-disassembler/classes.dex";
@@ -84,6 +125,176 @@ int main()
         }
     }
 
+    // the parallel disassembly must find the same instructions
+    KUNAI::DEX::DexDisassembler parallel_disassembler(dex->get_parser());
+
+    parallel_disassembler.disassembly_dex_parallel(2);
+
+    assert(parallel_disassembler.correct_disassembly() &&
+           parallel_disassembler.get_dex_instructions().size() == methods_instrs.size() &&
+           "Parallel disassembly mismatch with the disassembler");
+
+    for (auto &method_instrs : parallel_disassembler.get_dex_instructions())
+    {
+        auto &instrs = methods_instrs.at(method_instrs.first);
+
+        assert(instrs.size() == method_instrs.second.size() &&
+               "Parallel instructions size mismatch with the disassembler");
+
+        for (size_t I = 0, E = instrs.size(); I < E; ++I)
+        {
+            assert(instrs[I]->print_instruction() == method_instrs.second[I]->print_instruction() &&
+                   "Parallel instruction mismatch with the disassembler");
+        }
+    }
+
+    // the methods disassembled on demand must be the same, and
+    // they must be disassembled only once
+    KUNAI::DEX::DexDisassembler lazy_disassembler(dex->get_parser());
+
+    for (auto &method_instrs : methods_instrs)
+    {
+        auto &instrs = lazy_disassembler.disassemble_method(method_instrs.first);
+
+        assert(lazy_disassembler.correct_disassembly(method_instrs.first) &&
+               &instrs == &lazy_disassembler.disassemble_method(method_instrs.first) &&
+               "On demand disassembly not cached");
+
+        assert(instrs.size() == method_instrs.second.size() &&
+               "On demand instructions size mismatch with the disassembler");
+
+        for (size_t I = 0, E = instrs.size(); I < E; ++I)
+        {
+            assert(instrs[I]->print_instruction() == method_instrs.second[I]->print_instruction() &&
+                   "On demand instruction mismatch with the disassembler");
+        }
+    }
+
+    // the instructions added to another disassembler are decoded again,
+    // the instructions given by the original one are not modified
+    KUNAI::DEX::DexDisassembler merged_disassembler(dex->get_parser());
+    std::vector<std::pair<KUNAI::DEX::EncodedMethod *, std::vector<std::unique_ptr<KUNAI::DEX::Instruction>> *>> given;
+
+    for (auto &method_instrs : methods_instrs)
+        given.push_back({method_instrs.first, &lazy_disassembler.disassemble_method(method_instrs.first)});
+
+    merged_disassembler += lazy_disassembler;
+    merged_disassembler += lazy_disassembler;
+
+    assert(lazy_disassembler.get_dex_instructions().size() == methods_instrs.size() &&
+           merged_disassembler.get_dex_instructions().size() == methods_instrs.size() &&
+           "Instructions not added to the merged disassembler");
+
+    for (auto [method, instrs] : given)
+    {
+        assert(&lazy_disassembler.disassemble_method(method) == instrs &&
+               instrs->size() == methods_instrs.at(method).size() &&
+               merged_disassembler.disassemble_method(method).size() == instrs->size() &&
+               "Merged instructions mismatch with the disassembler");
+    }
+
+    // the methods are disassembled on demand from different threads,
+    // and all of them get the same instructions
+    KUNAI::DEX::DexDisassembler concurrent_disassembler(dex->get_parser());
+    std::vector<std::vector<std::unique_ptr<KUNAI::DEX::Instruction>> *> first_thread, second_thread;
+
+    auto disassemble_all = [&](auto &results)
+    {
+        for (auto &method_instrs : methods_instrs)
+            results.push_back(&concurrent_disassembler.disassemble_method(method_instrs.first));
+    };
+
+    std::thread first([&]()
+                      { disassemble_all(first_thread); });
+    std::thread second([&]()
+                       { disassemble_all(second_thread); });
+
+    first.join();
+    second.join();
+
+    assert(first_thread == second_thread &&
+           concurrent_disassembler.get_dex_instructions().size() == methods_instrs.size() &&
+           "Concurrent disassembly returned different instructions");
+
+    // the streaming walker must find the same instructions
+    std::ifstream walker_file(dex_file_path, std::ifstream::binary);
+    KUNAI::stream::KunaiStream walker_stream(walker_file);
+    KUNAI::DEX::DexWalker walker(&walker_stream);
+    InstructionCounter counter;
+
+    walker.walk(counter);
+
+    auto &parsed_methods = dex->get_parser()->get_methods();
+
+    for (auto &method_instrs : methods_instrs)
+    {
+        auto method_id = method_instrs.first->getMethodID();
+        std::uint32_t method_idx = 0;
+
+        while (parsed_methods.get_method(method_idx) != method_id)
+            method_idx++;
+
+        assert(counter.instructions[method_idx] == method_instrs.second.size() &&
+               "Walker instructions mismatch with the disassembler");
+    }
+
+    // resolving ids from the visitor must not move the walk
+    walker_stream.seekg(0, std::ios_base::beg);
+    MethodResolver plain_visitor;
+    walker.walk(plain_visitor);
+
+    walker_stream.seekg(0, std::ios_base::beg);
+    MethodResolver resolver(&walker);
+    walker.walk(resolver);
+
+    assert(!plain_visitor.methods.empty() && plain_visitor.methods == resolver.methods &&
+           "Walker methods mismatch when ids are resolved");
+
+    for (size_t I = 0, E = resolver.strings.size(); I < E; ++I)
+    {
+        assert(resolver.strings[I] == dex->get_parser()->get_strings().get_string_by_id(0) &&
+               resolver.types[I] == dex->get_parser()->get_types().get_type_from_order(0)->get_raw() &&
+               "Walker ids not resolved correctly");
+    }
+
+    // the flat representation must decode the same instructions
+    disassembler->disassembly_flat_dex();
+
+    for (auto &method_instrs : methods_instrs)
+    {
+        auto flat = disassembler->get_flat_instructions(method_instrs.first);
+
+        assert(flat != nullptr && flat->size() == method_instrs.second.size() &&
+               "Flat instructions size mismatch with the disassembler");
+
+        for (size_t I = 0, E = flat->size(); I < E; ++I)
+        {
+            const auto &record = flat->get_instructions()[I];
+            const auto &instr = method_instrs.second[I];
+
+            assert(record.address == instr->get_address() &&
+                   record.length == instr->get_instruction_length() &&
+                   record.opcode == instr->get_instruction_opcode() &&
+                   "Flat instruction mismatch with the disassembler");
+        }
+    }
+
+    KUNAI::DEX::FlatInstructions flat_buffer;
+
+    flat_buffer.disassembly(raw_buffer);
+
+    assert(flat_buffer.size() == expected_result.size() && "Flat instructions size mismatch with expected result");
+
+    // const/4 v0, 1
+    auto &const4 = flat_buffer.get_instructions()[0];
+    assert(const4.format == KUNAI::DEX::dexinsttype_t::DEX_INSTRUCTION11N &&
+           const4.registers[0] == 0 && const4.literal == 1 && "Incorrect flat const/4");
+
+    // invoke-static {v1, v0, v2, v3}, void Main->test(java.lang.String,int,double)
+    auto invoke = flat_buffer.get_instruction_by_address(42);
+    assert(invoke != nullptr && invoke->number_of_registers == 4 &&
+           invoke->registers[0] == 1 && invoke->registers[3] == 3 && "Incorrect flat invoke-static");
+
     auto disassembled_instructions = disassembler->disassembly_buffer(raw_buffer);
 
     for (size_t I = 0, E = disassembled_instructions.size(); I < E; ++I)
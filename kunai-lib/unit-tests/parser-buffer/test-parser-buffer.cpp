@@ -0,0 +1,345 @@
+//--------------------------------------------------------------------*- C++ -*-
+// Kunai-static-analyzer: library for doing analysis of dalvik files
+// @author Farenain <kunai.static.analysis@gmail.com>
+// @file test-parser-buffer.cpp
+// @brief Unit test script for parsing DEX files from memory buffers.
+
+#include "test-parser-buffer.inc"
+#include "Kunai/DEX/dex.hpp"
+#include "Kunai/Utils/logger.hpp"
+#include <assert.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+void check_parser(KUNAI::DEX::Parser *parser)
+{
+    auto &header_struct = parser->get_header_const().get_dex_header_const();
+
+    assert(
+        header_struct.checksum == 0x8df011a &&
+        "dex checksum not correct");
+
+    assert(
+        header_struct.file_size == 1876 &&
+        "dex file size not correct");
+
+    assert(
+        parser->get_strings_const().get_number_of_strings() == 41 &&
+        "dex number of strings not correct");
+
+    assert(
+        parser->get_classes().get_number_of_classes() == 1 &&
+        "dex number of classes not correct");
+}
+
+void check_encoded_values()
+{
+    // encoded_array with an int, a char, a float, a string and a boolean
+    const std::uint8_t encoded_array[] = {
+        0x05,
+        0x04, 0xfe,
+        0x23, 0xff, 0xff,
+        0x30, 0x80, 0x3f,
+        0x37, 0x2c, 0x01,
+        0x3f};
+
+    KUNAI::stream::KunaiStream stream(std::span<const std::uint8_t>{encoded_array});
+    KUNAI::DEX::EncodedArray array;
+
+    array.parse_encoded_array(&stream, nullptr, nullptr, nullptr);
+
+    auto &values = array.get_values();
+
+    assert(
+        values.size() == 5 &&
+        values[0].as_int() == -2 &&
+        values[1].as_int() == 0xffff &&
+        values[2].as_float() == 1.0f &&
+        values[3].as_string_id() == 300 &&
+        values[4].as_boolean() &&
+        "encoded values not correct");
+}
+
+void check_truncated_string()
+{
+    // a string whose size does not end before the end of the buffer
+    const std::uint8_t truncated_string[] = {0x00, 0x80, 0x80};
+
+    KUNAI::stream::KunaiStream stream(std::span<const std::uint8_t>{truncated_string});
+    bool thrown = false;
+
+    stream.seekg(1, std::ios_base::beg);
+
+    try
+    {
+        stream.read_dex_string(1);
+    }
+    catch (const std::exception &)
+    {
+        thrown = true;
+    }
+
+    assert(
+        thrown && stream.tellg() == 1 &&
+        "position of the stream not kept with a truncated string");
+}
+
+int main()
+{
+    std::string dex_file_path = std::string(KUNAI_TEST_FOLDER) + "/test-assignment-arith-logic/Main.dex";
+
+    auto logger = KUNAI::LOGGER::logger();
+
+    logger->set_level(spdlog::level::debug);
+
+    std::ifstream dex_file(dex_file_path, std::ifstream::binary);
+
+    std::vector<std::uint8_t> dex_bytes(
+        (std::istreambuf_iterator<char>(dex_file)),
+        std::istreambuf_iterator<char>());
+
+    // non-owning buffer
+    auto dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{dex_bytes});
+
+    if (!dex->get_parsing_correct())
+        return -1;
+
+    check_parser(dex->get_parser());
+
+    check_encoded_values();
+
+    check_truncated_string();
+
+    // the tables of the file are correct, so they are read without checks
+    if (!dex->get_parser()->get_tables_validated())
+        return -1;
+
+    KUNAI::DEX::parser_options_t checked_options;
+    checked_options.trusted_fast_path = false;
+
+    auto checked_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{dex_bytes}, checked_options);
+
+    if (!checked_dex->get_parsing_correct() || checked_dex->get_parser()->get_tables_validated())
+        return -1;
+
+    check_parser(checked_dex->get_parser());
+
+    auto analysis = dex->get_analysis(false);
+
+    if (analysis == nullptr)
+        return -1;
+
+    // tables parsed by a pool of threads
+    KUNAI::DEX::parser_options_t parallel_options;
+    parallel_options.parallel_parsing = true;
+    parallel_options.number_of_threads = 2;
+
+    auto parallel_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{dex_bytes}, parallel_options);
+
+    if (!parallel_dex->get_parsing_correct())
+        return -1;
+
+    check_parser(parallel_dex->get_parser());
+
+    // parse levels for triage
+    KUNAI::DEX::parser_options_t strings_options;
+    strings_options.parse_level = KUNAI::DEX::parse_level_e::STRINGS;
+
+    auto strings_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{dex_bytes}, strings_options);
+
+    if (!strings_dex->get_parsing_correct() || strings_dex->get_dex_disassembler() != nullptr)
+        return -1;
+
+    assert(
+        strings_dex->get_parser()->get_strings().get_number_of_strings() == 41 &&
+        strings_dex->get_parser()->get_types().get_number_of_types() == 0 &&
+        strings_dex->get_parser()->get_classes().get_number_of_classes() == 0 &&
+        "strings parse level not correct");
+
+    KUNAI::DEX::parser_options_t class_defs_options;
+    class_defs_options.parse_level = KUNAI::DEX::parse_level_e::CLASS_DEFS;
+
+    auto class_defs_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{dex_bytes}, class_defs_options);
+
+    if (!class_defs_dex->get_parsing_correct())
+        return -1;
+
+    check_parser(class_defs_dex->get_parser());
+
+    assert(
+        class_defs_dex->get_parser()->get_classes().get_classdef_by_name("LMain;") != nullptr &&
+        "class defs parse level not correct");
+
+    // the data of the classes is still available on demand
+    if (class_defs_dex->get_analysis(false) == nullptr)
+        return -1;
+
+    // checksum of the header
+    KUNAI::DEX::parser_options_t verify_options;
+    verify_options.verify_checksum = true;
+
+    auto verified_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{dex_bytes}, verify_options);
+
+    if (!verified_dex->get_parsing_correct())
+        return -1;
+
+    // the signature stored in this test file is not updated,
+    // so check the computed one with the expected SHA-1
+    const std::uint8_t expected_signature[] = {
+        0x63, 0x2a, 0xc2, 0xba, 0xd6, 0xd5, 0xe1, 0xf9, 0x2a, 0x69,
+        0x80, 0x23, 0xa4, 0xd4, 0xcd, 0xa5, 0x89, 0xe9, 0x9b, 0x42};
+
+    KUNAI::stream::KunaiStream signature_stream(std::span<const std::uint8_t>{dex_bytes});
+
+    auto signature = verified_dex->get_parser()->get_header_const().compute_signature(&signature_stream);
+
+    assert(
+        memcmp(signature.data(), expected_signature, sizeof(expected_signature)) == 0 &&
+        "dex signature not correct");
+
+    std::vector<std::uint8_t> corrupted(dex_bytes);
+    corrupted.back() ^= 0xff;
+
+    auto corrupted_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::move(corrupted), verify_options);
+
+    if (corrupted_dex->get_parsing_correct() ||
+        corrupted_dex->get_diagnostic().error != KUNAI::DEX::parse_error_e::INCORRECT_INTEGRITY)
+        return -1;
+
+    // a type with a string id out of the table stops the parsing
+    // when the tables are checked
+    std::vector<std::uint8_t> incorrect_table(dex_bytes);
+    auto type_ids_off = dex->get_parser()->get_header_const().get_dex_header_const().type_ids_off;
+    std::memset(incorrect_table.data() + type_ids_off, 0xff, sizeof(std::uint32_t));
+
+    KUNAI::DEX::parser_options_t fail_fast_options;
+    fail_fast_options.fail_fast = true;
+
+    auto incorrect_table_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{incorrect_table}, fail_fast_options);
+
+    if (incorrect_table_dex->get_parsing_correct() ||
+        incorrect_table_dex->get_diagnostic().error != KUNAI::DEX::parse_error_e::INCORRECT_TABLE ||
+        incorrect_table_dex->get_diagnostic().offset != type_ids_off)
+        return -1;
+
+    // also when the file is read from disk with an ifstream
+    auto incorrect_table_path = (std::filesystem::temp_directory_path() / "kunai-test-incorrect-table.dex").string();
+
+    std::ofstream incorrect_table_output(incorrect_table_path, std::ofstream::binary | std::ofstream::trunc);
+    incorrect_table_output.write(reinterpret_cast<const char *>(incorrect_table.data()), incorrect_table.size());
+    incorrect_table_output.close();
+
+    std::ifstream incorrect_table_file(incorrect_table_path, std::ifstream::binary);
+    KUNAI::stream::KunaiStream incorrect_table_stream(incorrect_table_file);
+    KUNAI::DEX::Parser incorrect_table_parser(&incorrect_table_stream, fail_fast_options);
+
+    auto &incorrect_table_diagnostic = incorrect_table_parser.try_parse_file();
+
+    incorrect_table_file.close();
+    std::filesystem::remove(incorrect_table_path);
+
+    if (incorrect_table_diagnostic.error != KUNAI::DEX::parse_error_e::INCORRECT_TABLE ||
+        incorrect_table_diagnostic.offset != type_ids_off)
+        return -1;
+
+    // and a correct file from disk is parsed after the check
+    std::ifstream checked_file(dex_file_path, std::ifstream::binary);
+    KUNAI::stream::KunaiStream checked_stream(checked_file);
+    KUNAI::DEX::Parser checked_file_parser(&checked_stream, fail_fast_options);
+
+    if (!checked_file_parser.try_parse_file().is_correct() ||
+        checked_file_parser.get_tables_validated())
+        return -1;
+
+    check_parser(&checked_file_parser);
+
+    // a string that is not correct MUTF-8 stops the parsing, or it is
+    // reported when accessed if the strings are not validated
+    std::vector<std::uint8_t> incorrect_string(dex_bytes);
+    auto string_data_off = dex->get_parser()->get_strings().get_strings_offsets()[0];
+    // skip the utf16_size and use a stray continuation byte
+    incorrect_string[string_data_off + 1] = 0x80;
+
+    auto incorrect_string_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{incorrect_string});
+
+    if (incorrect_string_dex->get_parsing_correct() ||
+        incorrect_string_dex->get_diagnostic().error != KUNAI::DEX::parse_error_e::INCORRECT_STRING ||
+        incorrect_string_dex->get_diagnostic().offset != string_data_off)
+        return -1;
+
+    KUNAI::DEX::parser_options_t unvalidated_options;
+    unvalidated_options.validate_strings = false;
+    unvalidated_options.parse_level = KUNAI::DEX::parse_level_e::STRINGS;
+
+    incorrect_string_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{incorrect_string}, unvalidated_options);
+
+    if (!incorrect_string_dex->get_parsing_correct() ||
+        incorrect_string_dex->get_parser()->get_strings().try_get_string_by_id(0) != nullptr)
+        return -1;
+
+    // a table bigger than the file is not allocated
+    std::vector<std::uint8_t> huge_table(dex_bytes);
+    std::memset(huge_table.data() + 0x38, 0xff, sizeof(std::uint32_t));
+
+    auto huge_table_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::move(huge_table));
+
+    if (huge_table_dex->get_parsing_correct() ||
+        huge_table_dex->get_diagnostic().error != KUNAI::DEX::parse_error_e::INCORRECT_TABLE)
+        return -1;
+
+    // limits of the resources
+    KUNAI::DEX::parser_options_t limited_options;
+    limited_options.limits.max_allocation = 1;
+
+    auto limited_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{dex_bytes}, limited_options);
+
+    if (limited_dex->get_parsing_correct() ||
+        limited_dex->get_diagnostic().error != KUNAI::DEX::parse_error_e::LIMIT_EXCEEDED)
+        return -1;
+
+    limited_options.limits = {};
+    limited_options.limits.max_instructions = 1;
+
+    limited_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::span<const std::uint8_t>{dex_bytes}, limited_options);
+
+    if (!limited_dex->get_parsing_correct())
+        return -1;
+
+    // the methods are kept without their code
+    for (auto method : limited_dex->get_parser()->get_classes().get_classdefs()[0]->get_class_data_item().get_methods())
+        assert(
+            method->get_code_item().get_bytecode().empty() &&
+            "code item over the limit not correct");
+
+    // lookups without exceptions
+    auto parser = dex->get_parser();
+
+    assert(
+        parser->get_strings().try_get_string_by_id(0) == &parser->get_strings().get_string_by_id(0) &&
+        parser->get_strings().try_get_string_by_id(41) == nullptr &&
+        parser->get_types().try_get_type_from_order(0) != nullptr &&
+        parser->get_types().try_get_type_from_order(0xffff) == nullptr &&
+        parser->get_methods().try_get_method(0xffff) == nullptr &&
+        "lookups without exceptions not correct");
+
+    // owning buffer
+    auto owned_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::move(dex_bytes));
+
+    if (!owned_dex->get_parsing_correct())
+        return -1;
+
+    check_parser(owned_dex->get_parser());
+
+    // a truncated dex must not be parsed
+    std::vector<std::uint8_t> truncated(32, 0);
+
+    auto truncated_dex = KUNAI::DEX::Dex::parse_dex_buffer(std::move(truncated));
+
+    if (truncated_dex->get_parsing_correct() ||
+        truncated_dex->get_diagnostic().error != KUNAI::DEX::parse_error_e::INCORRECT_SIZE)
+        return -1;
+
+    return 0;
+}
@@ -116,6 +116,90 @@ void check_header_struct(const KUNAI::DEX::Header::dexheader_t &header_struct)
     );
 }
 
+void check_lazy_parsing(std::string &dex_file_path)
+{
+    KUNAI::DEX::parser_options_t options;
+    options.lazy_classes = true;
+
+    auto dex = KUNAI::DEX::Dex::parse_dex_file(dex_file_path, options);
+
+    assert(
+        dex->get_parsing_correct() &&
+        "dex lazy parsing not correct");
+
+    auto &classes = dex->get_parser()->get_classes();
+
+    auto class_def = classes.get_classdef_by_name("LMain;");
+
+    assert(
+        class_def != nullptr &&
+        "class LMain; not found");
+
+    assert(
+        classes.get_classdef_by_name("LNotFound;") == nullptr &&
+        "unexpected class found");
+
+    // the class data is parsed here
+    auto &methods = class_def->get_class_data_item().get_methods();
+
+    assert(
+        methods.size() > 0 &&
+        "class LMain; does not contain methods");
+
+    for (auto method : methods)
+        assert(
+            method->getMethodID()->get_encoded_method() == method &&
+            "method id does not point to its encoded method");
+}
+
+void check_interned_types(KUNAI::DEX::Parser *parser)
+{
+    auto &types = parser->get_types();
+
+    auto string_type = types.get_type_by_name("Ljava/lang/String;");
+
+    assert(
+        string_type != nullptr &&
+        "type Ljava/lang/String; not found");
+
+    auto array_type = reinterpret_cast<KUNAI::DEX::DVMArray *>(types.get_type_by_name("[Ljava/lang/String;"));
+
+    assert(
+        array_type != nullptr &&
+        "type [Ljava/lang/String; not found");
+
+    assert(
+        array_type->get_array_type() == string_type &&
+        "array does not point to the interned type");
+
+    assert(
+        types.get_type_by_name("I") == KUNAI::DEX::DVMFundamental::get_fundamental(KUNAI::DEX::DVMFundamental::INT) &&
+        "fundamental type is not shared");
+}
+
+void check_annotation_index(KUNAI::DEX::Parser *parser)
+{
+    auto &classes = parser->get_classes();
+
+    auto annotated_methods = classes.get_annotated_methods("Ldalvik/annotation/Throws;");
+
+    assert(
+        annotated_methods.size() == 1 &&
+        annotated_methods[0] == parser->get_methods().get_method(2) &&
+        "annotated methods not correct");
+
+    assert(
+        classes.get_annotated_classes("Ldalvik/annotation/Throws;").empty() &&
+        classes.get_annotated_methods("Landroid/webkit/JavascriptInterface;").empty() &&
+        "annotated items not correct");
+
+    auto &annotation_directory = classes.get_classdefs()[0]->get_annotation_directory();
+
+    assert(
+        annotation_directory.get_method_annotation_by_id(2)->get_method_idx() == 2 &&
+        "method annotation not correct");
+}
+
 int main()
 {
     std::string dex_file_path = std::string(KUNAI_TEST_FOLDER) + "/test-assignment-arith-logic/Main.dex";
@@ -137,5 +221,11 @@ int main()
 
     check_header_struct(header_struct);
 
+    check_interned_types(parser);
+
+    check_annotation_index(parser);
+
+    check_lazy_parsing(dex_file_path);
+
     return 0;
 }
\ No newline at end of file
@@ -7,7 +7,10 @@
 #include "test-xrefs.inc"
 #include "Kunai/DEX/dex.hpp"
 #include "Kunai/Utils/logger.hpp"
+#include <algorithm>
 #include <assert.h>
+#include <filesystem>
+#include <fstream>
 
 std::vector<std::tuple<std::string, std::string, uint64_t>>
     expected_classes = {
@@ -138,5 +141,120 @@ int main()
             break;
     }
 
+    // the xrefs are written in a snapshot by the first analysis
+    // and loaded by the second one
+    auto snapshot_directory = std::filesystem::temp_directory_path() / "kunai-test-xrefs";
+    std::filesystem::remove_all(snapshot_directory);
+    std::filesystem::create_directories(snapshot_directory);
+
+    auto saved_dex = KUNAI::DEX::Dex::parse_dex_file(dex_file_path);
+    auto saved_analysis = saved_dex->get_analysis(true, snapshot_directory.string());
+
+    auto loaded_dex = KUNAI::DEX::Dex::parse_dex_file(dex_file_path);
+    auto loaded_analysis = loaded_dex->get_analysis(true, snapshot_directory.string());
+
+    auto &saved_xrefs = saved_analysis->get_xrefs(saved_dex->get_parser());
+    auto &loaded_xrefs = loaded_analysis->get_xrefs(loaded_dex->get_parser());
+
+    assert(!saved_xrefs.empty() && saved_xrefs.size() == loaded_xrefs.size() && "Snapshot xrefs mismatch");
+
+    for (auto &name_method : loaded_analysis->get_methods())
+    {
+        auto saved_method = saved_analysis->get_methods().at(name_method.first).get();
+
+        assert(name_method.second->get_xrefto().size() == saved_method->get_xrefto().size() &&
+               name_method.second->get_xreffrom().size() == saved_method->get_xreffrom().size() &&
+               "Snapshot method xrefs mismatch");
+    }
+
+    // a snapshot with an xref to a type that is not a class
+    // is rejected, and the xrefs are created again
+    std::string snapshot_path = std::filesystem::directory_iterator(snapshot_directory)->path().string();
+    auto linear_sweep = KUNAI::DEX::DexDisassembler::disassembly_algorithm::LINEAR_SWEEP_ALGORITHM;
+    auto recursive_traversal = KUNAI::DEX::DexDisassembler::disassembly_algorithm::RECURSIVE_TRAVERSAL_ALGORITHM;
+    KUNAI::DEX::Snapshot::snapshot_header_t snapshot_header;
+
+    std::ifstream snapshot_file(snapshot_path, std::ifstream::binary);
+    snapshot_file.read(reinterpret_cast<char *>(&snapshot_header), sizeof(snapshot_header));
+    snapshot_file.close();
+
+    auto &types = saved_dex->get_parser()->get_types();
+    std::uint32_t no_class = 0;
+
+    while (types.get_type_from_order(no_class)->get_type() == KUNAI::DEX::DVMType::CLASS)
+        no_class++;
+
+    std::vector<KUNAI::DEX::xref_record_t> incorrect_xrefs(saved_xrefs);
+    incorrect_xrefs.push_back({0, 0, no_class, KUNAI::DEX::TYPES::opcodes::OP_NEW_INSTANCE});
+
+    KUNAI::DEX::Snapshot::save_xrefs(snapshot_path, snapshot_header.dex_digest, linear_sweep, incorrect_xrefs);
+
+    auto rejected_dex = KUNAI::DEX::Dex::parse_dex_file(dex_file_path);
+    auto rejected_analysis = rejected_dex->get_analysis(true, snapshot_directory.string());
+
+    assert(rejected_analysis->get_xrefs(rejected_dex->get_parser()).size() == saved_xrefs.size() &&
+           "Incorrect snapshot not rejected");
+
+    // the rejected snapshot is written again
+    std::vector<KUNAI::DEX::xref_record_t> rewritten_xrefs;
+
+    assert(KUNAI::DEX::Snapshot::load_xrefs(snapshot_path, snapshot_header.dex_digest, linear_sweep, rewritten_xrefs) &&
+           rewritten_xrefs.size() == saved_xrefs.size() && "Incorrect snapshot not written again");
+
+    // a snapshot without xrefs is correct
+    KUNAI::DEX::Snapshot::save_xrefs(snapshot_path, snapshot_header.dex_digest, linear_sweep, {});
+
+    auto empty_dex = KUNAI::DEX::Dex::parse_dex_file(dex_file_path);
+    auto empty_analysis = empty_dex->get_analysis(true, snapshot_directory.string());
+
+    assert(empty_analysis->get_xrefs(empty_dex->get_parser()).empty() &&
+           empty_dex->get_dex_disassembler()->get_dex_instructions().empty() &&
+           "Snapshot without xrefs not loaded");
+
+    // with the recursive traversal only the instructions reached by the
+    // disassembler give xrefs, remove the call to nextInt at offset 14
+    // from the instructions of main as if it was not reachable. The
+    // snapshot of the linear sweep must not be used for it
+    KUNAI::DEX::Snapshot::save_xrefs(snapshot_path, snapshot_header.dex_digest, linear_sweep, saved_xrefs);
+
+    assert(!KUNAI::DEX::Snapshot::load_xrefs(snapshot_path, snapshot_header.dex_digest, recursive_traversal, rewritten_xrefs) &&
+           "Snapshot loaded with other algorithm");
+    auto recursive_dex = KUNAI::DEX::Dex::parse_dex_file(dex_file_path);
+    auto recursive_disassembler = recursive_dex->get_dex_disassembler();
+    KUNAI::DEX::EncodedMethod *main_method = nullptr;
+
+    recursive_disassembler->set_disassembly_algorithm(recursive_traversal);
+
+    for (auto method : recursive_dex->get_parser()->get_classes().get_classdefs()[0]->get_class_data_item().get_methods())
+        if (method->getMethodID()->get_name() == "main")
+            main_method = method;
+
+    auto removed = std::erase_if(recursive_disassembler->disassemble_method(main_method),
+                                 [](const auto &instr)
+                                 { return instr->get_address() == 14; });
+
+    assert(removed == 1 && "Instruction of main not found");
+
+    auto recursive_analysis = recursive_dex->get_analysis(true, snapshot_directory.string());
+
+    auto &recursive_xrefs = recursive_analysis->get_xrefs(recursive_dex->get_parser());
+    auto &recursive_main = recursive_analysis->get_methods().at("void Main->main(java.lang.String[])");
+
+    assert(recursive_xrefs.size() == saved_xrefs.size() - 1 &&
+           std::none_of(recursive_main->get_xrefto().begin(), recursive_main->get_xrefto().end(),
+                        [](const auto &xref_to)
+                        { return std::get<2>(xref_to) == 14; }) &&
+           "Unreachable instruction with xrefs");
+
+    // each algorithm has its own snapshot
+    auto recursive_path = KUNAI::DEX::Snapshot::get_snapshot_path(snapshot_directory.string(),
+                                                                  snapshot_header.dex_digest, recursive_traversal);
+
+    assert(recursive_path != snapshot_path &&
+           KUNAI::DEX::Snapshot::load_xrefs(recursive_path, snapshot_header.dex_digest, recursive_traversal, rewritten_xrefs) &&
+           rewritten_xrefs.size() == recursive_xrefs.size() && "Snapshot of the recursive traversal not written");
+
+    std::filesystem::remove_all(snapshot_directory);
+
     return 0;
 }
\ No newline at end of file